@@ -0,0 +1,213 @@
+/*
+ * bench_parse.c - Throughput of the "show" output parsers
+ *
+ * For each scale, test/vpp_mock records the show outputs of a generated
+ * configuration and the parsers of vpp_interface.c and vpp_api.c run
+ * over them through the replay transport. mb_per_sec is the size of the
+ * outputs an iteration parses over its time.
+ *
+ * scan_lines_<isa> and scan_fields_<isa> walk the recorded outputs with
+ * each vpp_tok scanner the CPU runs, lines only and lines plus columns;
+ * parse_show_hardware_<isa> is the widest parser under each.
+ *
+ * Usage: bench_parse [-t min-ms] [-n min-iterations] [scale...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/vpp_api.h"
+#include "../src/vpp_interface.h"
+#include "../src/vpp_tok.h"
+#include "bench_replay.h"
+#include "bench_util.h"
+
+typedef struct {
+  unsigned scale;
+  vpp_if_table_t table;
+} parse_ctx_t;
+
+/* "show interface" */
+static long bench_show_interface(void *arg) {
+  parse_ctx_t *c = arg;
+
+  if (vpp_interface_dump_brief(&c->table) != 0 || c->table.count == 0)
+    return -1;
+  return (long)bench_replay_size("show interface");
+}
+
+/* "show interface" plus "show hardware-interfaces" */
+static long bench_interface_dump(void *arg) {
+  parse_ctx_t *c = arg;
+
+  if (vpp_interface_dump(&c->table) != 0 || c->table.count == 0)
+    return -1;
+  return (long)(bench_replay_size("show interface") +
+                bench_replay_size("show hardware-interfaces"));
+}
+
+/* "show interface" plus "show bond details" members */
+static long bench_snapshot(void *arg) {
+  (void)arg;
+
+  vpp_interface_snapshot_invalidate();
+  if (!vpp_interface_snapshot())
+    return -1;
+  return (long)(bench_replay_size("show interface") +
+                bench_replay_size("show bond details"));
+}
+
+static long bench_api_interfaces(void *arg) {
+  vpp_api_set_t *set = vpp_api_get_interfaces();
+  size_t n = set ? set->count : 0;
+
+  (void)arg;
+  vpp_api_set_free(set);
+  return n > 0 ? (long)bench_replay_size("show interface") : -1;
+}
+
+static long bench_api_bonds(void *arg) {
+  vpp_api_set_t *set = vpp_api_get_bonds();
+  size_t n = set ? set->count : 0;
+
+  (void)arg;
+  vpp_api_set_free(set);
+  return n > 0 ? (long)bench_replay_size("show bond details") : -1;
+}
+
+static long bench_api_lcps(void *arg) {
+  vpp_api_set_t *set = vpp_api_get_lcps();
+  size_t n = set ? set->count : 0;
+
+  (void)arg;
+  vpp_api_set_free(set);
+  return n > 0 ? (long)bench_replay_size("show lcp") : -1;
+}
+
+static const char *scan_cmds[] = {"show interface", "show interface addr",
+                                  "show hardware-interfaces"};
+
+#define SCAN_CMDS (sizeof(scan_cmds) / sizeof(scan_cmds[0]))
+
+static long scan_outputs(bool fields) {
+  size_t nfields = 0;
+  long bytes = 0;
+
+  for (size_t i = 0; i < SCAN_CMDS; i++) {
+    const char *text = bench_replay_text(scan_cmds[i]);
+    vpp_slice_t line, f;
+    vpp_tok_t tok;
+
+    vpp_tok_init(&tok, text, bench_replay_size(scan_cmds[i]));
+    while (vpp_tok_line(&tok, &line)) {
+      nfields++;
+      while (fields && vpp_tok_field(&line, &f))
+        nfields++;
+    }
+    bytes += (long)bench_replay_size(scan_cmds[i]);
+  }
+  return nfields > 0 ? bytes : -1;
+}
+
+static long bench_scan_lines(void *arg) {
+  (void)arg;
+  return scan_outputs(false);
+}
+
+static long bench_scan_fields(void *arg) {
+  (void)arg;
+  return scan_outputs(true);
+}
+
+/* "show hardware-interfaces" alone, through interface_dump's parser */
+static long bench_show_hardware(void *arg) {
+  parse_ctx_t *c = arg;
+  long n = bench_interface_dump(c);
+
+  return n < 0 ? -1 : (long)bench_replay_size("show hardware-interfaces");
+}
+
+static const struct {
+  const char *name;
+  bench_fn_t fn;
+} isa_benches[] = {
+    {"scan_lines", bench_scan_lines},
+    {"scan_fields", bench_scan_fields},
+    {"parse_show_hardware", bench_show_hardware},
+};
+
+static const struct {
+  const char *name;
+  bench_fn_t fn;
+} benches[] = {
+    {"parse_show_interface", bench_show_interface},
+    {"interface_dump", bench_interface_dump},
+    {"interface_snapshot", bench_snapshot},
+    {"api_get_interfaces", bench_api_interfaces},
+    {"api_get_bonds", bench_api_bonds},
+    {"api_get_lcps", bench_api_lcps},
+};
+
+static void remove_recording(const char *dir) {
+  static const char *files[] = {"show_interface",    "show_interface_addr",
+                                "show_hardware-interfaces", "show_bond",
+                                "show_bond_details", "show_lcp"};
+  char path[512];
+
+  for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+    snprintf(path, sizeof(path), "%s/%s", dir, files[i]);
+    unlink(path);
+  }
+  rmdir(dir);
+}
+
+static const char *isas[] = {"scalar", "sse2", "avx2"};
+
+static int bench_scale_run(unsigned scale) {
+  char dir[] = "/tmp/bench-parse.XXXXXX";
+  parse_ctx_t c = {.scale = scale};
+  int ret = 0;
+
+  if (!mkdtemp(dir))
+    return -1;
+  if (bench_mock_record(dir, scale) < 0 || bench_replay_load(dir) < 0) {
+    remove_recording(dir);
+    return -1;
+  }
+  remove_recording(dir);
+
+  for (size_t i = 0; ret == 0 && i < sizeof(benches) / sizeof(benches[0]); i++)
+    ret = bench_run(benches[i].name, scale, NULL, benches[i].fn, &c);
+
+  for (size_t k = 0; ret == 0 && k < sizeof(isas) / sizeof(isas[0]); k++) {
+    if (vpp_tok_select(isas[k]) < 0)
+      continue; /* Not on this CPU */
+    for (size_t i = 0;
+         ret == 0 && i < sizeof(isa_benches) / sizeof(isa_benches[0]); i++) {
+      char name[64];
+
+      snprintf(name, sizeof(name), "%s_%s", isa_benches[i].name, isas[k]);
+      ret = bench_run(name, scale, NULL, isa_benches[i].fn, &c);
+    }
+  }
+  vpp_tok_select(NULL);
+
+  vpp_if_table_free(&c.table);
+  bench_replay_free();
+  return ret;
+}
+
+int main(int argc, char **argv) {
+  unsigned scales[BENCH_SCALES_MAX];
+  size_t nscales;
+  int ret = 0;
+
+  if (bench_args(argc, argv, scales, &nscales) < 0)
+    return 2;
+  for (size_t i = 0; i < nscales; i++)
+    if (bench_scale_run(scales[i]) < 0)
+      ret = 1;
+  return ret;
+}
@@ -0,0 +1,318 @@
+/*
+ * bench_plugin.c - Backend plugin benchmarks against test/vpp_mock
+ *
+ * Links the backend plugin objects and drives them through their Clixon
+ * callbacks, the way the backend does, over the real CLI socket
+ * transport to a mock VPP of each scale:
+ *
+ *   restore          - vpp_plugin_start() replaying a generated
+ *                      vpp_config.xml into a VPP with ports only
+ *   statedata        - vpp_statedata() for /interfaces
+ *   trans_commit_N   - begin/validate/commit/end of a transaction that
+ *                      changes the MTU of N sub-interfaces, including
+ *                      the rewrite of the startup exec script
+ *
+ * Usage: bench_plugin [-t min-ms] [-n min-iterations] [scale...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include <cligen/cligen.h>
+#include <clixon/clixon.h>
+#include <clixon/clixon_backend.h>
+
+#include "../src/vpp_connection.h"
+#include "../src/vpp_interface.h"
+#include "bench_util.h"
+
+clixon_plugin_api *clixon_plugin_init(clixon_handle h);
+
+typedef struct {
+  clixon_handle h;
+  clixon_plugin_api *api;
+  unsigned scale;
+  pid_t mock;
+  char sock[64];
+  char config[64];
+  char script[64];
+  long config_size;
+  /* Commit: xml[i] has every changed MTU at mtu_val[i] */
+  transaction_data_t *td;
+  cxobj *xml[2];
+  cxobj **mtu[2];
+  size_t nchanges;
+  uint64_t iter;
+} plugin_ctx_t;
+
+static int mock_restart(plugin_ctx_t *c, bool populated) {
+  vpp_disconnect();
+  bench_mock_stop(c->mock);
+  c->mock = bench_mock_start(c->sock, c->scale, populated, NULL);
+  return c->mock < 0 ? -1 : 0;
+}
+
+/* Present interfaces of the mock whose name has (or lacks) a '.' */
+static size_t list_interfaces(vpp_if_table_t *t, bool subifs, char ***names) {
+  size_t n = 0;
+
+  *names = NULL;
+  if ((!vpp_is_connected() && vpp_connect() != 0) ||
+      vpp_interface_dump_brief(t) != 0 ||
+      !(*names = calloc(t->count, sizeof(**names))))
+    return 0;
+  for (uint32_t i = 0; i < t->max; i++) {
+    const char *name = t->cold[i].name;
+    if (vpp_if_present(t, i) && strcmp(name, "local0") != 0 &&
+        (strchr(name, '.') != NULL) == subifs)
+      (*names)[n++] = t->cold[i].name;
+  }
+  return n;
+}
+
+/*
+ * vpp_config.xml for the scale, in the layout the CLI plugin saves:
+ * bonds of two ports each, VLANs with an address spread over the bonds,
+ * an LCP pair per bond
+ */
+static int write_config(plugin_ctx_t *c) {
+  vpp_if_table_t t = {0};
+  bench_scale_t s;
+  char **ports;
+  size_t nports = list_interfaces(&t, false, &ports);
+  FILE *fp;
+
+  bench_scale(c->scale, &s);
+  if (nports < 2 * (size_t)s.bonds || !(fp = fopen(c->config, "w"))) {
+    free(ports);
+    vpp_if_table_free(&t);
+    return -1;
+  }
+
+  fprintf(fp, "<config>\n");
+  fprintf(fp, "  <interfaces xmlns=\"http://example.com/vpp/interfaces\">\n");
+  for (unsigned b = 0; b < s.bonds; b++)
+    fprintf(fp,
+            "    <interface>\n"
+            "      <name>BondEthernet%u</name>\n"
+            "      <enabled>true</enabled>\n"
+            "    </interface>\n",
+            b);
+  for (unsigned v = 0; v < s.vlans; v++)
+    fprintf(fp,
+            "    <interface>\n"
+            "      <name>BondEthernet%u.%u</name>\n"
+            "      <enabled>true</enabled>\n"
+            "      <ipv4-address>\n"
+            "        <address>10.%u.%u.1</address>\n"
+            "        <prefix-length>24</prefix-length>\n"
+            "      </ipv4-address>\n"
+            "    </interface>\n",
+            v % s.bonds, 100 + v / s.bonds, (v >> 8) & 0xff, v & 0xff);
+  fprintf(fp, "  </interfaces>\n");
+
+  fprintf(fp, "  <bonds xmlns=\"http://example.com/vpp/bonding\">\n");
+  for (unsigned b = 0; b < s.bonds; b++)
+    fprintf(fp,
+            "    <bond>\n"
+            "      <name>BondEthernet%u</name>\n"
+            "      <id>%u</id>\n"
+            "      <mode>lacp</mode>\n"
+            "      <load-balance>l34</load-balance>\n"
+            "      <members>%s,%s</members>\n"
+            "    </bond>\n",
+            b, b, ports[2 * b], ports[2 * b + 1]);
+  fprintf(fp, "  </bonds>\n");
+
+  fprintf(fp, "  <lcps xmlns=\"http://example.com/vpp/lcp\">\n");
+  for (unsigned b = 0; b < s.bonds; b++)
+    fprintf(fp,
+            "    <lcp>\n"
+            "      <vpp-interface>BondEthernet%u</vpp-interface>\n"
+            "      <host-interface>be%u</host-interface>\n"
+            "      <netns>dataplane</netns>\n"
+            "    </lcp>\n",
+            b, b);
+  fprintf(fp, "  </lcps>\n");
+  fprintf(fp, "</config>\n");
+
+  c->config_size = ftell(fp);
+  free(ports);
+  vpp_if_table_free(&t);
+  return fclose(fp) == 0 ? 0 : -1;
+}
+
+static long bench_restore_setup(void *arg) {
+  return mock_restart(arg, false);
+}
+
+static long bench_restore(void *arg) {
+  plugin_ctx_t *c = arg;
+
+  if (c->api->ca_start(c->h) < 0 || !vpp_is_connected())
+    return -1;
+  return c->config_size;
+}
+
+static long bench_statedata(void *arg) {
+  plugin_ctx_t *c = arg;
+  cxobj *xs = xml_new("data", NULL, CX_ELMNT);
+  int rv;
+
+  if (!xs)
+    return -1;
+  rv = c->api->ca_statedata(c->h, NULL, "/interfaces", xs);
+  xml_free(xs);
+  return rv < 0 ? -1 : 0;
+}
+
+static void commit_free(plugin_ctx_t *c) {
+  for (int i = 0; i < 2; i++) {
+    if (c->xml[i])
+      xml_free(c->xml[i]);
+    free(c->mtu[i]);
+    c->xml[i] = NULL;
+    c->mtu[i] = NULL;
+  }
+}
+
+/* Two configurations of n sub-interfaces that differ in every MTU */
+static int commit_prepare(plugin_ctx_t *c, size_t n) {
+  static const unsigned mtu_val[2] = {9000, 1500};
+  vpp_if_table_t t = {0};
+  char **subifs;
+  size_t nsubifs = list_interfaces(&t, true, &subifs);
+  int ret = -1;
+
+  commit_free(c);
+  c->nchanges = n;
+  if (nsubifs < n)
+    goto done;
+
+  for (int i = 0; i < 2; i++) {
+    cbuf *cb = cbuf_new();
+    cxobj *xif;
+    size_t k = 0;
+
+    cprintf(cb, "<interfaces>");
+    for (size_t j = 0; j < n; j++)
+      cprintf(cb, "<interface><name>%s</name><mtu>%u</mtu></interface>",
+              subifs[j], mtu_val[i]);
+    cprintf(cb, "</interfaces>");
+    if (clixon_xml_parse_string(cbuf_get(cb), YB_NONE, NULL, &c->xml[i],
+                                NULL) < 0) {
+      cbuf_free(cb);
+      goto done;
+    }
+    cbuf_free(cb);
+
+    c->mtu[i] = calloc(n, sizeof(*c->mtu[i]));
+    if (!c->mtu[i])
+      goto done;
+    xif = NULL;
+    while ((xif = xml_child_each(xpath_first(c->xml[i], NULL, "interfaces"),
+                                 xif, CX_ELMNT)) != NULL && k < n)
+      c->mtu[i][k++] = xpath_first(xif, NULL, "mtu");
+    if (k != n)
+      goto done;
+  }
+  ret = 0;
+
+done:
+  free(subifs);
+  vpp_if_table_free(&t);
+  return ret;
+}
+
+/* Move between the two configurations, one full transaction */
+static long bench_commit(void *arg) {
+  plugin_ctx_t *c = arg;
+  clixon_plugin_api *api = c->api;
+  transaction_data_t *td = c->td;
+  int from = (int)(c->iter++ & 1);
+  int rv;
+
+  td->td_id++;
+  td->td_src = c->xml[from];
+  td->td_target = c->xml[!from];
+  td->td_scvec = c->mtu[from];
+  td->td_tcvec = c->mtu[!from];
+  td->td_clen = (int)c->nchanges;
+  td->td_arg = NULL;
+
+  rv = api->ca_trans_begin(c->h, td);
+  if (rv >= 0)
+    rv = api->ca_trans_validate(c->h, td);
+  if (rv >= 0)
+    rv = api->ca_trans_commit(c->h, td);
+  api->ca_trans_end(c->h, td);
+  return rv < 0 ? -1 : 0;
+}
+
+static int bench_scale_run(plugin_ctx_t *c, unsigned scale) {
+  static const size_t changes[] = {1, 10, 100, 1000};
+  char name[32];
+  int ret = 0;
+
+  c->scale = scale;
+  c->mock = 0;
+  snprintf(c->sock, sizeof(c->sock), "/tmp/bench-plugin.%d.sock", getpid());
+  snprintf(c->config, sizeof(c->config), "/tmp/bench-plugin.%d.xml",
+           getpid());
+  snprintf(c->script, sizeof(c->script), "/tmp/bench-plugin.%d.exec",
+           getpid());
+  setenv("VPP_CLI_SOCK", c->sock, 1);
+  setenv("VPP_CONFIG_FILE", c->config, 1);
+  setenv("VPP_STARTUP_SCRIPT", c->script, 1);
+
+  if (mock_restart(c, false) < 0 || write_config(c) < 0 ||
+      bench_run("restore", scale, bench_restore_setup, bench_restore, c) < 0)
+    ret = -1;
+
+  if (ret == 0 && (mock_restart(c, true) < 0 ||
+                   bench_run("statedata", scale, NULL, bench_statedata, c) < 0))
+    ret = -1;
+
+  for (size_t i = 0; ret == 0 && i < sizeof(changes) / sizeof(changes[0]);
+       i++) {
+    if (commit_prepare(c, changes[i]) < 0)
+      break; /* Fewer sub-interfaces at this scale */
+    snprintf(name, sizeof(name), "trans_commit_%zu", changes[i]);
+    ret = bench_run(name, scale, NULL, bench_commit, c);
+  }
+
+  commit_free(c);
+  vpp_disconnect();
+  bench_mock_stop(c->mock);
+  unlink(c->config);
+  unlink(c->script);
+  return ret;
+}
+
+int main(int argc, char **argv) {
+  plugin_ctx_t c = {0};
+  unsigned scales[BENCH_SCALES_MAX];
+  size_t nscales;
+  int ret = 0;
+
+  if (bench_args(argc, argv, scales, &nscales) < 0)
+    return 2;
+
+  c.h = clixon_handle_init();
+  /* The restore logs every command; only the mask of syslog filters */
+  clixon_log_init(c.h, "bench_plugin", LOG_WARNING, CLIXON_LOG_SYSLOG);
+  c.api = clixon_plugin_init(c.h);
+  c.td = transaction_new();
+  if (!c.api || !c.td)
+    return 1;
+
+  for (size_t i = 0; i < nscales; i++)
+    if (bench_scale_run(&c, scales[i]) < 0)
+      ret = 1;
+
+  c.api->ca_exit(c.h);
+  return ret;
+}
@@ -0,0 +1,154 @@
+/*
+ * bench_replay.c - Replay transport for the parser benchmarks
+ *
+ * Implements vpp_connection.h over recorded outputs. Commands without a
+ * recording (the create/set/delete family) succeed with an empty reply.
+ * The copy vpp_cli_exec() hands out is part of every timing, as the
+ * real transport makes one too.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/vpp_connection.h"
+#include "bench_replay.h"
+
+static const char *replay_cmds[] = {
+    "show interface",        "show interface addr", "show hardware-interfaces",
+    "show bond",             "show bond details",   "show lcp",
+};
+
+#define REPLAY_CMDS (sizeof(replay_cmds) / sizeof(replay_cmds[0]))
+
+static char *replay_text[REPLAY_CMDS];
+static size_t replay_len[REPLAY_CMDS];
+
+static int replay_find(const char *cmd) {
+  for (size_t i = 0; i < REPLAY_CMDS; i++)
+    if (strcmp(cmd, replay_cmds[i]) == 0)
+      return (int)i;
+  return -1;
+}
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *fp = fopen(path, "r");
+  char *buf = NULL;
+  long size;
+
+  if (!fp)
+    return NULL;
+  if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) >= 0 &&
+      fseek(fp, 0, SEEK_SET) == 0 && (buf = malloc((size_t)size + 1)) != NULL) {
+    *len = fread(buf, 1, (size_t)size, fp);
+    buf[*len] = '\0';
+  }
+  fclose(fp);
+  return buf;
+}
+
+int bench_replay_load(const char *dir) {
+  bench_replay_free();
+  for (size_t i = 0; i < REPLAY_CMDS; i++) {
+    char path[512];
+    int pos = snprintf(path, sizeof(path), "%s/", dir);
+
+    for (const char *p = replay_cmds[i]; *p && pos < (int)sizeof(path) - 1; p++)
+      path[pos++] = *p == ' ' ? '_' : *p;
+    path[pos] = '\0';
+    if (!(replay_text[i] = read_file(path, &replay_len[i]))) {
+      fprintf(stderr, "[bench] Cannot read %s\n", path);
+      bench_replay_free();
+      return -1;
+    }
+  }
+  return 0;
+}
+
+void bench_replay_free(void) {
+  for (size_t i = 0; i < REPLAY_CMDS; i++) {
+    free(replay_text[i]);
+    replay_text[i] = NULL;
+    replay_len[i] = 0;
+  }
+}
+
+size_t bench_replay_size(const char *cmd) {
+  int i = replay_find(cmd);
+  return i < 0 ? 0 : replay_len[i];
+}
+
+const char *bench_replay_text(const char *cmd) {
+  int i = replay_find(cmd);
+  return i < 0 ? NULL : replay_text[i];
+}
+
+int vpp_connect(void) { return 0; }
+
+void vpp_disconnect(void) {}
+
+bool vpp_is_connected(void) { return true; }
+
+int vpp_reconnect(void) { return 0; }
+
+uint64_t vpp_connection_epoch(void) { return 1; }
+
+char *vpp_cli_exec(const char *cmd) {
+  int i = replay_find(cmd);
+  char *out;
+
+  if (i < 0 || !replay_text[i])
+    return strdup("");
+  out = malloc(replay_len[i] + 1);
+  if (out)
+    memcpy(out, replay_text[i], replay_len[i] + 1);
+  return out;
+}
+
+bool vpp_cli_output_is_error(const char *output) {
+  return output &&
+         (strstr(output, "error") || strstr(output, "Error") ||
+          strstr(output, "unknown input") || strstr(output, "failed"));
+}
+
+int vpp_cli_exec_check(const char *cmd) {
+  char *response = vpp_cli_exec(cmd);
+  int ret = response && !vpp_cli_output_is_error(response) ? 0 : -1;
+
+  free(response);
+  return ret;
+}
+
+int vpp_cli_exec_pipelined(const char *const *cmds, size_t n, char **replies) {
+  for (size_t i = 0; i < n; i++)
+    replies[i] = vpp_cli_exec(cmds[i]);
+  return 0;
+}
+
+unsigned vpp_cli_sessions(void) { return 1; }
+
+int vpp_cli_exec_pipelined_on(unsigned session, const char *const *cmds,
+                              size_t n, char **replies) {
+  (void)session;
+  return vpp_cli_exec_pipelined(cmds, n, replies);
+}
+
+int vpp_cli_exec_batch(const char **cmds, size_t n,
+                       vpp_cli_result_t *results) {
+  int ret = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    results[i].output = vpp_cli_exec(cmds[i]);
+    results[i].rv = vpp_cli_output_is_error(results[i].output) ? -1 : 0;
+    if (results[i].rv != 0)
+      ret = -1;
+  }
+  return ret;
+}
+
+void vpp_cli_results_free(vpp_cli_result_t *results, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    free(results[i].output);
+    results[i].output = NULL;
+  }
+}
@@ -0,0 +1,24 @@
+/*
+ * bench_replay.h - Replay transport for the parser benchmarks
+ *
+ * Link bench_replay.c in place of vpp_connection.c: vpp_cli_exec()
+ * then answers the show commands from outputs recorded with
+ * test/vpp_mock -R, so parsers are timed without a socket in the way.
+ */
+
+#ifndef _BENCH_REPLAY_H_
+#define _BENCH_REPLAY_H_
+
+#include <stddef.h>
+
+/* Load the outputs recorded in dir, replacing any loaded before */
+int bench_replay_load(const char *dir);
+void bench_replay_free(void);
+
+/* Size of the recorded output of cmd, 0 if there is none */
+size_t bench_replay_size(const char *cmd);
+
+/* Recorded output of cmd, NUL-terminated; NULL if there is none */
+const char *bench_replay_text(const char *cmd);
+
+#endif /* _BENCH_REPLAY_H_ */
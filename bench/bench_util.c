@@ -0,0 +1,229 @@
+/*
+ * bench_util.c - Timing, reporting and mock VPP helpers for the benchmarks
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench_util.h"
+
+#define BENCH_MIN_MS 1000
+#define BENCH_MIN_ITERS 3
+#define BENCH_MOCK_WAIT_MS 30000 /* Large configurations take a while */
+
+static uint64_t min_ns = (uint64_t)BENCH_MIN_MS * 1000000;
+static unsigned min_iters = BENCH_MIN_ITERS;
+
+void bench_scale(unsigned interfaces, bench_scale_t *s) {
+  unsigned left;
+
+  s->bonds = interfaces / 156;
+  if (s->bonds < 1)
+    s->bonds = 1;
+  if (s->bonds > 64)
+    s->bonds = 64;
+  s->ports = interfaces / 3;
+  /* local0, then a bond or VLAN and its tap for every pair */
+  left = interfaces > 1 + s->ports + 2 * s->bonds
+             ? interfaces - 1 - s->ports - 2 * s->bonds
+             : 0;
+  s->vlans = left / 2;
+}
+
+uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+int bench_run(const char *name, unsigned scale, bench_fn_t setup,
+              bench_fn_t fn, void *arg) {
+  uint64_t total = 0;
+  uint64_t best = UINT64_MAX;
+  uint64_t bytes = 0;
+  uint64_t iters = 0;
+
+  fprintf(stderr, "[bench] %s/%u\n", name, scale);
+  while (iters < min_iters || total < min_ns) {
+    uint64_t start;
+    uint64_t ns;
+    long n;
+
+    if (setup && setup(arg) < 0) {
+      fprintf(stderr, "[bench] %s/%u: setup failed\n", name, scale);
+      return -1;
+    }
+    start = bench_now_ns();
+    n = fn(arg);
+    ns = bench_now_ns() - start;
+    if (n < 0) {
+      fprintf(stderr, "[bench] %s/%u: iteration %llu failed\n", name, scale,
+              (unsigned long long)iters);
+      return -1;
+    }
+    total += ns;
+    if (ns < best)
+      best = ns;
+    bytes += (uint64_t)n;
+    iters++;
+  }
+
+  printf("{\"bench\":\"%s\",\"scale\":%u,\"iterations\":%llu,"
+         "\"ns_per_op\":%llu,\"min_ns\":%llu,\"mb_per_sec\":%.1f,"
+         "\"gb_per_sec\":%.2f}\n",
+         name, scale, (unsigned long long)iters,
+         (unsigned long long)(total / iters), (unsigned long long)best,
+         total ? (double)bytes * 1000.0 / (double)total : 0.0,
+         total ? (double)bytes / (double)total : 0.0);
+  fflush(stdout);
+  return 0;
+}
+
+int bench_args(int argc, char **argv, unsigned *scales, size_t *nscales) {
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:n:h")) != -1) {
+    switch (opt) {
+    case 't':
+      min_ns = strtoull(optarg, NULL, 10) * 1000000;
+      break;
+    case 'n':
+      min_iters = (unsigned)strtoul(optarg, NULL, 10);
+      if (min_iters < 1)
+        min_iters = 1;
+      break;
+    default:
+      fprintf(stderr, "Usage: %s [-t min-ms] [-n min-iterations] [scale...]\n",
+              argv[0]);
+      return -1;
+    }
+  }
+
+  *nscales = 0;
+  for (int i = optind; i < argc && *nscales < BENCH_SCALES_MAX; i++)
+    scales[(*nscales)++] = (unsigned)strtoul(argv[i], NULL, 10);
+  if (*nscales == 0) {
+    scales[0] = 100;
+    scales[1] = 1000;
+    scales[2] = 10000;
+    *nscales = 3;
+  }
+  return 0;
+}
+
+static const char *mock_path(void) {
+  const char *path = getenv("VPP_MOCK");
+  return (path && *path) ? path : BENCH_MOCK;
+}
+
+/* Fork the mock with the scale's configuration plus extra arguments */
+static pid_t mock_spawn(unsigned scale, bool populated, const char *opt,
+                        const char *optval, const char *log) {
+  bench_scale_t s;
+  char ports[16], bonds[16], vlans[16];
+  char *argv[16];
+  int argc = 0;
+  pid_t pid;
+
+  bench_scale(scale, &s);
+  snprintf(ports, sizeof(ports), "%u", s.ports);
+  snprintf(bonds, sizeof(bonds), "%u", s.bonds);
+  snprintf(vlans, sizeof(vlans), "%u", s.vlans);
+
+  argv[argc++] = (char *)mock_path();
+  argv[argc++] = (char *)opt;
+  argv[argc++] = (char *)optval;
+  argv[argc++] = "-p";
+  argv[argc++] = ports;
+  if (populated) {
+    argv[argc++] = "-b";
+    argv[argc++] = bonds;
+    argv[argc++] = "-v";
+    argv[argc++] = vlans;
+    argv[argc++] = "-a";
+    argv[argc++] = "-c";
+  }
+  if (log) {
+    argv[argc++] = "-L";
+    argv[argc++] = (char *)log;
+  }
+  argv[argc] = NULL;
+
+  pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "[bench] fork: %s\n", strerror(errno));
+    return -1;
+  }
+  if (pid == 0) {
+    int null = open("/dev/null", O_WRONLY);
+    if (null >= 0)
+      dup2(null, STDERR_FILENO);
+    execv(mock_path(), argv);
+    _exit(127);
+  }
+  return pid;
+}
+
+pid_t bench_mock_start(const char *sock, unsigned scale, bool populated,
+                       const char *log) {
+  struct sockaddr_un addr;
+  uint64_t deadline = bench_now_ns() + (uint64_t)BENCH_MOCK_WAIT_MS * 1000000;
+  pid_t pid;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", sock);
+  unlink(sock);
+
+  pid = mock_spawn(scale, populated, "-s", sock, log);
+  if (pid < 0)
+    return -1;
+
+  /* Ready once it accepts connections */
+  while (bench_now_ns() < deadline) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int rv = fd >= 0 ? connect(fd, (struct sockaddr *)&addr, sizeof(addr)) : -1;
+
+    if (fd >= 0)
+      close(fd);
+    if (rv == 0)
+      return pid;
+    if (waitpid(pid, NULL, WNOHANG) == pid) {
+      fprintf(stderr, "[bench] %s exited, run 'make mock'\n", mock_path());
+      return -1;
+    }
+    usleep(10000);
+  }
+  fprintf(stderr, "[bench] %s not ready on %s\n", mock_path(), sock);
+  bench_mock_stop(pid);
+  return -1;
+}
+
+void bench_mock_stop(pid_t pid) {
+  if (pid <= 0)
+    return;
+  kill(pid, SIGTERM);
+  waitpid(pid, NULL, 0);
+}
+
+int bench_mock_record(const char *dir, unsigned scale) {
+  int status;
+  pid_t pid = mock_spawn(scale, true, "-R", dir, NULL);
+
+  if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+      WEXITSTATUS(status) != 0) {
+    fprintf(stderr, "[bench] %s -R %s failed, run 'make mock'\n", mock_path(),
+            dir);
+    return -1;
+  }
+  return 0;
+}
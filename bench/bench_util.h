@@ -0,0 +1,64 @@
+/*
+ * bench_util.h - Timing, reporting and mock VPP helpers for the benchmarks
+ *
+ * Each result is one JSON object per line on stdout, so runs of two
+ * builds can be diffed or loaded into a spreadsheet as they are:
+ *   {"bench":"parse_show_interface","scale":10000,"iterations":412,
+ *    "ns_per_op":1213350,"min_ns":1190221,"mb_per_sec":612.5,
+ *    "gb_per_sec":0.61}
+ * Progress and failures go to stderr.
+ *
+ * The scale of a run is its total interface count. Configurations come
+ * from test/vpp_mock (VPP_MOCK to override), so runs are reproducible
+ * without VPP.
+ */
+
+#ifndef _BENCH_UTIL_H_
+#define _BENCH_UTIL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define BENCH_SCALES_MAX 8
+#define BENCH_MOCK "test/vpp_mock" /* Override with VPP_MOCK */
+
+/* How a scale splits into ports, bonds and VLANs; bonds and VLANs get
+ * an LCP pair (a tap interface) each */
+typedef struct {
+  unsigned ports;
+  unsigned bonds;
+  unsigned vlans;
+} bench_scale_t;
+
+void bench_scale(unsigned interfaces, bench_scale_t *s);
+
+uint64_t bench_now_ns(void);
+
+/* One iteration: returns the bytes it processed, -1 on failure */
+typedef long (*bench_fn_t)(void *arg);
+
+/*
+ * Run fn until both the minimum time and iteration count are reached
+ * and print its result line. setup, if set, runs untimed before each
+ * iteration. Returns 0, -1 if an iteration failed.
+ */
+int bench_run(const char *name, unsigned scale, bench_fn_t setup,
+              bench_fn_t fn, void *arg);
+
+/* -t MS (minimum time per benchmark), -n N (minimum iterations) and
+ * scales as arguments, 100 1000 10000 by default */
+int bench_args(int argc, char **argv, unsigned *scales, size_t *nscales);
+
+/* Serve the configuration of scale on sock: ports only, or with bonds,
+ * VLANs, addresses and LCP pairs; log, if set, gets every command the
+ * mock runs. Returns the mock's pid, -1 on error */
+pid_t bench_mock_start(const char *sock, unsigned scale, bool populated,
+                       const char *log);
+void bench_mock_stop(pid_t pid);
+
+/* Record the show outputs of scale into dir */
+int bench_mock_record(const char *dir, unsigned scale);
+
+#endif /* _BENCH_UTIL_H_ */
@@ -307,12 +307,13 @@ Group=clixon
 WantedBy=multi-user.target
 EOFSVC
 
-    # VPP drop-in to restart Clixon after VPP restart
+    # VPP drop-in to start Clixon with VPP
     mkdir -p "${STAGING_DIR}/etc/systemd/system/vpp.service.d"
     cat > "${STAGING_DIR}/etc/systemd/system/vpp.service.d/restart-clixon.conf" << 'EOFDROP'
-[Service]
-# Restart Clixon in background after VPP starts (wait 90s for full VPP init)
-ExecStartPost=-/bin/bash -c '(sleep 90 && systemctl restart clixon-vpp-backend) &'
+[Unit]
+# Start the backend with VPP. It is not restarted with VPP: it watches
+# /run/vpp and re-applies the configuration once VPP answers.
+Wants=clixon-vpp-backend.service
 EOFDROP
 
     # Netns dataplane service (required for LCP)
@@ -12,6 +12,7 @@ set -e
 # Configuration
 CLIXON_CONFIG="/etc/clixon/clixon-vpp.xml"
 VPP_STARTUP_CONFIG="/etc/vpp/startup.conf"
+VPP_CLI_SOCK="/run/vpp/cli.sock"
 LOG_DIR="/var/log/clixon"
 
 # Colors
@@ -48,7 +49,6 @@ start_vpp() {
     # Start VPP via systemd if available
     if systemctl is-enabled vpp &> /dev/null; then
         systemctl start vpp
-        sleep 2
         
         if systemctl is-active vpp &> /dev/null; then
             log_info "VPP started successfully via systemd"
@@ -62,9 +62,8 @@ start_vpp() {
         # Start VPP directly
         log_warn "Starting VPP without systemd..."
         vpp -c "$VPP_STARTUP_CONFIG" &
-        sleep 3
         
-        if pgrep -x vpp > /dev/null; then
+        if kill -0 $! 2> /dev/null; then
             log_info "VPP started successfully"
             return 0
         else
@@ -74,24 +73,30 @@ start_vpp() {
     fi
 }
 
+# Woken by inotifywait (inotify-tools) when /run/vpp changes, one probe
+# each time; the 1 s timeout is only a fallback
 wait_for_vpp() {
-    log_info "Waiting for VPP API to be ready..."
+    log_info "Waiting for VPP to be ready..."
     
-    local max_attempts=30
-    local attempt=0
+    local deadline=$((SECONDS + 30))
+    local dir
     
-    while [[ $attempt -lt $max_attempts ]]; do
-        if [[ -S /run/vpp/api.sock ]] || [[ -S /var/run/vpp/api.sock ]]; then
-            log_info "VPP API socket is ready"
-            return 0
+    until [[ -S "$VPP_CLI_SOCK" ]] && vppctl -s "$VPP_CLI_SOCK" show version &> /dev/null; do
+        if [[ $SECONDS -ge $deadline ]]; then
+            log_error "Timeout waiting for VPP"
+            return 1
+        fi
+        dir=$(dirname "$VPP_CLI_SOCK")
+        while [[ ! -d "$dir" ]]; do dir=$(dirname "$dir"); done
+        if command -v inotifywait &> /dev/null; then
+            inotifywait -qq -t 1 -e create -e moved_to "$dir" 2>/dev/null || true
+        else
+            sleep 1
         fi
-        
-        ((attempt++))
-        sleep 1
     done
     
-    log_error "Timeout waiting for VPP API socket"
-    return 1
+    log_info "VPP is ready"
+    return 0
 }
 
 start_clixon_backend() {
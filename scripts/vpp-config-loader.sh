@@ -7,6 +7,8 @@
 CONFIG_FILE="${VPP_CONFIG_FILE:-/var/lib/clixon/vpp/vpp_config.xml}"
 LOG_FILE="/var/log/vpp/config-loader.log"
 VPP_SOCK="/run/vpp/cli.sock"
+BATCH_DIR="${VPP_BATCH_DIR:-/dev/shm}"
+BATCH_MARK="@@vpp-config-loader"
 
 mkdir -p "$(dirname "$LOG_FILE")" 2>/dev/null
 
@@ -14,24 +16,75 @@ log() {
     echo "[$(date '+%Y-%m-%d %H:%M:%S')] $1" | tee -a "$LOG_FILE"
 }
 
+# Commands are queued and sent to VPP as one "exec" script at the end
+BATCH_CMDS=()
+batch_failed=0
+
 vpp_exec() {
     local cmd="$1"
-    log "  -> vppctl: $cmd"
-    sudo vppctl -s "$VPP_SOCK" "$cmd" 2>&1
+    log "  -> queued: $cmd"
+    BATCH_CMDS+=("$cmd")
+}
+
+# Run all queued commands with "vppctl exec <script>". Echo markers
+# between the commands show how far VPP got: exec stops at the first
+# failing command, which is logged and skipped before resubmitting.
+vpp_exec_batch() {
+    local total=${#BATCH_CMDS[@]}
+    local start=0
+    local script out last i
+
+    while [ "$start" -lt "$total" ]; do
+        script=$(mktemp "$BATCH_DIR/vpp-config-loader.XXXXXX") || return 1
+        chmod 644 "$script"
+        for ((i = start; i < total; i++)); do
+            echo "echo $BATCH_MARK $i@@"
+            echo "${BATCH_CMDS[$i]}"
+        done > "$script"
+        echo "echo $BATCH_MARK end@@" >> "$script"
+
+        out=$(sudo vppctl -s "$VPP_SOCK" exec "$script" 2>&1)
+        rm -f "$script"
+        echo "$out" | grep -v "^$BATCH_MARK" >> "$LOG_FILE"
+
+        if grep -q "^$BATCH_MARK end@@" <<< "$out"; then
+            break
+        fi
+        last=$(grep -o "^$BATCH_MARK [0-9]*@@" <<< "$out" | tail -1 | tr -dc '0-9')
+        if [ -z "$last" ]; then
+            log "ERROR: exec of command batch failed: $out"
+            return 1
+        fi
+        log "  FAILED: ${BATCH_CMDS[$last]}"
+        ((batch_failed++))
+        start=$((last + 1))
+    done
+    return 0
 }
 
+# Probe once whenever the socket directory changes (inotifywait, from
+# inotify-tools), not once a second; the timeout covers a socket that
+# appeared between probe and watch
 wait_for_vpp() {
+    local dir ver
+    local deadline=$((SECONDS + 120))
+
     log "Waiting for VPP to be ready..."
-    for i in {1..120}; do
-        if sudo vppctl -s "$VPP_SOCK" show version >/dev/null 2>&1; then
-            local ver=$(sudo vppctl -s "$VPP_SOCK" show version 2>/dev/null | head -1)
-            log "VPP is ready: $ver"
-            return 0
+    until ver=$(sudo vppctl -s "$VPP_SOCK" show version 2>/dev/null | head -1) && [ -n "$ver" ]; do
+        if [ "$SECONDS" -ge "$deadline" ]; then
+            log "ERROR: VPP not ready after 120 seconds"
+            return 1
+        fi
+        dir=$(dirname "$VPP_SOCK")
+        while [ ! -d "$dir" ]; do dir=$(dirname "$dir"); done
+        if command -v inotifywait >/dev/null 2>&1; then
+            inotifywait -qq -t 1 -e create -e moved_to "$dir" 2>/dev/null
+        else
+            sleep 1
         fi
-        sleep 1
     done
-    log "ERROR: VPP not ready after 120 seconds"
-    return 1
+    log "VPP is ready: $ver"
+    return 0
 }
 
 log "=========================================="
@@ -49,6 +102,10 @@ fi
 
 log "Loading configuration..."
 
+# Current VPP state, fetched once for the existence checks below
+vpp_interfaces=$(sudo vppctl -s "$VPP_SOCK" show interface 2>/dev/null)
+vpp_lcps=$(sudo vppctl -s "$VPP_SOCK" show lcp 2>/dev/null)
+
 # ================================================================
 # 1. Create Bonds
 # ================================================================
@@ -71,7 +128,7 @@ for bond_name in $(xmllint --xpath '//*[local-name()="bond"]/*[local-name()="nam
     log "Creating bond: $bond_name (mode=$mode, lb=$lb, id=$bond_id)"
     
     # Check if bond already exists
-    if sudo vppctl -s "$VPP_SOCK" show interface "$bond_name" 2>/dev/null | grep -q "$bond_name"; then
+    if grep -qw "$bond_name" <<< "$vpp_interfaces"; then
         log "  Bond $bond_name already exists"
     else
         vpp_exec "create bond mode $mode id $bond_id load-balance $lb"
@@ -155,7 +212,7 @@ for vpp_if in $(xmllint --xpath '//*[local-name()="lcp"]/*[local-name()="vpp-int
     [ -z "$host_if" ] && continue
     
     # Check if LCP already exists
-    if sudo vppctl -s "$VPP_SOCK" show lcp 2>/dev/null | grep -q "$vpp_if"; then
+    if grep -qF "$vpp_if" <<< "$vpp_lcps"; then
         log "  LCP for $vpp_if already exists"
     else
         if [ -n "$netns" ]; then
@@ -171,9 +228,13 @@ done
 
 log "LCPs created: $lcp_count"
 
+log "=== Applying ${#BATCH_CMDS[@]} commands ==="
+vpp_exec_batch || exit 1
+
 log "=========================================="
 log "VPP Config Loader Complete"
 log "  Bonds: $bond_count"
 log "  Interfaces: $if_count"
 log "  LCPs: $lcp_count"
+log "  Failed commands: $batch_failed"
 log "=========================================="
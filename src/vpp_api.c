@@ -1,6 +1,10 @@
 /*
  * VPP API Integration for Clixon CLI
  * Stub mode - uses VPP CLI socket for communication
+ *
+ * The read side (connect/get_*) is only compiled with VPP_STUB_MODE,
+ * otherwise vpp_api_vapi.c provides it. The CLI wrappers, string tables
+ * and index lookup below are shared by both builds.
  */
 
 #include <stdbool.h>
@@ -11,9 +15,7 @@
 
 #include "vpp_api.h"
 #include "vpp_connection.h"
-
-/* Stub mode - always use CLI fallback */
-static bool api_connected = false;
+#include "vpp_tok.h"
 
 /* Bond mode strings */
 static const char *bond_modes[] = {
@@ -47,6 +49,46 @@ const char *vpp_lb_mode_str(uint8_t lb) {
   return "l2";
 }
 
+vpp_api_set_t *vpp_api_set_new(size_t item_size, size_t cap) {
+  vpp_api_set_t *set;
+
+  if (cap == 0)
+    cap = 1;
+  set = malloc(sizeof(*set) + item_size * cap);
+  if (!set)
+    return NULL;
+  set->count = 0;
+  set->cap = cap;
+  set->item_size = item_size;
+  return set;
+}
+
+void *vpp_api_set_push(vpp_api_set_t **set) {
+  vpp_api_set_t *s = *set;
+  void *item;
+
+  if (s->count == s->cap) {
+    s = realloc(s, sizeof(*s) + s->item_size * s->cap * 2);
+    if (!s) {
+      free(*set);
+      *set = NULL;
+      return NULL;
+    }
+    s->cap *= 2;
+    *set = s;
+  }
+  item = vpp_api_set_item(s, s->count++);
+  memset(item, 0, s->item_size);
+  return item;
+}
+
+void vpp_api_set_free(vpp_api_set_t *set) { free(set); }
+
+#ifdef VPP_STUB_MODE
+
+/* Stub mode - always use CLI fallback */
+static bool api_connected = false;
+
 /* Stub implementations - use CLI fallback */
 
 int vpp_api_connect(const char *client_name) {
@@ -60,165 +102,163 @@ void vpp_api_disconnect(void) { api_connected = false; }
 
 bool vpp_api_is_connected(void) { return api_connected; }
 
-int vpp_api_get_bonds(vpp_bond_info_t *bonds, int max_bonds) {
-  if (!bonds || max_bonds <= 0)
-    return -1;
+#define NMODES(table) (sizeof(table) / sizeof(table[0]))
 
+/* Index of s in a string table, or -1 */
+static int str_index(vpp_slice_t s, const char *const *table, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    if (vpp_tok_eq(s, table[i]))
+      return (int)i;
+  return -1;
+}
+
+/* Unindented lines of output that start with prefix, an upper bound
+ * on the items a getter parses from it */
+static size_t count_rows(const char *output, const char *prefix) {
+  size_t n = strlen(prefix);
+  size_t rows = 0;
+
+  for (const char *p = output; p; p = strchr(p, '\n')) {
+    if (*p == '\n')
+      p++;
+    if (*p && *p != ' ' && *p != '\t' && strncmp(p, prefix, n) == 0)
+      rows++;
+  }
+  return rows;
+}
+
+vpp_api_set_t *vpp_api_get_bonds(void) {
   /* Use CLI to get bond info */
   char *output = vpp_cli_exec("show bond details");
   if (!output)
-    return 0;
+    return NULL;
 
-  int count = 0;
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\n", &saveptr);
+  vpp_api_set_t *set = vpp_api_set_new(sizeof(vpp_bond_info_t),
+                                       count_rows(output, "BondEthernet"));
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
   /* Current bond being parsed */
   vpp_bond_info_t *current = NULL;
 
-  while (line && count < max_bonds) {
+  vpp_tok_init_str(&tok, output);
+  while (set && vpp_tok_line(&tok, &line)) {
+    vpp_slice_t rest = vpp_tok_trim(line);
+    vpp_slice_t val;
+    int i;
+
     /* Check for bond name line (starts with "BondEthernet") */
-    if (strncmp(line, "BondEthernet", 12) == 0) {
-      current = &bonds[count];
-      memset(current, 0, sizeof(vpp_bond_info_t));
-
-      /* Extract name */
-      char name[64];
-      if (sscanf(line, "%63s", name) == 1) {
-        strncpy(current->name, name, sizeof(current->name) - 1);
-        current->id = atoi(name + 12);
-        current->mode = 5; /* lacp default */
-        current->lb = 0;   /* l2 default */
-        count++;
-      }
-    }
-    /* Parse mode line */
-    else if (current && strstr(line, "mode:")) {
-      char mode[32];
-      if (sscanf(line, "  mode: %31s", mode) == 1) {
-        if (strcmp(mode, "round-robin") == 0)
-          current->mode = 1;
-        else if (strcmp(mode, "active-backup") == 0)
-          current->mode = 2;
-        else if (strcmp(mode, "xor") == 0)
-          current->mode = 3;
-        else if (strcmp(mode, "broadcast") == 0)
-          current->mode = 4;
-        else if (strcmp(mode, "lacp") == 0)
-          current->mode = 5;
-      }
-    }
-    /* Parse load balance line */
-    else if (current && strstr(line, "load balance:")) {
-      char lb[16];
-      if (sscanf(line, "  load balance: %15s", lb) == 1) {
-        if (strcmp(lb, "l2") == 0)
-          current->lb = 0;
-        else if (strcmp(lb, "l34") == 0)
-          current->lb = 1;
-        else if (strcmp(lb, "l23") == 0)
-          current->lb = 2;
-        else if (strcmp(lb, "rr") == 0)
-          current->lb = 3;
-        else if (strcmp(lb, "bc") == 0)
-          current->lb = 4;
-        else if (strcmp(lb, "ab") == 0)
-          current->lb = 5;
-      }
+    if (vpp_tok_prefix(line, "BondEthernet")) {
+      if (!(current = vpp_api_set_push(&set)))
+        break;
+
+      vpp_tok_field(&rest, &val);
+      vpp_tok_copy(val, current->name, sizeof(current->name));
+      current->id = (uint32_t)atoi(current->name + 12);
+      current->mode = 5; /* lacp default */
+      current->lb = 0;   /* l2 default */
+    } else if (!current) {
+      continue;
+    } else if (vpp_tok_skip(&rest, "mode:")) {
+      vpp_tok_field(&rest, &val);
+      i = str_index(val, bond_modes, NMODES(bond_modes));
+      if (i > 0) /* Not "unknown" */
+        current->mode = (uint8_t)i;
+    } else if (vpp_tok_skip(&rest, "load balance:")) {
+      vpp_tok_field(&rest, &val);
+      i = str_index(val, lb_modes, NMODES(lb_modes));
+      if (i >= 0)
+        current->lb = (uint8_t)i;
+    } else if (vpp_tok_skip(&rest, "number of members:")) {
+      if (vpp_tok_field(&rest, &val))
+        vpp_tok_u32(val, &current->members);
+    } else if (vpp_tok_skip(&rest, "number of active members:")) {
+      if (vpp_tok_field(&rest, &val))
+        vpp_tok_u32(val, &current->active_members);
+    } else if (vpp_tok_skip(&rest, "sw_if_index:")) {
+      if (vpp_tok_field(&rest, &val))
+        vpp_tok_u32(val, &current->sw_if_index);
     }
-    /* Parse number of members */
-    else if (current && strstr(line, "number of members:")) {
-      sscanf(line, "  number of members: %d", (int *)&current->members);
-    }
-    /* Parse active members */
-    else if (current && strstr(line, "number of active members:")) {
-      sscanf(line, "  number of active members: %d",
-             (int *)&current->active_members);
-    }
-    /* Parse sw_if_index */
-    else if (current && strstr(line, "sw_if_index:")) {
-      sscanf(line, "  sw_if_index: %u", &current->sw_if_index);
-    }
-
-    line = strtok_r(NULL, "\n", &saveptr);
   }
 
   free(output);
-  return count;
+  return set;
 }
 
-int vpp_api_get_lcps(vpp_lcp_info_t *lcps, int max_lcps) {
-  if (!lcps || max_lcps <= 0)
-    return -1;
-
+vpp_api_set_t *vpp_api_get_lcps(void) {
   char *output = vpp_cli_exec("show lcp");
   if (!output)
-    return 0;
+    return NULL;
 
-  int count = 0;
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\n", &saveptr);
+  vpp_api_set_t *set =
+      vpp_api_set_new(sizeof(vpp_lcp_info_t), count_rows(output, "itf-pair:"));
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
-  while (line && count < max_lcps) {
+  vpp_tok_init_str(&tok, output);
+  while (set && vpp_tok_line(&tok, &line)) {
     /* Format: itf-pair: [N] vpp_if tap_if host_if idx type tap netns name */
-    if (strncmp(line, "itf-pair:", 9) == 0) {
-      int idx, host_sw;
-      char vpp_if[128], tap_if[64], host_if[64], type[16], netns[64];
-
-      if (sscanf(line, "itf-pair: [%d] %127s %63s %63s %d type %15s netns %63s",
-                 &idx, vpp_if, tap_if, host_if, &host_sw, type, netns) >= 6) {
-        memset(&lcps[count], 0, sizeof(vpp_lcp_info_t));
-        strncpy(lcps[count].vpp_if, vpp_if, sizeof(lcps[count].vpp_if) - 1);
-        strncpy(lcps[count].host_if, host_if, sizeof(lcps[count].host_if) - 1);
-        strncpy(lcps[count].netns, netns, sizeof(lcps[count].netns) - 1);
-        lcps[count].phy_sw_if_index = idx;
-        lcps[count].host_sw_if_index = host_sw;
-        count++;
-      }
-    }
-    line = strtok_r(NULL, "\n", &saveptr);
+    vpp_slice_t f[9];
+    vpp_lcp_info_t *lcp;
+    uint32_t idx, host_sw;
+    size_t n = 0;
+
+    if (!vpp_tok_skip(&line, "itf-pair:"))
+      continue;
+    while (n < 9 && vpp_tok_field(&line, &f[n]))
+      n++;
+    if (n < 7 || f[0].len < 3 || f[0].ptr[0] != '[' ||
+        f[0].ptr[f[0].len - 1] != ']' ||
+        !vpp_tok_u32((vpp_slice_t){f[0].ptr + 1, f[0].len - 2}, &idx) ||
+        !vpp_tok_u32(f[4], &host_sw) || !vpp_tok_eq(f[5], "type"))
+      continue;
+
+    if (!(lcp = vpp_api_set_push(&set)))
+      break;
+    vpp_tok_copy(f[1], lcp->vpp_if, sizeof(lcp->vpp_if));
+    vpp_tok_copy(f[3], lcp->host_if, sizeof(lcp->host_if));
+    if (n == 9 && vpp_tok_eq(f[7], "netns"))
+      vpp_tok_copy(f[8], lcp->netns, sizeof(lcp->netns));
+    lcp->phy_sw_if_index = idx;
+    lcp->host_sw_if_index = host_sw;
   }
 
   free(output);
-  return count;
+  return set;
 }
 
-int vpp_api_get_interfaces(vpp_interface_info_t *ifs, int max_ifs) {
-  if (!ifs || max_ifs <= 0)
-    return -1;
-
+vpp_api_set_t *vpp_api_get_interfaces(void) {
   char *output = vpp_cli_exec("show interface");
   if (!output)
-    return 0;
-
-  int count = 0;
-  char *line = strtok(output, "\n");
-
-  /* Skip header */
-  if (line)
-    line = strtok(NULL, "\n");
-
-  while (line && count < max_ifs) {
-    char name[64], state[16];
-    int idx;
-
-    if (sscanf(line, "%63s %d %15s", name, &idx, state) >= 2) {
-      if (name[0] >= 'A' && name[0] <= 'z' && strcmp(name, "Name") != 0) {
-        strncpy(ifs[count].name, name, sizeof(ifs[count].name) - 1);
-        ifs[count].sw_if_index = idx;
-        ifs[count].admin_up = (strcmp(state, "up") == 0);
-        ifs[count].link_up = (strcmp(state, "up") == 0);
-        ifs[count].mtu = 1500;
-        count++;
-      }
-    }
-    line = strtok(NULL, "\n");
+    return NULL;
+
+  vpp_api_set_t *set =
+      vpp_api_set_new(sizeof(vpp_interface_info_t), count_rows(output, ""));
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
+
+  vpp_tok_init_str(&tok, output);
+  while (set && vpp_tok_line(&tok, &line)) {
+    vpp_interface_info_t *ifi;
+
+    if (!vpp_tok_show_interface_row(line, &row))
+      continue;
+    if (!(ifi = vpp_api_set_push(&set)))
+      break;
+    vpp_tok_copy(row.name, ifi->name, sizeof(ifi->name));
+    ifi->sw_if_index = row.sw_if_index;
+    ifi->admin_up = vpp_tok_eq(row.state, "up");
+    ifi->link_up = ifi->admin_up;
+    ifi->mtu = row.mtu ? row.mtu : 1500;
   }
 
   free(output);
-  return count;
+  return set;
 }
 
+#endif /* VPP_STUB_MODE */
+
 /* CLI helper functions - these use vpp_cli_exec from vpp_connection.h */
 
 int vpp_cli_create_bond(const char *mode, const char *lb, uint32_t id,
@@ -429,14 +469,18 @@ int vpp_api_get_interface_index(const char *ifname) {
   if (!ifname)
     return -1;
 
-  vpp_interface_info_t ifaces[256];
-  int count = vpp_api_get_interfaces(ifaces, 256);
+  vpp_api_set_t *ifs = vpp_api_get_interfaces();
+  vpp_api_iter_t it = vpp_api_iter(ifs);
+  const vpp_interface_info_t *ifi;
+  int sw_if_index = -1;
 
-  for (int i = 0; i < count; i++) {
-    if (strcmp(ifaces[i].name, ifname) == 0) {
-      return ifaces[i].sw_if_index;
+  while ((ifi = vpp_api_iter_next(&it))) {
+    if (strcmp(ifi->name, ifname) == 0) {
+      sw_if_index = (int)ifi->sw_if_index;
+      break;
     }
   }
 
-  return -1;
+  vpp_api_set_free(ifs);
+  return sw_if_index;
 }
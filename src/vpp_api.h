@@ -1,6 +1,10 @@
 /*
  * VPP API Integration for Clixon CLI
  * Uses VAPI (VPP API) for direct communication with VPP
+ *
+ * Two implementations of the read side share this contract:
+ *   vpp_api.c      - VPP_STUB_MODE, scrapes CLI output (default build)
+ *   vpp_api_vapi.c - binary API via VAPI (make VPP_API=vapi)
  */
 
 #ifndef VPP_API_H
@@ -52,14 +56,56 @@ void vpp_api_disconnect(void);
 /* Check if connected */
 bool vpp_api_is_connected(void);
 
-/* Get all bond interfaces - returns count, fills array */
-int vpp_api_get_bonds(vpp_bond_info_t *bonds, int max_bonds);
+/*
+ * Result set of one dump: the header and every item in one heap block,
+ * released with one vpp_api_set_free(). There is no cap on the count;
+ * the stub getters size the block from the output before parsing it.
+ */
+typedef struct {
+  size_t count;
+  size_t cap;
+  size_t item_size;
+  _Alignas(16) unsigned char items[];
+} vpp_api_set_t;
+
+/* Get all bonds, LCP pairs or interfaces; NULL if VPP cannot be read */
+vpp_api_set_t *vpp_api_get_bonds(void);      /* vpp_bond_info_t */
+vpp_api_set_t *vpp_api_get_lcps(void);       /* vpp_lcp_info_t */
+vpp_api_set_t *vpp_api_get_interfaces(void); /* vpp_interface_info_t */
 
-/* Get all LCP pairs - returns count, fills array */
-int vpp_api_get_lcps(vpp_lcp_info_t *lcps, int max_lcps);
+void vpp_api_set_free(vpp_api_set_t *set);
 
-/* Get all interfaces - returns count, fills array */
-int vpp_api_get_interfaces(vpp_interface_info_t *ifs, int max_ifs);
+/* Item i of a set */
+static inline void *vpp_api_set_item(const vpp_api_set_t *set, size_t i) {
+  return (void *)(set->items + i * set->item_size);
+}
+
+/*
+ * Walk a set, NULL-safe:
+ *   vpp_api_iter_t it = vpp_api_iter(set);
+ *   const vpp_bond_info_t *b;
+ *   while ((b = vpp_api_iter_next(&it)))
+ */
+typedef struct {
+  const vpp_api_set_t *set;
+  size_t next;
+} vpp_api_iter_t;
+
+static inline vpp_api_iter_t vpp_api_iter(const vpp_api_set_t *set) {
+  return (vpp_api_iter_t){set, 0};
+}
+
+static inline void *vpp_api_iter_next(vpp_api_iter_t *it) {
+  if (!it->set || it->next >= it->set->count)
+    return NULL;
+  return vpp_api_set_item(it->set, it->next++);
+}
+
+/* For the getters: a set with room for cap items, and a zeroed next
+ * item, growing the set when it is full. Out of memory, push frees the
+ * set and leaves *set NULL, so a getter never returns part of a dump. */
+vpp_api_set_t *vpp_api_set_new(size_t item_size, size_t cap);
+void *vpp_api_set_push(vpp_api_set_t **set);
 
 /* Convert bond mode number to string */
 const char *vpp_bond_mode_str(uint8_t mode);
@@ -0,0 +1,307 @@
+/*
+ * VPP API Integration for Clixon CLI
+ * VAPI mode - binary API over VPP's shared-memory API segment
+ *
+ * Implements the read side of vpp_api.h with sw_interface_dump,
+ * sw_bond_interface_dump and lcp_itf_pair_get. Details messages are
+ * copied straight into the result set from the VAPI callbacks, so there
+ * is no text to parse and no dependency on column positions.
+ *
+ * Built instead of the stub getters in vpp_api.c when VPP_STUB_MODE is
+ * not defined (make VPP_API=vapi).
+ */
+
+#ifndef VPP_STUB_MODE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vapi/vapi.h>
+#include <vapi/vpe.api.vapi.h>
+#include <vapi/interface.api.vapi.h>
+#include <vapi/bond.api.vapi.h>
+#include <vapi/lcp.api.vapi.h>
+#include <vapi/vlib.api.vapi.h>
+
+#include "vpp_api.h"
+
+DEFINE_VAPI_MSG_IDS_VPE_API_JSON
+DEFINE_VAPI_MSG_IDS_INTERFACE_API_JSON
+DEFINE_VAPI_MSG_IDS_BOND_API_JSON
+DEFINE_VAPI_MSG_IDS_LCP_API_JSON
+DEFINE_VAPI_MSG_IDS_VLIB_API_JSON
+
+#define VAPI_MAX_OUTSTANDING 256
+#define VAPI_RESPONSE_QUEUE 256
+#define VNET_API_ERROR_EAGAIN (-165) /* _get: more entries, resume at cursor */
+#define VAPI_SET_CAP 64 /* Items a result set starts with, doubles after */
+
+static vapi_ctx_t api_ctx = NULL;
+static bool api_connected = false;
+
+int vpp_api_connect(const char *client_name) {
+  vapi_error_e rv;
+
+  if (api_connected)
+    return 0;
+
+  if (!api_ctx) {
+    rv = vapi_ctx_alloc(&api_ctx);
+    if (rv != VAPI_OK) {
+      fprintf(stderr, "[vpp-api] vapi_ctx_alloc failed: %d\n", rv);
+      api_ctx = NULL;
+      return -1;
+    }
+  }
+
+  rv = vapi_connect(api_ctx, client_name ? client_name : "clixon-vpp", NULL,
+                    VAPI_MAX_OUTSTANDING, VAPI_RESPONSE_QUEUE,
+                    VAPI_MODE_BLOCKING, true);
+  if (rv != VAPI_OK) {
+    fprintf(stderr, "[vpp-api] vapi_connect failed: %d\n", rv);
+    return -1;
+  }
+
+  api_connected = true;
+  return 0;
+}
+
+void vpp_api_disconnect(void) {
+  if (api_connected)
+    vapi_disconnect(api_ctx);
+  if (api_ctx)
+    vapi_ctx_free(api_ctx);
+  api_ctx = NULL;
+  api_connected = false;
+}
+
+bool vpp_api_is_connected(void) { return api_connected; }
+
+static bool api_ensure_connected(void) {
+  return api_connected || vpp_api_connect("clixon-vpp") == 0;
+}
+
+/* Copy a fixed-size, possibly unterminated, API string */
+static void api_strcpy(char *dst, size_t dstlen, const char *src,
+                       size_t srclen) {
+  size_t n = strnlen(src, srclen);
+  if (n >= dstlen)
+    n = dstlen - 1;
+  memcpy(dst, src, n);
+  dst[n] = '\0';
+}
+
+/*
+ * Interfaces
+ */
+
+typedef struct {
+  vpp_api_set_t *set;
+} if_dump_ctx_t;
+
+static vapi_error_e sw_interface_details_cb(
+    struct vapi_ctx_s *ctx, void *callback_ctx, vapi_error_e rv, bool is_last,
+    vapi_payload_sw_interface_details *reply) {
+  if_dump_ctx_t *dc = callback_ctx;
+  vpp_interface_info_t *ifi;
+
+  (void)ctx;
+  if (rv != VAPI_OK || is_last || !reply || !dc->set ||
+      !(ifi = vpp_api_set_push(&dc->set)))
+    return VAPI_OK;
+
+  api_strcpy(ifi->name, sizeof(ifi->name), (const char *)reply->interface_name,
+             sizeof(reply->interface_name));
+  ifi->sw_if_index = reply->sw_if_index;
+  ifi->admin_up = (reply->flags & IF_STATUS_API_FLAG_ADMIN_UP) != 0;
+  ifi->link_up = (reply->flags & IF_STATUS_API_FLAG_LINK_UP) != 0;
+  ifi->mtu = reply->mtu[0] ? reply->mtu[0] : reply->link_mtu;
+  return VAPI_OK;
+}
+
+vpp_api_set_t *vpp_api_get_interfaces(void) {
+  if_dump_ctx_t dc;
+  vapi_msg_sw_interface_dump *msg;
+  vapi_error_e rv;
+
+  if (!api_ensure_connected())
+    return NULL;
+
+  msg = vapi_alloc_sw_interface_dump(api_ctx, 0);
+  if (!msg)
+    return NULL;
+  msg->payload.sw_if_index = ~0;
+  msg->payload.name_filter_valid = false;
+
+  dc.set = vpp_api_set_new(sizeof(vpp_interface_info_t), VAPI_SET_CAP);
+  rv = vapi_sw_interface_dump(api_ctx, msg, sw_interface_details_cb, &dc);
+  if (rv != VAPI_OK) {
+    fprintf(stderr, "[vpp-api] sw_interface_dump failed: %d\n", rv);
+    vpp_api_set_free(dc.set);
+    return NULL;
+  }
+  return dc.set;
+}
+
+/*
+ * Bonds
+ */
+
+typedef struct {
+  vpp_api_set_t *set;
+} bond_dump_ctx_t;
+
+static vapi_error_e sw_bond_interface_details_cb(
+    struct vapi_ctx_s *ctx, void *callback_ctx, vapi_error_e rv, bool is_last,
+    vapi_payload_sw_bond_interface_details *reply) {
+  bond_dump_ctx_t *dc = callback_ctx;
+  vpp_bond_info_t *bond;
+
+  (void)ctx;
+  if (rv != VAPI_OK || is_last || !reply || !dc->set ||
+      !(bond = vpp_api_set_push(&dc->set)))
+    return VAPI_OK;
+
+  /* vapi_enum_bond_mode and _lb_algo share numbering with vpp_api.c */
+  api_strcpy(bond->name, sizeof(bond->name),
+             (const char *)reply->interface_name,
+             sizeof(reply->interface_name));
+  bond->sw_if_index = reply->sw_if_index;
+  bond->id = reply->id;
+  bond->mode = (uint8_t)reply->mode;
+  bond->lb = (uint8_t)reply->lb;
+  bond->active_members = reply->active_members;
+  bond->members = reply->members;
+  return VAPI_OK;
+}
+
+vpp_api_set_t *vpp_api_get_bonds(void) {
+  bond_dump_ctx_t dc;
+  vapi_msg_sw_bond_interface_dump *msg;
+  vapi_error_e rv;
+
+  if (!api_ensure_connected())
+    return NULL;
+
+  msg = vapi_alloc_sw_bond_interface_dump(api_ctx);
+  if (!msg)
+    return NULL;
+  msg->payload.sw_if_index = ~0;
+
+  dc.set = vpp_api_set_new(sizeof(vpp_bond_info_t), VAPI_SET_CAP);
+  rv = vapi_sw_bond_interface_dump(api_ctx, msg, sw_bond_interface_details_cb,
+                                   &dc);
+  if (rv != VAPI_OK) {
+    fprintf(stderr, "[vpp-api] sw_bond_interface_dump failed: %d\n", rv);
+    vpp_api_set_free(dc.set);
+    return NULL;
+  }
+  return dc.set;
+}
+
+/*
+ * LCP pairs
+ *
+ * lcp_itf_pair_details only carries sw_if_index values, the VPP side
+ * name is resolved afterwards from one sw_interface_dump.
+ */
+
+typedef struct {
+  vpp_api_set_t *set;
+  int retval;
+  uint32_t cursor;
+} lcp_dump_ctx_t;
+
+static vapi_error_e lcp_itf_pair_get_reply_cb(
+    struct vapi_ctx_s *ctx, void *callback_ctx, vapi_error_e rv, bool is_last,
+    vapi_payload_lcp_itf_pair_get_reply *reply) {
+  lcp_dump_ctx_t *dc = callback_ctx;
+
+  (void)ctx;
+  (void)is_last;
+  if (rv != VAPI_OK || !reply) {
+    dc->retval = -1;
+    return VAPI_OK;
+  }
+  dc->retval = reply->retval;
+  dc->cursor = reply->cursor;
+  return VAPI_OK;
+}
+
+static vapi_error_e lcp_itf_pair_details_cb(
+    struct vapi_ctx_s *ctx, void *callback_ctx, vapi_error_e rv, bool is_last,
+    vapi_payload_lcp_itf_pair_details *reply) {
+  lcp_dump_ctx_t *dc = callback_ctx;
+  vpp_lcp_info_t *lcp;
+
+  (void)ctx;
+  if (rv != VAPI_OK || is_last || !reply || !dc->set ||
+      !(lcp = vpp_api_set_push(&dc->set)))
+    return VAPI_OK;
+
+  lcp->phy_sw_if_index = reply->phy_sw_if_index;
+  lcp->host_sw_if_index = reply->host_sw_if_index;
+  api_strcpy(lcp->host_if, sizeof(lcp->host_if),
+             (const char *)reply->host_if_name, sizeof(reply->host_if_name));
+  api_strcpy(lcp->netns, sizeof(lcp->netns), (const char *)reply->netns,
+             sizeof(reply->netns));
+  return VAPI_OK;
+}
+
+vpp_api_set_t *vpp_api_get_lcps(void) {
+  lcp_dump_ctx_t dc = {.cursor = 0};
+  vapi_msg_lcp_itf_pair_get *msg;
+  vpp_api_set_t *ifs;
+  vapi_error_e rv;
+
+  if (!api_ensure_connected())
+    return NULL;
+
+  dc.set = vpp_api_set_new(sizeof(vpp_lcp_info_t), VAPI_SET_CAP);
+
+  /* Paged: VPP answers EAGAIN with a cursor when its queue fills up */
+  do {
+    msg = vapi_alloc_lcp_itf_pair_get(api_ctx);
+    if (!msg || !dc.set) {
+      vpp_api_set_free(dc.set);
+      return NULL;
+    }
+    msg->payload.cursor = dc.cursor;
+    dc.retval = 0;
+
+    rv = vapi_lcp_itf_pair_get(api_ctx, msg, lcp_itf_pair_get_reply_cb, &dc,
+                               lcp_itf_pair_details_cb, &dc);
+    if (rv != VAPI_OK || (dc.retval != 0 && dc.retval != VNET_API_ERROR_EAGAIN)) {
+      fprintf(stderr, "[vpp-api] lcp_itf_pair_get failed: %d/%d\n", rv,
+              dc.retval);
+      vpp_api_set_free(dc.set);
+      return NULL;
+    }
+  } while (dc.retval == VNET_API_ERROR_EAGAIN);
+  if (!dc.set || dc.set->count == 0)
+    return dc.set;
+
+  /* Resolve phy_sw_if_index -> VPP interface name */
+  ifs = vpp_api_get_interfaces();
+  for (size_t i = 0; ifs && i < dc.set->count; i++) {
+    vpp_lcp_info_t *lcp = vpp_api_set_item(dc.set, i);
+    vpp_api_iter_t it = vpp_api_iter(ifs);
+    const vpp_interface_info_t *ifi;
+
+    while ((ifi = vpp_api_iter_next(&it))) {
+      if (ifi->sw_if_index == lcp->phy_sw_if_index) {
+        api_strcpy(lcp->vpp_if, sizeof(lcp->vpp_if), ifi->name,
+                   sizeof(ifi->name));
+        break;
+      }
+    }
+  }
+  vpp_api_set_free(ifs);
+
+  return dc.set;
+}
+
+#endif /* !VPP_STUB_MODE */
@@ -13,6 +13,7 @@
 #include <syslog.h>
 
 #include "vpp_api.h"
+#include "vpp_tok.h"
 
 /* Current interface context - stored in cligen userdata */
 static char current_interface[128] = "";
@@ -39,12 +40,21 @@ static int vpp_exec(const char *cmd, char *output, size_t output_len) {
     return -1;
 
   if (output && output_len > 0) {
-    output[0] = '\0';
+    size_t len = 0;
+    size_t n;
     char buf[256];
-    while (fgets(buf, sizeof(buf), fp)) {
-      size_t len = strlen(output);
-      if (len + strlen(buf) < output_len - 1)
-        strcat(output, buf);
+
+    /* Read straight into output; past its end keep whole lines only */
+    while (len < output_len - 1 &&
+           (n = fread(output + len, 1, output_len - 1 - len, fp)) > 0)
+      len += n;
+    output[len] = '\0';
+    if (len == output_len - 1 && fread(buf, 1, sizeof(buf), fp) > 0) {
+      char *nl = strrchr(output, '\n');
+      if (nl)
+        nl[1] = '\0';
+      while (fread(buf, 1, sizeof(buf), fp) > 0)
+        ;
     }
   }
 
@@ -670,6 +680,22 @@ static int ds_write_config_file(void) {
  * EXPAND/COMPLETION CALLBACKS - For tab completion
  *=============================================================*/
 
+/* Add a completion and its help text, both slices of a VPP output */
+static void cli_expand_add(cvec *commands, cvec *helptexts, vpp_slice_t cmd,
+                           vpp_slice_t help) {
+  char buf[128];
+  cg_var *cv;
+
+  vpp_tok_copy(cmd, buf, sizeof(buf));
+  cv = cvec_add(commands, CGV_STRING);
+  if (cv)
+    cv_string_set(cv, buf);
+  vpp_tok_copy(help, buf, sizeof(buf));
+  cv = cvec_add(helptexts, CGV_STRING);
+  if (cv)
+    cv_string_set(cv, buf);
+}
+
 /* Expand callback for interface names - provides tab completion */
 int cli_expand_interfaces(void *h, char *name, cvec *cvv, cvec *argv,
                           cvec *commands, cvec *helptexts) {
@@ -679,38 +705,19 @@ int cli_expand_interfaces(void *h, char *name, cvec *cvv, cvec *argv,
   (void)argv;
 
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
   if (vpp_exec("show interface", output, sizeof(output)) != 0) {
     return 0;
   }
 
-  /* Parse interface names from output */
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
-  /* Skip header line */
-  if (line) {
-    line = strtok_r(NULL, "\r\n", &saveptr);
-  }
-
-  while (line) {
-    char ifname[64];
-    int idx;
-    char state[16];
-
-    /* Parse: name idx state ... */
-    if (sscanf(line, "%63s %d %15s", ifname, &idx, state) >= 2) {
-      /* Skip header and invalid entries */
-      if (ifname[0] >= 'A' && ifname[0] <= 'z' && strcmp(ifname, "Name") != 0) {
-        cg_var *cv = cvec_add(commands, CGV_STRING);
-        if (cv)
-          cv_string_set(cv, ifname);
-        cv = cvec_add(helptexts, CGV_STRING);
-        if (cv)
-          cv_string_set(cv, state);
-      }
-    }
-    line = strtok_r(NULL, "\r\n", &saveptr);
+  /* Parse interface names from output: name idx state ... */
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (vpp_tok_show_interface_row(line, &row))
+      cli_expand_add(commands, helptexts, row.name, row.state);
   }
 
   return 0;
@@ -725,37 +732,24 @@ int cli_expand_ethernet(void *h, char *name, cvec *cvv, cvec *argv,
   (void)argv;
 
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
   if (vpp_exec("show interface", output, sizeof(output)) != 0) {
     return 0;
   }
 
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
-  /* Skip header */
-  if (line)
-    line = strtok_r(NULL, "\r\n", &saveptr);
-
-  while (line) {
-    char ifname[64];
-    int idx;
-    char state[16];
-
-    if (sscanf(line, "%63s %d %15s", ifname, &idx, state) >= 2) {
-      /* Only include physical ethernet interfaces (not Bond, loop, local0, tap)
-       */
-      if ((strstr(ifname, "Ethernet") || strstr(ifname, "ethernet")) &&
-          !strstr(ifname, "Bond") && !strchr(ifname, '.')) {
-        cg_var *cv = cvec_add(commands, CGV_STRING);
-        if (cv)
-          cv_string_set(cv, ifname);
-        cv = cvec_add(helptexts, CGV_STRING);
-        if (cv)
-          cv_string_set(cv, state);
-      }
-    }
-    line = strtok_r(NULL, "\r\n", &saveptr);
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (!vpp_tok_show_interface_row(line, &row))
+      continue;
+    /* Only include physical ethernet interfaces (not Bond, loop, local0, tap)
+     */
+    if ((vpp_tok_find(row.name, "Ethernet") ||
+         vpp_tok_find(row.name, "ethernet")) &&
+        !vpp_tok_find(row.name, "Bond") && !vpp_tok_has(row.name, '.'))
+      cli_expand_add(commands, helptexts, row.name, row.state);
   }
 
   return 0;
@@ -770,38 +764,18 @@ int cli_expand_bonds(void *h, char *name, cvec *cvv, cvec *argv, cvec *commands,
   (void)argv;
 
   char output[8192];
-  int max_bond_id = -1;
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
   if (vpp_exec("show interface", output, sizeof(output)) == 0) {
-    char *saveptr = NULL;
-    char *line = strtok_r(output, "\r\n", &saveptr);
-
-    /* Skip header */
-    if (line)
-      line = strtok_r(NULL, "\r\n", &saveptr);
-
-    while (line) {
-      char ifname[64];
-      int idx;
-      char state[16];
-
-      if (sscanf(line, "%63s %d %15s", ifname, &idx, state) >= 2) {
-        /* Include existing bond interfaces */
-        if (strncmp(ifname, "BondEthernet", 12) == 0 && !strchr(ifname, '.')) {
-          cg_var *cv = cvec_add(commands, CGV_STRING);
-          if (cv)
-            cv_string_set(cv, ifname);
-          cv = cvec_add(helptexts, CGV_STRING);
-          if (cv)
-            cv_string_set(cv, state);
-
-          /* Track max bond ID for suggestion */
-          int bond_id = atoi(ifname + 12);
-          if (bond_id > max_bond_id)
-            max_bond_id = bond_id;
-        }
-      }
-      line = strtok_r(NULL, "\r\n", &saveptr);
+    vpp_tok_init_str(&tok, output);
+    while (vpp_tok_line(&tok, &line)) {
+      /* Include existing bond interfaces */
+      if (vpp_tok_show_interface_row(line, &row) &&
+          vpp_tok_prefix(row.name, "BondEthernet") &&
+          !vpp_tok_has(row.name, '.'))
+        cli_expand_add(commands, helptexts, row.name, row.state);
     }
   }
 
@@ -825,32 +799,17 @@ int cli_expand_loopback(void *h, char *name, cvec *cvv, cvec *argv,
   (void)argv;
 
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
   if (vpp_exec("show interface", output, sizeof(output)) == 0) {
-    char *saveptr = NULL;
-    char *line = strtok_r(output, "\r\n", &saveptr);
-
-    /* Skip header */
-    if (line)
-      line = strtok_r(NULL, "\r\n", &saveptr);
-
-    while (line) {
-      char ifname[64];
-      int idx;
-      char state[16];
-
-      if (sscanf(line, "%63s %d %15s", ifname, &idx, state) >= 2) {
-        /* Include loopback interfaces (start with "loop") */
-        if (strncmp(ifname, "loop", 4) == 0) {
-          cg_var *cv = cvec_add(commands, CGV_STRING);
-          if (cv)
-            cv_string_set(cv, ifname);
-          cv = cvec_add(helptexts, CGV_STRING);
-          if (cv)
-            cv_string_set(cv, state);
-        }
-      }
-      line = strtok_r(NULL, "\r\n", &saveptr);
+    vpp_tok_init_str(&tok, output);
+    while (vpp_tok_line(&tok, &line)) {
+      /* Include loopback interfaces (start with "loop") */
+      if (vpp_tok_show_interface_row(line, &row) &&
+          vpp_tok_prefix(row.name, "loop"))
+        cli_expand_add(commands, helptexts, row.name, row.state);
     }
   }
 
@@ -865,67 +824,36 @@ int cli_expand_subifs(void *h, char *name, cvec *cvv, cvec *argv,
   (void)cvv;
   (void)argv;
 
+  static const vpp_slice_t add_vlan = {"(add VLAN ID)", 13};
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
   if (vpp_exec("show interface", output, sizeof(output)) != 0) {
     return 0;
   }
 
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
-  /* Skip header */
-  if (line)
-    line = strtok_r(NULL, "\r\n", &saveptr);
-
-  while (line) {
-    char ifname[64];
-    int idx;
-    char state[16];
-
-    if (sscanf(line, "%63s %d %15s", ifname, &idx, state) >= 2) {
-      /* Include sub-interfaces (contain '.') */
-      if (strchr(ifname, '.')) {
-        cg_var *cv = cvec_add(commands, CGV_STRING);
-        if (cv)
-          cv_string_set(cv, ifname);
-        cv = cvec_add(helptexts, CGV_STRING);
-        if (cv)
-          cv_string_set(cv, state);
-      }
-    }
-    line = strtok_r(NULL, "\r\n", &saveptr);
+  /* Sub-interfaces (contain '.') first, then the parent candidates:
+   * ethernet or bond interfaces. Two cursors over the same output. */
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (vpp_tok_show_interface_row(line, &row) && vpp_tok_has(row.name, '.'))
+      cli_expand_add(commands, helptexts, row.name, row.state);
   }
 
-  /* Also list parent interfaces that can have sub-interfaces */
-  if (vpp_exec("show interface", output, sizeof(output)) == 0) {
-    char *saveptr2 = NULL;
-    char *line2 = strtok_r(output, "\r\n", &saveptr2);
-
-    if (line2)
-      line2 = strtok_r(NULL, "\r\n", &saveptr2);
-
-    while (line2) {
-      char ifname[64];
-      int idx;
-      char state[16];
-
-      if (sscanf(line2, "%63s %d %15s", ifname, &idx, state) >= 2) {
-        /* Parent candidates: ethernet or bond interfaces without '.' */
-        if (!strchr(ifname, '.') && strcmp(ifname, "local0") != 0 &&
-            strncmp(ifname, "tap", 3) != 0 && strncmp(ifname, "loop", 4) != 0) {
-          char suggestion[80];
-          snprintf(suggestion, sizeof(suggestion), "%s.", ifname);
-          cg_var *cv = cvec_add(commands, CGV_STRING);
-          if (cv)
-            cv_string_set(cv, suggestion);
-          cv = cvec_add(helptexts, CGV_STRING);
-          if (cv)
-            cv_string_set(cv, "(add VLAN ID)");
-        }
-      }
-      line2 = strtok_r(NULL, "\r\n", &saveptr2);
-    }
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    char suggestion[80];
+
+    if (!vpp_tok_show_interface_row(line, &row) ||
+        vpp_tok_has(row.name, '.') || vpp_tok_eq(row.name, "local0") ||
+        vpp_tok_prefix(row.name, "tap") || vpp_tok_prefix(row.name, "loop"))
+      continue;
+    snprintf(suggestion, sizeof(suggestion), "%.*s.", (int)row.name.len,
+             row.name.ptr);
+    cli_expand_add(commands, helptexts,
+                   (vpp_slice_t){suggestion, strlen(suggestion)}, add_vlan);
   }
 
   return 0;
@@ -2049,91 +1977,80 @@ static void ds_sync_bonds_from_vpp(void) {
       if (vpp_exec("show bond", output, sizeof(output)) != 0)
         return;
 
-      char *saveptr = NULL;
-      char *line = strtok_r(output, "\r\n", &saveptr);
-      if (line)
-        line = strtok_r(NULL, "\r\n", &saveptr);
-
-      while (line) {
-        char ifname[64];
-        int sw_if_idx;
-        char mode[32];
-        char lb[16];
-        int active, members;
-
-        if (sscanf(line, "%63s %d %31s %15s %d %d", ifname, &sw_if_idx, mode,
-                   lb, &active, &members) >= 4) {
-          if (strncmp(ifname, "BondEthernet", 12) == 0) {
-            bond_config_t *bcfg = calloc(1, sizeof(bond_config_t));
-            if (bcfg) {
-              strncpy(bcfg->name, ifname, sizeof(bcfg->name) - 1);
-              strncpy(bcfg->mode, mode, sizeof(bcfg->mode) - 1);
-              strncpy(bcfg->lb, lb, sizeof(bcfg->lb) - 1);
-              bcfg->id = atoi(ifname + 12);
-              bcfg->next = pending_bonds;
-              pending_bonds = bcfg;
-            }
-          }
+      vpp_tok_t tok;
+      vpp_slice_t line;
+
+      /* name sw_if_index mode load-balance active members */
+      vpp_tok_init_str(&tok, output);
+      while (vpp_tok_line(&tok, &line)) {
+        vpp_slice_t f[4];
+        size_t n = 0;
+
+        while (n < 4 && vpp_tok_field(&line, &f[n]))
+          n++;
+        if (n < 4 || !vpp_tok_prefix(f[0], "BondEthernet"))
+          continue;
+
+        bond_config_t *bcfg = calloc(1, sizeof(bond_config_t));
+        if (bcfg) {
+          vpp_tok_copy(f[0], bcfg->name, sizeof(bcfg->name));
+          vpp_tok_copy(f[2], bcfg->mode, sizeof(bcfg->mode));
+          vpp_tok_copy(f[3], bcfg->lb, sizeof(bcfg->lb));
+          bcfg->id = atoi(bcfg->name + 12);
+          bcfg->next = pending_bonds;
+          pending_bonds = bcfg;
         }
-        line = strtok_r(NULL, "\r\n", &saveptr);
       }
       return;
     }
   }
 
   /* Use VPP API to get bonds */
-  vpp_bond_info_t bonds[32];
-  int count = vpp_api_get_bonds(bonds, 32);
+  vpp_api_set_t *bonds = vpp_api_get_bonds();
+  vpp_api_iter_t it = vpp_api_iter(bonds);
+  const vpp_bond_info_t *bond;
 
-  for (int i = 0; i < count; i++) {
+  while ((bond = vpp_api_iter_next(&it))) {
     bond_config_t *bcfg = calloc(1, sizeof(bond_config_t));
     if (bcfg) {
-      strncpy(bcfg->name, bonds[i].name, sizeof(bcfg->name) - 1);
-      strncpy(bcfg->mode, vpp_bond_mode_str(bonds[i].mode),
+      strncpy(bcfg->name, bond->name, sizeof(bcfg->name) - 1);
+      strncpy(bcfg->mode, vpp_bond_mode_str(bond->mode),
               sizeof(bcfg->mode) - 1);
-      strncpy(bcfg->lb, vpp_lb_mode_str(bonds[i].lb), sizeof(bcfg->lb) - 1);
-      bcfg->id = bonds[i].id;
+      strncpy(bcfg->lb, vpp_lb_mode_str(bond->lb), sizeof(bcfg->lb) - 1);
+      bcfg->id = bond->id;
       bcfg->next = pending_bonds;
       pending_bonds = bcfg;
     }
   }
+  vpp_api_set_free(bonds);
 
   /* Get members for each bond */
   char output[8192];
   if (vpp_exec("show bond details", output, sizeof(output)) == 0) {
     bond_config_t *bcfg = NULL;
-    char *saveptr = NULL;
-    char *line = strtok_r(output, "\r\n", &saveptr);
+    vpp_tok_t tok;
+    vpp_slice_t line;
+
+    vpp_tok_init_str(&tok, output);
+    while (vpp_tok_line(&tok, &line)) {
+      size_t indent = vpp_tok_indent(line);
+      vpp_slice_t word;
 
-    while (line) {
-      char bondname[64];
+      if (!vpp_tok_field(&line, &word))
+        continue;
       /* Check for bond name line */
-      if (sscanf(line, "%63s", bondname) == 1 &&
-          strncmp(bondname, "BondEthernet", 12) == 0) {
+      if (indent == 0 && vpp_tok_prefix(word, "BondEthernet")) {
         /* Find this bond in our list */
         bcfg = pending_bonds;
-        while (bcfg) {
-          if (strcmp(bcfg->name, bondname) == 0)
-            break;
+        while (bcfg && !vpp_tok_eq(word, bcfg->name))
           bcfg = bcfg->next;
-        }
       }
-      /* Check for member lines (indented with spaces, starts with interface
-         name) */
-      else if (bcfg && line[0] == ' ' && line[1] == ' ' && line[2] == ' ' &&
-               line[3] == ' ' &&
-               (strstr(line, "Ethernet") || strstr(line, "Gigabit"))) {
-        char member[64];
-        if (sscanf(line, " %63s", member) == 1 && strstr(member, "Ethernet")) {
-          if (bcfg->members[0]) {
-            strncat(bcfg->members, ",",
-                    sizeof(bcfg->members) - strlen(bcfg->members) - 1);
-          }
-          strncat(bcfg->members, member,
-                  sizeof(bcfg->members) - strlen(bcfg->members) - 1);
-        }
+      /* Member lines are indented further and name an interface */
+      else if (bcfg && indent >= 4 && vpp_tok_find(word, "Ethernet")) {
+        size_t len = strlen(bcfg->members);
+        snprintf(bcfg->members + len, sizeof(bcfg->members) - len, "%s%.*s",
+                 len ? "," : "", (int)word.len, word.ptr);
       }
-      line = strtok_r(NULL, "\r\n", &saveptr);
     }
   }
 }
@@ -2142,24 +2059,27 @@ static void ds_sync_bonds_from_vpp(void) {
 static void ds_sync_lcps_from_vpp(void) {
   /* Try VPP API first */
   if (vpp_api_is_connected()) {
-    vpp_lcp_info_t lcps[64];
-    int count = vpp_api_get_lcps(lcps, 64);
+    vpp_api_set_t *lcps = vpp_api_get_lcps();
+    vpp_api_iter_t it = vpp_api_iter(lcps);
+    const vpp_lcp_info_t *lcp;
 
-    if (count > 0) {
-      for (int i = 0; i < count; i++) {
+    if (lcps && lcps->count > 0) {
+      while ((lcp = vpp_api_iter_next(&it))) {
         lcp_config_t *lcfg = calloc(1, sizeof(lcp_config_t));
         if (lcfg) {
-          strncpy(lcfg->vpp_if, lcps[i].vpp_if, sizeof(lcfg->vpp_if) - 1);
-          strncpy(lcfg->host_if, lcps[i].host_if, sizeof(lcfg->host_if) - 1);
-          if (lcps[i].netns[0])
-            strncpy(lcfg->netns, lcps[i].netns, sizeof(lcfg->netns) - 1);
+          strncpy(lcfg->vpp_if, lcp->vpp_if, sizeof(lcfg->vpp_if) - 1);
+          strncpy(lcfg->host_if, lcp->host_if, sizeof(lcfg->host_if) - 1);
+          if (lcp->netns[0])
+            strncpy(lcfg->netns, lcp->netns, sizeof(lcfg->netns) - 1);
           lcfg->next = pending_lcps;
           pending_lcps = lcfg;
         }
       }
+      vpp_api_set_free(lcps);
       return;
     }
-    /* If count is 0 or negative, fall through to CLI parsing */
+    /* If there are none or VPP cannot be read, fall through to CLI parsing */
+    vpp_api_set_free(lcps);
   }
 
   /* Fall back to CLI parsing */
@@ -2167,132 +2087,108 @@ static void ds_sync_lcps_from_vpp(void) {
   if (vpp_exec("show lcp", output, sizeof(output)) != 0)
     return;
 
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
-  while (line) {
-    /* Format: itf-pair: [N] vpp_if tap_if host_if idx type tap netns name */
-    if (strncmp(line, "itf-pair:", 9) == 0) {
-      int idx, host_sw;
-      char vpp_if[128], tap_if[64], host_if[64], type[16], netns[64];
-
-      /* Parse: itf-pair: [0] BondEthernet10 tap4096 bond10 11 type tap netns
-       * dataplane */
-      if (sscanf(line, "itf-pair: [%d] %127s %63s %63s %d type %15s netns %63s",
-                 &idx, vpp_if, tap_if, host_if, &host_sw, type, netns) >= 6) {
-        lcp_config_t *lcfg = calloc(1, sizeof(lcp_config_t));
-        if (lcfg) {
-          strncpy(lcfg->vpp_if, vpp_if, sizeof(lcfg->vpp_if) - 1);
-          strncpy(lcfg->host_if, host_if, sizeof(lcfg->host_if) - 1);
-          strncpy(lcfg->netns, netns, sizeof(lcfg->netns) - 1);
-          lcfg->next = pending_lcps;
-          pending_lcps = lcfg;
-        }
-      }
+  vpp_tok_t tok;
+  vpp_slice_t line;
+
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    /* Format: itf-pair: [N] vpp_if tap_if host_if idx type tap netns name
+     * e.g. itf-pair: [0] BondEthernet10 tap4096 bond10 11 type tap netns
+     * dataplane */
+    vpp_slice_t f[9];
+    size_t n = 0;
+
+    if (!vpp_tok_skip(&line, "itf-pair:"))
+      continue;
+    while (n < 9 && vpp_tok_field(&line, &f[n]))
+      n++;
+    if (n < 7 || !vpp_tok_eq(f[5], "type"))
+      continue;
+
+    lcp_config_t *lcfg = calloc(1, sizeof(lcp_config_t));
+    if (lcfg) {
+      vpp_tok_copy(f[1], lcfg->vpp_if, sizeof(lcfg->vpp_if));
+      vpp_tok_copy(f[3], lcfg->host_if, sizeof(lcfg->host_if));
+      if (n == 9 && vpp_tok_eq(f[7], "netns"))
+        vpp_tok_copy(f[8], lcfg->netns, sizeof(lcfg->netns));
+      lcfg->next = pending_lcps;
+      pending_lcps = lcfg;
     }
-    line = strtok_r(NULL, "\r\n", &saveptr);
   }
 }
 
 /* Helper: Sync interfaces from VPP (admin state, MTU, IP addresses) */
 static void ds_sync_interfaces_from_vpp(void) {
   char output[16384];
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
+  pending_config_t *cfg = NULL;
 
-  /* Get interface list with state */
+  /* Get interface list with state and MTU */
   if (vpp_exec("show interface", output, sizeof(output)) != 0)
     return;
 
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
-  /* Skip header */
-  if (line)
-    line = strtok_r(NULL, "\r\n", &saveptr);
-
-  while (line) {
-    char ifname[128];
-    int idx;
-    char state[16];
-
-    if (sscanf(line, "%127s %d %15s", ifname, &idx, state) >= 2) {
-      /* Skip local0, tap interfaces without LCP */
-      if (strcmp(ifname, "local0") != 0 &&
-          (strstr(ifname, "Ethernet") || strstr(ifname, "Bond") ||
-           strncmp(ifname, "loop", 4) == 0)) {
-
-        pending_config_t *cfg = calloc(1, sizeof(pending_config_t));
-        if (cfg) {
-          strncpy(cfg->ifname, ifname, sizeof(cfg->ifname) - 1);
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (!vpp_tok_show_interface_row(line, &row))
+      continue;
+    /* Skip local0, tap interfaces without LCP */
+    if (vpp_tok_eq(row.name, "local0") ||
+        !(vpp_tok_find(row.name, "Ethernet") ||
+          vpp_tok_find(row.name, "Bond") || vpp_tok_prefix(row.name, "loop")))
+      continue;
 
-          /* Check if admin up */
-          if (strcmp(state, "up") == 0) {
-            strncpy(cfg->enabled, "true", sizeof(cfg->enabled) - 1);
-          }
+    cfg = calloc(1, sizeof(pending_config_t));
+    if (cfg) {
+      vpp_tok_copy(row.name, cfg->ifname, sizeof(cfg->ifname));
 
-          cfg->next = pending_interfaces;
-          pending_interfaces = cfg;
-        }
+      /* Check if admin up */
+      if (vpp_tok_eq(row.state, "up")) {
+        strncpy(cfg->enabled, "true", sizeof(cfg->enabled) - 1);
       }
-    }
-    line = strtok_r(NULL, "\r\n", &saveptr);
-  }
-
-  /* Get IP addresses for each interface */
-  pending_config_t *cfg = pending_interfaces;
-  while (cfg) {
-    char cmd[256];
-    snprintf(cmd, sizeof(cmd), "show interface %s addr", cfg->ifname);
-
-    if (vpp_exec(cmd, output, sizeof(output)) == 0) {
-      char *ip_line = strtok(output, "\r\n");
-      while (ip_line) {
-        /* Look for IPv4 addresses */
-        char *ipv4 = strstr(ip_line, "L3 ");
-        if (ipv4) {
-          char addr[64];
-          int prefix;
-          if (sscanf(ipv4, "L3 %63[^/]/%d", addr, &prefix) == 2) {
-            if (strchr(addr, ':') == NULL) { /* IPv4 */
-              strncpy(cfg->ipv4_addr, addr, sizeof(cfg->ipv4_addr) - 1);
-              cfg->ipv4_prefix = prefix;
-            } else { /* IPv6 */
-              strncpy(cfg->ipv6_addr, addr, sizeof(cfg->ipv6_addr) - 1);
-              cfg->ipv6_prefix = prefix;
-            }
-          }
-        }
-        ip_line = strtok(NULL, "\r\n");
+      if (row.mtu > 0 && row.mtu != 9000) { /* Skip default MTU */
+        snprintf(cfg->mtu, sizeof(cfg->mtu), "%u", row.mtu);
       }
+
+      cfg->next = pending_interfaces;
+      pending_interfaces = cfg;
     }
-    cfg = cfg->next;
   }
 
-  /* Get MTU for each interface */
-  cfg = pending_interfaces;
-  while (cfg) {
-    char cmd[256];
-    snprintf(cmd, sizeof(cmd), "show hardware-interfaces %s", cfg->ifname);
-
-    if (vpp_exec(cmd, output, sizeof(output)) == 0) {
-      /* Parse MTU from output - look for "mtu XXXX" */
-      char *mtu_str = strstr(output, "Ethernet address");
-      if (mtu_str) {
-        /* Skip to next line and look for link mtu */
-        mtu_str = strstr(output, "link mtu");
-        if (!mtu_str)
-          mtu_str = strstr(output, "mtu ");
-        if (mtu_str) {
-          int mtu_val;
-          if (sscanf(mtu_str, "link mtu %d", &mtu_val) == 1 ||
-              sscanf(mtu_str, "mtu %d", &mtu_val) == 1) {
-            if (mtu_val > 0 && mtu_val != 9000) { /* Skip default MTU */
-              snprintf(cfg->mtu, sizeof(cfg->mtu), "%d", mtu_val);
-            }
-          }
-        }
-      }
+  /* IP addresses of all interfaces, one call:
+   *   BondEthernet0.100 (up):
+   *     L3 10.0.0.1/24
+   */
+  if (vpp_exec("show interface addr", output, sizeof(output)) != 0)
+    return;
+
+  cfg = NULL;
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    vpp_slice_t word;
+    vpp_slice_t addr;
+    vpp_slice_t len;
+    uint32_t prefix;
+
+    if (line.len > 0 && vpp_tok_indent(line) == 0) {
+      vpp_tok_field(&line, &word);
+      cfg = pending_interfaces;
+      while (cfg && !vpp_tok_eq(word, cfg->ifname))
+        cfg = cfg->next;
+      continue;
+    }
+    if (!cfg || !vpp_tok_field(&line, &word) || !vpp_tok_eq(word, "L3") ||
+        !vpp_tok_field(&line, &word) ||
+        !vpp_tok_split(word, '/', &addr, &len) || !vpp_tok_u32(len, &prefix))
+      continue;
+    if (!vpp_tok_has(addr, ':')) { /* IPv4 */
+      vpp_tok_copy(addr, cfg->ipv4_addr, sizeof(cfg->ipv4_addr));
+      cfg->ipv4_prefix = (int)prefix;
+    } else { /* IPv6 */
+      vpp_tok_copy(addr, cfg->ipv6_addr, sizeof(cfg->ipv6_addr));
+      cfg->ipv6_prefix = (int)prefix;
     }
-    cfg = cfg->next;
   }
 }
 
@@ -2636,6 +2532,16 @@ int cli_no_interface(clixon_handle h, cvec *cvv, cvec *argv) {
  * SHOW COMMANDS - Cisco-style formatted output
  *=============================================================*/
 
+/* One row of "show interfaces" */
+static void show_interfaces_row(const char *ifname, bool up,
+                                const char *ip_list) {
+  const char *state = up ? "up" : "down";
+
+  if (ifname[0] != '\0')
+    fprintf(stdout, "%-35s %-12s %-8s %s\n", ifname, state, state,
+            ip_list[0] ? ip_list : "-");
+}
+
 /* Parse and format interface status in Cisco style */
 int cli_show_interfaces(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)h;
@@ -2643,6 +2549,8 @@ int cli_show_interfaces(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)argv;
 
   char addr_output[16384];
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
   /* Use show interface addr as primary source - cleaner format */
   if (vpp_exec("show interface addr", addr_output, sizeof(addr_output)) != 0) {
@@ -2657,99 +2565,68 @@ int cli_show_interfaces(clixon_handle h, cvec *cvv, cvec *argv) {
   fprintf(stdout, "============================================================"
                   "====================\n");
 
-  /* Make a copy for parsing */
-  char *output_copy = strdup(addr_output);
-  if (!output_copy)
-    return -1;
-
   /* Parse each line - format: "ifname (up):" or "ifname (dn):" or "  L3
    * ip/prefix" */
-  /* Note: VPP uses CRLF line endings, so tokenize on both \r and \n */
-  char *saveptr = NULL;
-  char *line = strtok_r(output_copy, "\r\n", &saveptr);
-
   char current_if[64] = "";
-  char current_state[16] = "";
+  bool current_up = false;
   char ip_list[256] = "";
-  int first_ip = 1;
 
-  while (line) {
-    /* Check if this is an interface line (starts with non-space, contains "(")
-     */
-    if (line[0] != ' ' && line[0] != '\t' && strchr(line, '(') != NULL) {
+  vpp_tok_init_str(&tok, addr_output);
+  while (vpp_tok_line(&tok, &line)) {
+    vpp_slice_t name;
+    vpp_slice_t state;
+    vpp_slice_t ip = line;
+
+    if (line.len > 0 && vpp_tok_indent(line) == 0 &&
+        vpp_tok_split(line, '(', &name, &state)) {
       /* Print previous interface if any */
-      if (current_if[0] != '\0') {
-        if (ip_list[0] == '\0')
-          strcpy(ip_list, "-");
-        const char *admin = (strcmp(current_state, "up") == 0) ? "up" : "down";
-        const char *link = (strcmp(current_state, "up") == 0) ? "up" : "down";
-        fprintf(stdout, "%-35s %-12s %-8s %s\n", current_if, admin, link,
-                ip_list);
-      }
+      show_interfaces_row(current_if, current_up, ip_list);
 
-      /* Parse new interface: "ifname (up):" or "ifname (dn):" */
-      /* Find the space before ( */
-      char *paren = strchr(line, '(');
-      if (paren && paren > line) {
-        /* Copy interface name (everything before the space before paren) */
-        size_t name_len = paren - line;
-        /* Trim trailing space */
-        while (name_len > 0 && line[name_len - 1] == ' ') {
-          name_len--;
-        }
-        if (name_len > 0 && name_len < sizeof(current_if)) {
-          strncpy(current_if, line, name_len);
-          current_if[name_len] = '\0';
-
-          /* Get state (up or dn) */
-          char *state_start = paren + 1;
-          if (strncmp(state_start, "up", 2) == 0) {
-            strcpy(current_state, "up");
-          } else {
-            strcpy(current_state, "down");
-          }
-        } else {
-          current_if[0] = '\0';
-        }
-      } else {
+      name = vpp_tok_trim(name);
+      if (name.len > 0 && name.len < sizeof(current_if))
+        vpp_tok_copy(name, current_if, sizeof(current_if));
+      else
         current_if[0] = '\0';
-      }
+      current_up = vpp_tok_prefix(state, "up");
       ip_list[0] = '\0';
-      first_ip = 1;
-
-    } else if (strncmp(line, "  L3 ", 5) == 0) {
-      /* This is an IP address line */
-      char *ip = line + 5;
-      if (first_ip) {
-        strncpy(ip_list, ip, sizeof(ip_list) - 1);
-        first_ip = 0;
-      } else {
-        /* Append with comma */
-        size_t len = strlen(ip_list);
-        if (len + strlen(ip) + 3 < sizeof(ip_list)) {
-          strcat(ip_list, ", ");
-          strcat(ip_list, ip);
-        }
-      }
+    } else if (vpp_tok_skip(&ip, "  L3 ")) {
+      /* This is an IP address line, append with comma */
+      size_t len = strlen(ip_list);
+
+      ip = vpp_tok_trim(ip);
+      if (len == 0)
+        vpp_tok_copy(ip, ip_list, sizeof(ip_list));
+      else if (len + ip.len + 3 < sizeof(ip_list))
+        snprintf(ip_list + len, sizeof(ip_list) - len, ", %.*s", (int)ip.len,
+                 ip.ptr);
     }
-
-    line = strtok_r(NULL, "\r\n", &saveptr);
   }
 
   /* Print last interface */
-  if (current_if[0] != '\0') {
-    if (ip_list[0] == '\0')
-      strcpy(ip_list, "-");
-    const char *admin = (strcmp(current_state, "up") == 0) ? "up" : "down";
-    const char *link = (strcmp(current_state, "up") == 0) ? "up" : "down";
-    fprintf(stdout, "%-35s %-12s %-8s %s\n", current_if, admin, link, ip_list);
-  }
+  show_interfaces_row(current_if, current_up, ip_list);
 
-  free(output_copy);
   fprintf(stdout, "\n");
   return 0;
 }
 
+/* Counter after its label in "show interface", e.g. "rx packets  1234" */
+static bool show_counter(vpp_slice_t line, const char *label,
+                         unsigned long long *val) {
+  const char *p = vpp_tok_find(line, label);
+  vpp_slice_t rest;
+  vpp_slice_t num;
+  uint64_t v;
+
+  if (!p)
+    return false;
+  rest.ptr = p + strlen(label);
+  rest.len = line.len - (size_t)(rest.ptr - line.ptr);
+  if (!vpp_tok_field(&rest, &num) || !vpp_tok_u64(&num, &v))
+    return false;
+  *val = v;
+  return true;
+}
+
 /* Show interface detail - detailed info for single interface */
 int cli_show_interface_detail(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)h;
@@ -2764,6 +2641,8 @@ int cli_show_interface_detail(clixon_handle h, cvec *cvv, cvec *argv) {
   const char *ifname = cv_string_get(cv);
   char cmd[256];
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
   /* Get detailed interface info */
   snprintf(cmd, sizeof(cmd), "show interface %s", ifname);
@@ -2778,96 +2657,66 @@ int cli_show_interface_detail(clixon_handle h, cvec *cvv, cvec *argv) {
                   "====================\n");
 
   /* Parse the raw output for key values */
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
   char state[16] = "unknown";
   char mtu_str[64] = "-";
-  int rx_packets = 0, tx_packets = 0;
-  long long rx_bytes = 0, tx_bytes = 0;
-  int drops = 0;
-
-  while (line) {
-    /* First line usually has: Name Idx State MTU */
-    int idx = 0;
-    int mtu = 0;
-    char name[64];
-    if (sscanf(line, "%63s %d %15s %d", name, &idx, state, &mtu) >= 4) {
-      if (strcmp(name, ifname) == 0) {
-        snprintf(mtu_str, sizeof(mtu_str), "%d", mtu);
-      }
+  unsigned long long rx_packets = 0, tx_packets = 0;
+  unsigned long long rx_bytes = 0, tx_bytes = 0;
+  unsigned long long drops = 0;
+
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    /* First line has: Name Idx State MTU, then the counters */
+    vpp_tok_ifrow_t row;
+
+    if (vpp_tok_show_interface_row(line, &row) &&
+        vpp_tok_eq(row.name, ifname)) {
+      vpp_tok_copy(row.state, state, sizeof(state));
+      snprintf(mtu_str, sizeof(mtu_str), "%u", row.mtu);
     }
 
     /* Parse counters */
-    if (strstr(line, "rx packets")) {
-      sscanf(line, " rx packets %d", &rx_packets);
-    } else if (strstr(line, "tx packets")) {
-      sscanf(line, " tx packets %d", &tx_packets);
-    } else if (strstr(line, "rx bytes")) {
-      sscanf(line, " rx bytes %lld", &rx_bytes);
-    } else if (strstr(line, "tx bytes")) {
-      sscanf(line, " tx bytes %lld", &tx_bytes);
-    } else if (strstr(line, "drops")) {
-      sscanf(line, " drops %d", &drops);
-    }
-
-    line = strtok_r(NULL, "\r\n", &saveptr);
+    if (!show_counter(line, "rx packets", &rx_packets) &&
+        !show_counter(line, "tx packets", &tx_packets) &&
+        !show_counter(line, "rx bytes", &rx_bytes) &&
+        !show_counter(line, "tx bytes", &tx_bytes))
+      show_counter(line, "drops", &drops);
   }
 
   /* Get hardware info */
   char hw_output[4096];
   snprintf(cmd, sizeof(cmd), "show hardware-interfaces %s", ifname);
-  vpp_exec(cmd, hw_output, sizeof(hw_output));
+  if (vpp_exec(cmd, hw_output, sizeof(hw_output)) != 0)
+    hw_output[0] = '\0';
 
   /* Parse hardware info for MAC and speed */
   char mac[32] = "-";
   char speed[64] = "-";
   char driver[128] = "-";
 
-  saveptr = NULL;
-  line = strtok_r(hw_output, "\r\n", &saveptr);
-  while (line) {
-    /* Look for Ethernet address */
-    char *eth = strstr(line, "Ethernet address ");
-    if (eth) {
-      sscanf(eth, "Ethernet address %31s", mac);
-    }
-
-    /* Look for link speed - format: "Link speed: 100 Gbps" */
-    char *spd = strstr(line, "Link speed:");
-    if (spd) {
-      /* Copy rest of line after "Link speed:" */
-      char *speed_val = spd + 12; /* skip "Link speed: " */
-      /* Trim leading space */
-      while (*speed_val == ' ')
-        speed_val++;
-      strncpy(speed, speed_val, sizeof(speed) - 1);
-      /* Remove trailing whitespace */
-      char *end = speed + strlen(speed) - 1;
-      while (end > speed && (*end == ' ' || *end == '\r' || *end == '\n')) {
-        *end = '\0';
-        end--;
-      }
-    }
-
-    /* Look for driver - typically a line with just the driver name like
-     * "Mellanox ConnectX..." */
-    if (strstr(line, "Mellanox") || strstr(line, "Intel") ||
-        strstr(line, "Amazon") || strstr(line, "Virtio")) {
-      /* Trim leading spaces */
-      char *drv = line;
-      while (*drv == ' ')
-        drv++;
-      strncpy(driver, drv, sizeof(driver) - 1);
+  vpp_tok_init_str(&tok, hw_output);
+  while (vpp_tok_line(&tok, &line)) {
+    vpp_slice_t rest = vpp_tok_trim(line);
+    vpp_slice_t word;
+
+    if (vpp_tok_skip(&rest, "Ethernet address ")) {
+      /* Look for Ethernet address */
+      if (vpp_tok_field(&rest, &word))
+        vpp_tok_copy(word, mac, sizeof(mac));
+    } else if (vpp_tok_skip(&rest, "Link speed:")) {
+      /* Format: "Link speed: 100 Gbps" */
+      vpp_tok_copy(vpp_tok_trim(rest), speed, sizeof(speed));
+    } else if (vpp_tok_find(rest, "Mellanox") || vpp_tok_find(rest, "Intel") ||
+               vpp_tok_find(rest, "Amazon") || vpp_tok_find(rest, "Virtio")) {
+      /* Driver - a line with just the driver name like "Mellanox ConnectX..." */
+      vpp_tok_copy(rest, driver, sizeof(driver));
     }
-
-    line = strtok_r(NULL, "\r\n", &saveptr);
   }
 
   /* Get IP addresses */
   char addr_output[2048];
   snprintf(cmd, sizeof(cmd), "show interface addr %s", ifname);
-  vpp_exec(cmd, addr_output, sizeof(addr_output));
+  if (vpp_exec(cmd, addr_output, sizeof(addr_output)) != 0)
+    addr_output[0] = '\0';
 
   /* Print formatted output */
   fprintf(stdout, "  Status:           %s\n", state);
@@ -2879,15 +2728,13 @@ int cli_show_interface_detail(clixon_handle h, cvec *cvv, cvec *argv) {
 
   /* Print IP addresses */
   fprintf(stdout, "  IP Addresses:\n");
-  saveptr = NULL;
-  line = strtok_r(addr_output, "\r\n", &saveptr);
   int found_ip = 0;
-  while (line) {
-    if (strncmp(line, "  L3 ", 5) == 0) {
-      fprintf(stdout, "    - %s\n", line + 5);
+  vpp_tok_init_str(&tok, addr_output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (vpp_tok_skip(&line, "  L3 ")) {
+      fprintf(stdout, "    - %.*s\n", (int)line.len, line.ptr);
       found_ip = 1;
     }
-    line = strtok_r(NULL, "\r\n", &saveptr);
   }
   if (!found_ip) {
     fprintf(stdout, "    (none)\n");
@@ -2895,11 +2742,11 @@ int cli_show_interface_detail(clixon_handle h, cvec *cvv, cvec *argv) {
 
   fprintf(stdout, "\n");
   fprintf(stdout, "  Statistics:\n");
-  fprintf(stdout, "    RX packets:     %d\n", rx_packets);
-  fprintf(stdout, "    RX bytes:       %lld\n", rx_bytes);
-  fprintf(stdout, "    TX packets:     %d\n", tx_packets);
-  fprintf(stdout, "    TX bytes:       %lld\n", tx_bytes);
-  fprintf(stdout, "    Drops:          %d\n", drops);
+  fprintf(stdout, "    RX packets:     %llu\n", rx_packets);
+  fprintf(stdout, "    RX bytes:       %llu\n", rx_bytes);
+  fprintf(stdout, "    TX packets:     %llu\n", tx_packets);
+  fprintf(stdout, "    TX bytes:       %llu\n", tx_bytes);
+  fprintf(stdout, "    Drops:          %llu\n", drops);
   fprintf(stdout, "\n");
 
   return 0;
@@ -2912,6 +2759,9 @@ int cli_show_interfaces_brief(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)argv;
 
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
   if (vpp_exec("show interface", output, sizeof(output)) != 0) {
     return -1;
@@ -2921,24 +2771,33 @@ int cli_show_interfaces_brief(clixon_handle h, cvec *cvv, cvec *argv) {
   fprintf(stdout, "%-40s %-6s %-10s\n", "Interface", "Index", "Status");
   fprintf(stdout, "--------------------------------------------------------\n");
 
-  char *line = strtok(output, "\n");
-  while (line) {
-    char name[64] = "";
-    int idx = 0;
-    char state[16] = "";
-
-    if (sscanf(line, "%63s %d %15s", name, &idx, state) >= 3) {
-      if (name[0] >= 'A' && name[0] <= 'z' && strcmp(name, "Name") != 0) {
-        fprintf(stdout, "%-40s %-6d %-10s\n", name, idx, state);
-      }
-    }
-    line = strtok(NULL, "\n");
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (vpp_tok_show_interface_row(line, &row) && row.state.len > 0)
+      fprintf(stdout, "%-40.*s %-6u %-10.*s\n", (int)row.name.len,
+              row.name.ptr, row.sw_if_index, (int)row.state.len,
+              row.state.ptr);
   }
 
   fprintf(stdout, "\n");
   return 0;
 }
 
+/* One bond of "show bond" */
+static void show_bond_print(const char *bond, const char *mode, const char *lb,
+                            uint32_t members, uint32_t active,
+                            const char *member_list) {
+  if (bond[0] == '\0')
+    return;
+  fprintf(stdout, "\n%s\n", bond);
+  fprintf(stdout, "  Mode:           %s\n", mode);
+  fprintf(stdout, "  Load Balance:   %s\n", lb);
+  fprintf(stdout, "  Members:        %u (Active: %u)\n", members, active);
+  if (member_list[0] != '\0') {
+    fprintf(stdout, "  Member List:    %s\n", member_list);
+  }
+}
+
 /* Show bond - Cisco style with member details */
 int cli_show_bond(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)h;
@@ -2946,6 +2805,8 @@ int cli_show_bond(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)argv;
 
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
   /* Use show bond details for more info */
   if (vpp_exec("show bond details", output, sizeof(output)) != 0) {
@@ -2958,70 +2819,53 @@ int cli_show_bond(clixon_handle h, cvec *cvv, cvec *argv) {
                   "====================\n");
 
   /* Parse bond details output */
-  char *saveptr = NULL;
-  char *line = strtok_r(output, "\r\n", &saveptr);
-
   char current_bond[32] = "";
   char mode[32] = "";
   char lb[32] = "";
-  int members = 0;
-  int active = 0;
+  uint32_t members = 0;
+  uint32_t active = 0;
   char member_list[512] = "";
 
-  while (line) {
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    size_t indent = vpp_tok_indent(line);
+    vpp_slice_t rest = vpp_tok_trim(line);
+    vpp_slice_t word;
+
     /* Check for bond interface name (starts with BondEthernet) */
-    if (strncmp(line, "BondEthernet", 12) == 0) {
+    if (vpp_tok_prefix(line, "BondEthernet")) {
       /* Print previous bond if any */
-      if (current_bond[0] != '\0') {
-        fprintf(stdout, "\n%s\n", current_bond);
-        fprintf(stdout, "  Mode:           %s\n", mode);
-        fprintf(stdout, "  Load Balance:   %s\n", lb);
-        fprintf(stdout, "  Members:        %d (Active: %d)\n", members, active);
-        if (member_list[0] != '\0') {
-          fprintf(stdout, "  Member List:    %s\n", member_list);
-        }
-      }
+      show_bond_print(current_bond, mode, lb, members, active, member_list);
 
-      strncpy(current_bond, line, sizeof(current_bond) - 1);
+      vpp_tok_field(&rest, &word);
+      vpp_tok_copy(word, current_bond, sizeof(current_bond));
       mode[0] = '\0';
       lb[0] = '\0';
       members = 0;
       active = 0;
       member_list[0] = '\0';
-
-    } else if (strstr(line, "mode:")) {
-      sscanf(line, "  mode: %31s", mode);
-    } else if (strstr(line, "load balance:")) {
-      sscanf(line, "  load balance: %31s", lb);
-    } else if (strstr(line, "number of members:")) {
-      sscanf(line, "  number of members: %d", &members);
-    } else if (strstr(line, "number of active members:")) {
-      sscanf(line, "  number of active members: %d", &active);
-    } else if (line[0] == ' ' && line[1] == ' ' && line[2] == ' ' &&
-               line[3] == ' ') {
+    } else if (vpp_tok_skip(&rest, "mode:")) {
+      if (vpp_tok_field(&rest, &word))
+        vpp_tok_copy(word, mode, sizeof(mode));
+    } else if (vpp_tok_skip(&rest, "load balance:")) {
+      if (vpp_tok_field(&rest, &word))
+        vpp_tok_copy(word, lb, sizeof(lb));
+    } else if (vpp_tok_skip(&rest, "number of members:")) {
+      if (vpp_tok_field(&rest, &word))
+        vpp_tok_u32(word, &members);
+    } else if (vpp_tok_skip(&rest, "number of active members:")) {
+      if (vpp_tok_field(&rest, &word))
+        vpp_tok_u32(word, &active);
+    } else if (indent >= 4 && rest.len > 0) {
       /* Member interface line (indented with 4 spaces) */
-      char *member = line + 4;
-      if (member_list[0] != '\0') {
-        strncat(member_list, ", ",
-                sizeof(member_list) - strlen(member_list) - 1);
-      }
-      strncat(member_list, member,
-              sizeof(member_list) - strlen(member_list) - 1);
+      size_t len = strlen(member_list);
+      snprintf(member_list + len, sizeof(member_list) - len, "%s%.*s",
+               len ? ", " : "", (int)rest.len, rest.ptr);
     }
-
-    line = strtok_r(NULL, "\r\n", &saveptr);
   }
 
   /* Print last bond */
-  if (current_bond[0] != '\0') {
-    fprintf(stdout, "\n%s\n", current_bond);
-    fprintf(stdout, "  Mode:           %s\n", mode);
-    fprintf(stdout, "  Load Balance:   %s\n", lb);
-    fprintf(stdout, "  Members:        %d (Active: %d)\n", members, active);
-    if (member_list[0] != '\0') {
-      fprintf(stdout, "  Member List:    %s\n", member_list);
-    }
-  }
+  show_bond_print(current_bond, mode, lb, members, active, member_list);
 
   fprintf(stdout, "\n");
   return 0;
@@ -3034,6 +2878,8 @@ int cli_show_lcp(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)argv;
 
   char output[4096];
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
   if (vpp_exec("show lcp", output, sizeof(output)) != 0) {
     return -1;
@@ -3048,33 +2894,107 @@ int cli_show_lcp(clixon_handle h, cvec *cvv, cvec *argv) {
   fprintf(stdout, "------------------------------------------------------------"
                   "--------------------\n");
 
-  /* Parse itf-pair lines */
-  char *line = strtok(output, "\n");
-  while (line) {
-    if (strstr(line, "itf-pair")) {
-      char vpp_if[64] = "";
-      char tap[16] = "";
-      char linux_if[32] = "";
-      int idx = 0;
-
-      /* Parse: itf-pair: [idx] vpp_if tap linux_if ... */
-      if (sscanf(line, "itf-pair: [%d] %63s %15s %31s", &idx, vpp_if, tap,
-                 linux_if) >= 4) {
-        const char *netns = strstr(line, "netns ");
-        char ns[32] = "default";
-        if (netns) {
-          sscanf(netns, "netns %31s", ns);
-        }
-        fprintf(stdout, "%-30s %-15s %-20s %s\n", vpp_if, tap, linux_if, ns);
-      }
+  /* Parse: itf-pair: [idx] vpp_if tap linux_if ... netns name */
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    vpp_slice_t f[4];
+    vpp_slice_t word;
+    vpp_slice_t ns = {"default", 7};
+    size_t n = 0;
+
+    if (!vpp_tok_skip(&line, "itf-pair:"))
+      continue;
+    while (n < 4 && vpp_tok_field(&line, &f[n]))
+      n++;
+    if (n < 4)
+      continue;
+    while (vpp_tok_field(&line, &word)) {
+      if (vpp_tok_eq(word, "netns") && vpp_tok_field(&line, &word))
+        ns = word;
     }
-    line = strtok(NULL, "\n");
+    fprintf(stdout, "%-30.*s %-15.*s %-20.*s %.*s\n", (int)f[1].len,
+            f[1].ptr, (int)f[2].len, f[2].ptr, (int)f[3].len, f[3].ptr,
+            (int)ns.len, ns.ptr);
   }
 
   fprintf(stdout, "\n");
   return 0;
 }
 
+/* Order verbs by number of calls, busiest first */
+static int transport_verb_cmp(const void *a, const void *b) {
+  const char *ca = xml_find_body(*(cxobj *const *)a, "calls");
+  const char *cb = xml_find_body(*(cxobj *const *)b, "calls");
+  unsigned long long na = ca ? strtoull(ca, NULL, 10) : 0;
+  unsigned long long nb = cb ? strtoull(cb, NULL, 10) : 0;
+
+  return na < nb ? 1 : na > nb ? -1 : 0;
+}
+
+/* Show VPP transport statistics - kept by the backend, read as state */
+int cli_show_transport_statistics(clixon_handle h, cvec *cvv, cvec *argv) {
+  (void)cvv;
+  (void)argv;
+
+  cvec *nsc = NULL;
+  cxobj *xt = NULL;
+  cxobj **vec = NULL;
+  size_t veclen = 0;
+  int ret = -1;
+
+  if ((nsc = xml_nsctx_init("vpp-if", VPP_INTERFACES_NS)) == NULL)
+    goto done;
+  if (clicon_rpc_get(h, "/vpp-if:transport-statistics", nsc, CONTENT_NONCONFIG,
+                     -1, NULL, &xt) < 0) {
+    fprintf(stderr, "Failed to read transport statistics from backend\n");
+    goto done;
+  }
+  if (xpath_first(xt, NULL, "/rpc-error") != NULL) {
+    fprintf(stderr, "Backend returned an error for transport statistics\n");
+    goto done;
+  }
+  if (xpath_vec(xt, nsc, "vpp-if:transport-statistics/vpp-if:verb", &vec,
+                &veclen) < 0)
+    goto done;
+  if (veclen > 1)
+    qsort(vec, veclen, sizeof(*vec), transport_verb_cmp);
+
+  fprintf(stdout, "\n");
+  fprintf(stdout, "VPP Transport Statistics\n");
+  fprintf(stdout, "============================================================"
+                  "====================\n");
+  fprintf(stdout, "%-30s %8s %6s %10s %7s %7s %7s\n", "Command", "Calls",
+          "Errors", "Bytes", "p50 us", "p99 us", "max us");
+  fprintf(stdout, "------------------------------------------------------------"
+                  "--------------------\n");
+  for (size_t i = 0; i < veclen; i++) {
+    const char *name = xml_find_body(vec[i], "name");
+    const char *calls = xml_find_body(vec[i], "calls");
+    const char *errors = xml_find_body(vec[i], "errors");
+    const char *bytes = xml_find_body(vec[i], "bytes-read");
+    const char *p50 = xml_find_body(vec[i], "p50-usec");
+    const char *p99 = xml_find_body(vec[i], "p99-usec");
+    const char *max = xml_find_body(vec[i], "max-usec");
+
+    fprintf(stdout, "%-30s %8s %6s %10s %7s %7s %7s\n", name ? name : "",
+            calls ? calls : "0", errors ? errors : "0", bytes ? bytes : "0",
+            p50 ? p50 : "0", p99 ? p99 : "0", max ? max : "0");
+  }
+  if (veclen == 0)
+    fprintf(stdout, "No commands sent to VPP yet\n");
+  fprintf(stdout, "\n");
+  ret = 0;
+
+done:
+  if (vec)
+    free(vec);
+  if (xt)
+    xml_free(xt);
+  if (nsc)
+    xml_nsctx_free(nsc);
+  return ret;
+}
+
 /* Show IP interface - IP address summary */
 int cli_show_ip_interface(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)h;
@@ -3082,6 +3002,8 @@ int cli_show_ip_interface(clixon_handle h, cvec *cvv, cvec *argv) {
   (void)argv;
 
   char output[8192];
+  vpp_tok_t tok;
+  vpp_slice_t line;
 
   if (vpp_exec("show interface addr", output, sizeof(output)) != 0) {
     return -1;
@@ -3095,34 +3017,29 @@ int cli_show_ip_interface(clixon_handle h, cvec *cvv, cvec *argv) {
   fprintf(stdout, "------------------------------------------------------------"
                   "--------------------\n");
 
-  char current_if[64] = "";
-  char *line = strtok(output, "\n");
-
-  while (line) {
-    /* Check if this is an interface line */
-    if (line[0] != ' ' && line[0] != '\t') {
-      char name[64] = "";
-      char state[16] = "";
-
-      if (sscanf(line, "%63s (%15[^)])", name, state) >= 1) {
-        strncpy(current_if, name, sizeof(current_if) - 1);
-        fprintf(stdout, "%-40s %-8s ", name, state);
-      }
-    } else if (strstr(line, "L3 ")) {
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    const char *ip;
+
+    if (line.len > 0 && vpp_tok_indent(line) == 0) {
+      /* Interface line: "name (state):" */
+      vpp_slice_t name;
+      vpp_slice_t state = {"", 0};
+      vpp_slice_t rest;
+
+      vpp_tok_field(&line, &name);
+      rest = vpp_tok_trim(line);
+      if (vpp_tok_skip(&rest, "("))
+        vpp_tok_split(rest, ')', &state, &rest);
+      fprintf(stdout, "%-40.*s %-8.*s ", (int)name.len, name.ptr,
+              (int)state.len, state.ptr);
+    } else if ((ip = vpp_tok_find(line, "L3 ")) != NULL) {
       /* This is an IP address line */
-      char *ip = strstr(line, "L3 ");
-      if (ip) {
-        ip += 3;
-        /* Remove trailing whitespace */
-        char *end = ip + strlen(ip) - 1;
-        while (end > ip && (*end == ' ' || *end == '\n')) {
-          *end = '\0';
-          end--;
-        }
-        fprintf(stdout, "%s\n", ip);
-      }
+      vpp_slice_t addr = {ip + 3, line.len - (size_t)(ip + 3 - line.ptr)};
+
+      addr = vpp_tok_trim(addr);
+      fprintf(stdout, "%.*s\n", (int)addr.len, addr.ptr);
     }
-    line = strtok(NULL, "\n");
   }
 
   fprintf(stdout, "\n");
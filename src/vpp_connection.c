@@ -1,124 +1,859 @@
 /*
- * vpp_connection.c - VPP connection management via vppctl
+ * vpp_connection.c - VPP connection management via the CLI socket
  *
- * Uses the vppctl command to communicate with VPP.
- * This is simpler and more reliable than using the raw CLI socket.
+ * Keeps a single persistent connection to VPP's CLI socket
+ * (/run/vpp/cli.sock) open for the lifetime of the process instead of
+ * spawning a vppctl process per command. The socket speaks a minimal
+ * telnet dialect: option negotiation is refused, the prompt is learned
+ * from the banner and used to frame each response, and the echoed
+ * command line is stripped before the output is handed back.
  */
 
+#define _GNU_SOURCE /* memmem */
+
 #include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "vpp_connection.h"
+#include "vpp_tstats.h"
 
 #define VPP_CLI_BUFSIZE 65536
-#define VPPCTL_PATH "/usr/bin/vppctl"
+#define VPP_CLI_PROMPT_MAX 32
+#define VPP_CLI_DEFAULT_PROMPT "vpp# "
+#define VPP_CLI_TIMEOUT_MS 30000 /* Per command, VPP_CLI_TIMEOUT_MS env */
+#define VPP_CLI_QUIET_MS 200     /* Idle time that ends the banner */
+#define VPP_CLI_PIPELINE_DEPTH 64 /* Commands in flight when pipelining */
+#define VPP_CLI_BATCH_MARK "@@clixon-vpp-batch "
+#define VPP_CLI_SESSIONS 4        /* Parallel sessions, VPP_CLI_SESSIONS env */
+
+/* Telnet protocol bytes (RFC 854) */
+#define TELNET_SE 240
+#define TELNET_SB 250
+#define TELNET_WILL 251
+#define TELNET_WONT 252
+#define TELNET_DO 253
+#define TELNET_DONT 254
+#define TELNET_IAC 255
+
+typedef enum {
+  TELNET_STATE_DATA,
+  TELNET_STATE_IAC,
+  TELNET_STATE_OPT,
+  TELNET_STATE_SB,
+  TELNET_STATE_SB_IAC,
+} telnet_state_t;
+
+/* One connection to the VPP CLI socket */
+typedef struct {
+  int fd;
+  telnet_state_t tstate;
+  unsigned char tverb;       /* WILL/WONT/DO/DONT awaiting its option */
+  char prompt[VPP_CLI_PROMPT_MAX];
+  size_t prompt_len;
+  char *buf;                 /* Cleaned (telnet-free, LF only) output */
+  size_t len;
+  size_t cap;
+  size_t scan;               /* Prompt search resumes here */
+} vpp_cli_session_t;
 
+static vpp_cli_session_t g_session = {.fd = -1};
+/* Written by the main thread only, read by the plan's worker threads too */
 static bool g_connected = false;
+static uint64_t g_epoch = 0; /* Bumped on every new session */
+static uint32_t g_pid = 0;   /* VPP's PID as of the last connect */
 
-int vpp_connect(void) {
-  /* Check if vppctl is available and VPP is running */
-  FILE *fp = popen(VPPCTL_PATH " show version 2>&1", "r");
-  if (!fp) {
-    fprintf(stderr, "[vpp] Failed to run vppctl: %s\n", strerror(errno));
+/* Extra sessions for parallel work, opened on demand; [0] is unused */
+static vpp_cli_session_t g_extra[VPP_CLI_MAX_SESSIONS] = {
+    [0 ... VPP_CLI_MAX_SESSIONS - 1] = {.fd = -1}};
+static uint64_t g_extra_epoch[VPP_CLI_MAX_SESSIONS];
+
+static const char *vpp_cli_socket_path(void) {
+  const char *path = getenv("VPP_CLI_SOCK");
+  return (path && *path) ? path : VPP_CLI_SOCKET;
+}
+
+static int vpp_cli_timeout_ms(void) {
+  const char *env = getenv("VPP_CLI_TIMEOUT_MS");
+  int ms = env ? atoi(env) : 0;
+  return ms > 0 ? ms : VPP_CLI_TIMEOUT_MS;
+}
+
+static long long now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int session_write(vpp_cli_session_t *s, const void *data, size_t len) {
+  const char *p = data;
+
+  while (len > 0) {
+    ssize_t n = send(s->fd, p, len, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+static int session_append(vpp_cli_session_t *s, char c) {
+  if (s->len + 1 >= s->cap) {
+    size_t cap = s->cap ? s->cap * 2 : VPP_CLI_BUFSIZE;
+    char *nbuf = realloc(s->buf, cap);
+    if (!nbuf)
+      return -1;
+    s->buf = nbuf;
+    s->cap = cap;
+  }
+  s->buf[s->len++] = c;
+  return 0;
+}
+
+/*
+ * Feed raw socket bytes through the telnet state machine.
+ * Option requests are refused, sub-negotiations dropped, CR removed
+ * and the remaining data appended to the session buffer.
+ */
+static int session_feed(vpp_cli_session_t *s, const unsigned char *data,
+                        size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = data[i];
+
+    switch (s->tstate) {
+    case TELNET_STATE_DATA:
+      if (c == TELNET_IAC)
+        s->tstate = TELNET_STATE_IAC;
+      else if (c != '\r' && c != '\0' && session_append(s, (char)c) < 0)
+        return -1;
+      break;
+    case TELNET_STATE_IAC:
+      if (c == TELNET_IAC) {
+        if (session_append(s, (char)c) < 0)
+          return -1;
+        s->tstate = TELNET_STATE_DATA;
+      } else if (c >= TELNET_WILL && c <= TELNET_DONT) {
+        s->tverb = c;
+        s->tstate = TELNET_STATE_OPT;
+      } else if (c == TELNET_SB) {
+        s->tstate = TELNET_STATE_SB;
+      } else {
+        s->tstate = TELNET_STATE_DATA;
+      }
+      break;
+    case TELNET_STATE_OPT: {
+      unsigned char reply[3] = {TELNET_IAC, 0, c};
+      if (s->tverb == TELNET_WILL)
+        reply[1] = TELNET_DONT;
+      else if (s->tverb == TELNET_DO)
+        reply[1] = TELNET_WONT;
+      if (reply[1] && session_write(s, reply, sizeof(reply)) < 0)
+        return -1;
+      s->tstate = TELNET_STATE_DATA;
+      break;
+    }
+    case TELNET_STATE_SB:
+      if (c == TELNET_IAC)
+        s->tstate = TELNET_STATE_SB_IAC;
+      break;
+    case TELNET_STATE_SB_IAC:
+      s->tstate = (c == TELNET_SE) ? TELNET_STATE_DATA : TELNET_STATE_SB;
+      break;
+    }
+  }
+  return 0;
+}
+
+/*
+ * Find the prompt that terminates the first reply in the buffer: at the
+ * very start or right after a newline. Returns its offset or -1. The
+ * scan position is remembered so pipelined reads stay linear.
+ */
+static ssize_t session_find_prompt(vpp_cli_session_t *s) {
+  size_t plen = s->prompt_len;
+  size_t i = s->scan;
+
+  if (plen == 0)
+    return -1;
+
+  while (i + plen <= s->len) {
+    char *p = memmem(s->buf + i, s->len - i, s->prompt, plen);
+    size_t off;
+
+    if (!p)
+      break;
+    off = (size_t)(p - s->buf);
+    if (off == 0 || s->buf[off - 1] == '\n')
+      return (ssize_t)off;
+    i = off + 1;
+  }
+  s->scan = s->len >= plen ? s->len - plen + 1 : 0;
+  return -1;
+}
+
+static int session_recv(vpp_cli_session_t *s, int wait_ms) {
+  unsigned char raw[4096];
+  struct pollfd pfd = {.fd = s->fd, .events = POLLIN};
+  int rv;
+  ssize_t n;
+
+  rv = poll(&pfd, 1, wait_ms);
+  if (rv < 0)
+    return errno == EINTR ? 0 : -1;
+  if (rv == 0)
+    return 0;
+
+  n = recv(s->fd, raw, sizeof(raw), 0);
+  if (n < 0)
+    return (errno == EINTR || errno == EAGAIN) ? 0 : -1;
+  if (n == 0)
+    return -1;
+  if (session_feed(s, raw, (size_t)n) < 0)
     return -1;
+  return (int)n;
+}
+
+/*
+ * Read until the buffer holds a complete reply, i.e. a prompt.
+ * Returns the prompt offset, or -1 on EOF, error or timeout.
+ */
+static ssize_t session_read_reply(vpp_cli_session_t *s, int timeout_ms) {
+  long long deadline = now_ms() + timeout_ms;
+  ssize_t off;
+
+  while ((off = session_find_prompt(s)) < 0) {
+    long long left = deadline - now_ms();
+
+    if (left <= 0 || session_recv(s, (int)left) < 0)
+      return -1;
   }
+  return off;
+}
+
+/*
+ * Consume the banner: read until the socket has been idle for quiet_ms
+ * after the first byte. Returns 0 once something was read, -1 otherwise.
+ */
+static int session_read_banner(vpp_cli_session_t *s, int timeout_ms,
+                               int quiet_ms) {
+  long long deadline = now_ms() + timeout_ms;
 
-  char buf[256];
-  if (fgets(buf, sizeof(buf), fp) != NULL) {
-    /* Check for error messages */
-    if (strstr(buf, "failed") || strstr(buf, "error") ||
-        strstr(buf, "Connection refused")) {
-      fprintf(stderr, "[vpp] VPP not running or not accessible: %s", buf);
-      pclose(fp);
+  for (;;) {
+    long long left = deadline - now_ms();
+    int wait = (int)left;
+    int n;
+
+    if (left <= 0)
+      return s->len > 0 ? 0 : -1;
+    if (s->len > 0 && quiet_ms < wait)
+      wait = quiet_ms;
+
+    n = session_recv(s, wait);
+    if (n < 0)
       return -1;
+    if (n == 0 && s->len > 0 && wait == quiet_ms)
+      return 0;
+  }
+}
+
+static void session_close(vpp_cli_session_t *s) {
+  if (s->fd >= 0)
+    close(s->fd);
+  s->fd = -1;
+  s->len = 0;
+  s->scan = 0;
+  s->tstate = TELNET_STATE_DATA;
+}
+
+/*
+ * Detach the reply ending at the prompt at offset off: strip the echoed
+ * command line, copy it out and shift any following data (the next
+ * pipelined reply) to the front of the buffer.
+ */
+static char *session_take_reply(vpp_cli_session_t *s, const char *cmd,
+                                size_t off) {
+  size_t cmdlen = strlen(cmd);
+  size_t consumed = off + s->prompt_len;
+  const char *out = s->buf;
+  size_t outlen = off;
+  char *response;
+
+  /* Drop the echoed command line */
+  if (outlen >= cmdlen && memcmp(out, cmd, cmdlen) == 0 &&
+      (outlen == cmdlen || out[cmdlen] == '\n')) {
+    size_t skip = outlen > cmdlen ? cmdlen + 1 : cmdlen;
+    out += skip;
+    outlen -= skip;
+  }
+
+  response = malloc(outlen + 1);
+  if (response) {
+    memcpy(response, out, outlen);
+    response[outlen] = '\0';
+  }
+
+  memmove(s->buf, s->buf + consumed, s->len - consumed);
+  s->len -= consumed;
+  s->scan = 0;
+  return response;
+}
+
+/*
+ * Send one command and return its output with the echoed command line
+ * and the trailing prompt removed. Returns NULL if the session broke.
+ */
+static char *session_exec(vpp_cli_session_t *s, const char *cmd) {
+  uint64_t start = vpp_tstats_now_usec();
+  char *response = NULL;
+  ssize_t off;
+
+  s->len = 0;
+  s->scan = 0;
+  if (session_write(s, cmd, strlen(cmd)) < 0 || session_write(s, "\n", 1) < 0)
+    goto done;
+  off = session_read_reply(s, vpp_cli_timeout_ms());
+  if (off < 0)
+    goto done;
+  response = session_take_reply(s, cmd, (size_t)off);
+
+done:
+  vpp_tstats_record_cli(cmd, vpp_tstats_now_usec() - start,
+                        response ? strlen(response) : s->len,
+                        !response || vpp_cli_output_is_error(response));
+  return response;
+}
+
+/*
+ * Send commands without waiting for each reply, keeping up to
+ * VPP_CLI_PIPELINE_DEPTH in flight. VPP handles the lines of one
+ * session in order, so replies are matched to commands by position.
+ * Returns the number of replies collected.
+ */
+static size_t session_exec_pipelined(vpp_cli_session_t *s,
+                                     const char *const *cmds, size_t n,
+                                     char **replies) {
+  int timeout = vpp_cli_timeout_ms();
+  uint64_t sent_at[VPP_CLI_PIPELINE_DEPTH];
+  size_t sent = 0;
+  size_t done = 0;
+  char *wbuf = NULL;
+  size_t wcap = 0;
+
+  s->len = 0;
+  s->scan = 0;
+
+  while (done < n) {
+    size_t first = sent;
+    size_t wlen = 0;
+    uint64_t now;
+    ssize_t off;
+
+    /* Top up the window with one write */
+    while (sent < n && sent - done < VPP_CLI_PIPELINE_DEPTH) {
+      size_t clen = strlen(cmds[sent]);
+      if (wlen + clen + 1 > wcap) {
+        size_t cap = (wlen + clen + 1) * 2;
+        char *nbuf = realloc(wbuf, cap);
+        if (!nbuf) {
+          sent = first; /* Nothing of this round went out */
+          goto done;
+        }
+        wbuf = nbuf;
+        wcap = cap;
+      }
+      memcpy(wbuf + wlen, cmds[sent], clen);
+      wbuf[wlen + clen] = '\n';
+      wlen += clen + 1;
+      sent++;
     }
-    /* VPP is running */
-    fprintf(stderr, "[vpp] Connected: %s", buf);
-    g_connected = true;
+    now = vpp_tstats_now_usec();
+    for (size_t i = first; i < sent; i++)
+      sent_at[i % VPP_CLI_PIPELINE_DEPTH] = now;
+    if (wlen > 0 && session_write(s, wbuf, wlen) < 0)
+      goto done;
+
+    off = session_read_reply(s, timeout);
+    if (off < 0)
+      goto done;
+    replies[done] = session_take_reply(s, cmds[done], (size_t)off);
+    if (!replies[done])
+      goto done;
+    vpp_tstats_record_cli(
+        cmds[done],
+        vpp_tstats_now_usec() - sent_at[done % VPP_CLI_PIPELINE_DEPTH],
+        strlen(replies[done]), vpp_cli_output_is_error(replies[done]));
+    done++;
   }
 
-  pclose(fp);
-  return g_connected ? 0 : -1;
+done:
+  /* The command whose reply never came */
+  if (done < sent)
+    vpp_tstats_record_cli(
+        cmds[done],
+        vpp_tstats_now_usec() - sent_at[done % VPP_CLI_PIPELINE_DEPTH],
+        s->len, true);
+  free(wbuf);
+  return done;
+}
+
+/*
+ * Connect to the CLI socket, consume the banner, learn the prompt and
+ * put the terminal in a mode suitable for machine consumption.
+ */
+static int session_open(vpp_cli_session_t *s) {
+  struct sockaddr_un addr;
+  const char *path = vpp_cli_socket_path();
+  int timeout = vpp_cli_timeout_ms();
+  char *nl;
+  char *reply;
+
+  session_close(s);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "[vpp] CLI socket path too long: %s\n", path);
+    return -1;
+  }
+  strcpy(addr.sun_path, path);
+
+  s->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (s->fd < 0) {
+    fprintf(stderr, "[vpp] socket() failed: %s\n", strerror(errno));
+    return -1;
+  }
+  if (connect(s->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    fprintf(stderr, "[vpp] Cannot connect to %s: %s\n", path,
+            strerror(errno));
+    session_close(s);
+    return -1;
+  }
+
+  /* Banner: read until the socket goes quiet, last line is the prompt */
+  s->prompt_len = 0;
+  if (session_read_banner(s, timeout, VPP_CLI_QUIET_MS) < 0) {
+    /* Nothing yet, poke for a prompt */
+    if (session_write(s, "\n", 1) < 0 ||
+        session_read_banner(s, timeout, VPP_CLI_QUIET_MS) < 0) {
+      fprintf(stderr, "[vpp] No prompt from %s\n", path);
+      session_close(s);
+      return -1;
+    }
+  }
+
+  s->buf[s->len] = '\0';
+  nl = strrchr(s->buf, '\n');
+  nl = nl ? nl + 1 : s->buf;
+  if (*nl == '\0' || strlen(nl) >= sizeof(s->prompt)) {
+    strcpy(s->prompt, VPP_CLI_DEFAULT_PROMPT);
+  } else {
+    strcpy(s->prompt, nl);
+  }
+  s->prompt_len = strlen(s->prompt);
+
+  /* Never block on "--More--", never emit escape sequences */
+  reply = session_exec(s, "set terminal pager off");
+  if (!reply) {
+    fprintf(stderr, "[vpp] CLI session setup failed on %s\n", path);
+    session_close(s);
+    return -1;
+  }
+  free(reply);
+  reply = session_exec(s, "set terminal ansi off");
+  free(reply);
+
+  return 0;
+}
+
+int vpp_connect(void) {
+  char *version;
+
+  if (session_open(&g_session) < 0) {
+    __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
+    return -1;
+  }
+
+  version = session_exec(&g_session, "show version");
+  if (!version) {
+    fprintf(stderr, "[vpp] VPP not responding on %s\n", vpp_cli_socket_path());
+    session_close(&g_session);
+    __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
+    return -1;
+  }
+
+  fprintf(stderr, "[vpp] Connected: %s%s", version,
+          (*version && version[strlen(version) - 1] == '\n') ? "" : "\n");
+  free(version);
+
+  /* Which VPP process answered: a new PID after a reconnect is a restart */
+  g_pid = 0;
+  version = session_exec(&g_session, "show version verbose");
+  if (version) {
+    const char *pid = strstr(version, "Current PID:");
+    if (pid)
+      g_pid = (uint32_t)strtoul(pid + strlen("Current PID:"), NULL, 10);
+    free(version);
+  }
+
+  __atomic_add_fetch(&g_epoch, 1, __ATOMIC_RELEASE);
+  __atomic_store_n(&g_connected, true, __ATOMIC_RELEASE);
+  return 0;
 }
 
 void vpp_disconnect(void) {
-  g_connected = false;
+  session_close(&g_session);
+  free(g_session.buf);
+  g_session.buf = NULL;
+  g_session.cap = 0;
+  for (unsigned i = 1; i < VPP_CLI_MAX_SESSIONS; i++) {
+    session_close(&g_extra[i]);
+    free(g_extra[i].buf);
+    g_extra[i].buf = NULL;
+    g_extra[i].cap = 0;
+  }
+  __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
   fprintf(stderr, "[vpp] Disconnected\n");
 }
 
-bool vpp_is_connected(void) { return g_connected; }
+bool vpp_is_connected(void) {
+  return __atomic_load_n(&g_connected, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Connection generation: changes whenever a new session is opened, e.g.
+ * after VPP restarted. Anything cached from VPP under an older epoch
+ * must be considered stale.
+ */
+uint64_t vpp_connection_epoch(void) {
+  return __atomic_load_n(&g_epoch, __ATOMIC_ACQUIRE);
+}
+
+uint32_t vpp_connection_pid(void) { return g_pid; }
 
 int vpp_reconnect(void) {
-  g_connected = false;
+  session_close(&g_session);
+  __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
   return vpp_connect();
 }
 
 /*
- * Execute a VPP CLI command via vppctl
+ * Execute a VPP CLI command over the persistent session
  * Returns allocated buffer with response (caller must free), or NULL on error
+ *
+ * A broken session (VPP restarted, socket closed) is reopened and the
+ * command retried once.
  */
 char *vpp_cli_exec(const char *cmd) {
-  char *response = NULL;
-  char cmdline[512];
-  FILE *fp;
-  size_t total_read = 0;
-  size_t bufsize = VPP_CLI_BUFSIZE;
+  char *response;
 
-  if (!g_connected) {
-    if (vpp_connect() != 0) {
+  if (!vpp_is_connected() || g_session.fd < 0) {
+    if (vpp_reconnect() != 0) {
       return NULL;
     }
   }
 
-  /* Build command line */
-  snprintf(cmdline, sizeof(cmdline), "%s %s 2>&1", VPPCTL_PATH, cmd);
+  response = session_exec(&g_session, cmd);
+  if (response)
+    return response;
 
-  fp = popen(cmdline, "r");
-  if (!fp) {
-    fprintf(stderr, "[vpp] popen() failed: %s\n", strerror(errno));
+  /* Anything received means VPP saw the command; never run it twice */
+  if (g_session.len > 0) {
+    fprintf(stderr, "[vpp] CLI session broke mid-reply for '%s'\n", cmd);
+    session_close(&g_session);
+    __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
     return NULL;
   }
 
-  /* Allocate response buffer */
-  response = malloc(bufsize);
-  if (!response) {
-    pclose(fp);
+  fprintf(stderr, "[vpp] CLI session lost during '%s', reconnecting\n", cmd);
+  if (vpp_reconnect() != 0) {
     return NULL;
   }
-  response[0] = '\0';
 
-  /* Read all output */
-  while (1) {
-    size_t n = fread(response + total_read, 1, bufsize - total_read - 1, fp);
-    if (n == 0)
-      break;
-    total_read += n;
-
-    if (total_read >= bufsize - 1) {
-      /* Grow buffer */
-      bufsize *= 2;
-      char *new_buf = realloc(response, bufsize);
-      if (!new_buf) {
-        free(response);
-        pclose(fp);
-        return NULL;
+  response = session_exec(&g_session, cmd);
+  if (!response) {
+    fprintf(stderr, "[vpp] Command failed after reconnect: %s\n", cmd);
+    session_close(&g_session);
+    __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
+  }
+  return response;
+}
+
+/*
+ * Execute several CLI commands pipelined over the persistent session
+ * replies[i] receives the allocated output of cmds[i] (caller frees)
+ * Returns 0 when every reply arrived, -1 otherwise; replies that never
+ * arrived are left NULL and the session is reset for the next caller.
+ */
+int vpp_cli_exec_pipelined(const char *const *cmds, size_t n, char **replies) {
+  size_t done;
+
+  for (size_t i = 0; i < n; i++)
+    replies[i] = NULL;
+  if (n == 0)
+    return 0;
+
+  if (!vpp_is_connected() || g_session.fd < 0) {
+    if (vpp_reconnect() != 0) {
+      return -1;
+    }
+  }
+
+  done = session_exec_pipelined(&g_session, cmds, n, replies);
+  if (done == n)
+    return 0;
+
+  fprintf(stderr, "[vpp] CLI session lost after %zu of %zu pipelined commands\n",
+          done, n);
+  session_close(&g_session);
+  __atomic_store_n(&g_connected, false, __ATOMIC_RELEASE);
+  return -1;
+}
+
+/*
+ * Number of sessions vpp_cli_exec_pipelined_on() spreads work over
+ */
+unsigned vpp_cli_sessions(void) {
+  const char *env = getenv("VPP_CLI_SESSIONS");
+  long n = env ? strtol(env, NULL, 10) : VPP_CLI_SESSIONS;
+
+  if (n < 1)
+    return 1;
+  if (n > VPP_CLI_MAX_SESSIONS)
+    return VPP_CLI_MAX_SESSIONS;
+  return (unsigned)n;
+}
+
+/*
+ * vpp_cli_exec_pipelined() on one of the parallel sessions
+ * Session 0 is the persistent main session; the others are opened on
+ * first use and reopened after the main session reconnected. Different
+ * sessions may be driven from different threads at the same time, as
+ * long as the main session is connected beforehand.
+ */
+int vpp_cli_exec_pipelined_on(unsigned session, const char *const *cmds,
+                              size_t n, char **replies) {
+  vpp_cli_session_t *s;
+  uint64_t epoch;
+  size_t done;
+
+  if (session == 0)
+    return vpp_cli_exec_pipelined(cmds, n, replies);
+  if (session >= VPP_CLI_MAX_SESSIONS)
+    return -1;
+
+  for (size_t i = 0; i < n; i++)
+    replies[i] = NULL;
+  if (n == 0)
+    return 0;
+
+  s = &g_extra[session];
+  epoch = vpp_connection_epoch();
+  if (s->fd < 0 || g_extra_epoch[session] != epoch) {
+    if (session_open(s) < 0)
+      return -1;
+    g_extra_epoch[session] = epoch;
+  }
+
+  done = session_exec_pipelined(s, cmds, n, replies);
+  if (done == n)
+    return 0;
+
+  fprintf(stderr,
+          "[vpp] CLI session %u lost after %zu of %zu pipelined commands\n",
+          session, done, n);
+  session_close(s);
+  return -1;
+}
+
+/*
+ * Batch execution via "exec <script>"
+ *
+ * The commands are written to a script on tmpfs, separated by "echo"
+ * marker lines, and VPP runs the whole script for one "exec" round
+ * trip. The output is cut back into per-command pieces at the markers.
+ * VPP stops a script at the first failing command: the last marker
+ * seen then identifies the culprit and the rest is resubmitted.
+ */
+
+static FILE *batch_script_open(char *path, size_t pathlen) {
+  const char *dirs[] = {getenv("VPP_CLI_BATCH_DIR"), "/run/vpp", "/dev/shm",
+                        "/tmp"};
+
+  for (size_t i = 0; i < sizeof(dirs) / sizeof(dirs[0]); i++) {
+    FILE *fp;
+    int fd;
+
+    if (!dirs[i] || !*dirs[i])
+      continue;
+    snprintf(path, pathlen, "%s/clixon-vpp-batch.XXXXXX", dirs[i]);
+    fd = mkstemp(path);
+    if (fd < 0)
+      continue;
+    /* VPP may run as a different user */
+    fchmod(fd, 0644);
+    fp = fdopen(fd, "w");
+    if (fp)
+      return fp;
+    close(fd);
+    unlink(path);
+  }
+  return NULL;
+}
+
+/* Marker index of a line, n for the end marker, -1 if not a marker */
+static long batch_marker(const char *line, size_t n) {
+  size_t mlen = strlen(VPP_CLI_BATCH_MARK);
+
+  if (strncmp(line, VPP_CLI_BATCH_MARK, mlen) != 0)
+    return -1;
+  if (strncmp(line + mlen, "end", 3) == 0)
+    return (long)n;
+  return strtol(line + mlen, NULL, 10);
+}
+
+/*
+ * Run cmds[0..n) as one script, fill results for the commands VPP got
+ * to. Returns how many commands ran (including a failing last one), or
+ * -1 if the script could not be run at all.
+ */
+static long batch_exec_script(const char *const *cmds, size_t n,
+                              vpp_cli_result_t *results) {
+  char path[256];
+  char exec_cmd[300];
+  FILE *fp;
+  char *output;
+  char *line;
+  long cur = -1;
+  const char *start = NULL;
+  bool seen_end = false;
+
+  fp = batch_script_open(path, sizeof(path));
+  if (!fp)
+    return -1;
+  for (size_t i = 0; i < n; i++)
+    fprintf(fp, "echo " VPP_CLI_BATCH_MARK "%zu@@\n%s\n", i, cmds[i]);
+  fprintf(fp, "echo " VPP_CLI_BATCH_MARK "end@@\n");
+  if (fclose(fp) != 0) {
+    unlink(path);
+    return -1;
+  }
+
+  snprintf(exec_cmd, sizeof(exec_cmd), "exec %s", path);
+  output = vpp_cli_exec(exec_cmd);
+  unlink(path);
+  if (!output)
+    return -1;
+
+  /* Walk the lines, each marker closes the previous command's output */
+  line = output;
+  while (line && *line) {
+    char *next = strchr(line, '\n');
+    long mark = batch_marker(line, n);
+
+    if (mark >= 0 && mark <= (long)n) {
+      if (cur >= 0 && start)
+        results[cur].output = strndup(start, (size_t)(line - start));
+      if (mark == (long)n) {
+        seen_end = true;
+        start = NULL;
+        break;
       }
-      response = new_buf;
+      cur = mark;
+      start = next ? next + 1 : line + strlen(line);
     }
+    line = next ? next + 1 : NULL;
   }
+  if (cur >= 0 && start && !seen_end)
+    results[cur].output = strdup(start);
+  free(output);
 
-  response[total_read] = '\0';
+  if (cur < 0)
+    return -1;
 
-  int status = pclose(fp);
-  if (status != 0) {
-    /* Command might have failed but still returned output */
-    fprintf(stderr, "[vpp] vppctl returned status %d\n", status);
+  for (long i = 0; i <= cur; i++) {
+    if (!results[i].output)
+      results[i].output = strdup("");
+    results[i].rv = vpp_cli_output_is_error(results[i].output) ? -1 : 0;
   }
+  if (!seen_end)
+    results[cur].rv = -1; /* exec stopped here */
 
-  return response;
+  return seen_end ? (long)n : cur + 1;
+}
+
+/*
+ * Execute many CLI commands in as few round trips as possible
+ * results[i] receives output and status of cmds[i]; a failing command
+ * does not prevent the following ones from running.
+ * Returns 0 if every command succeeded, -1 otherwise.
+ */
+int vpp_cli_exec_batch(const char **cmds, size_t n,
+                       vpp_cli_result_t *results) {
+  size_t done = 0;
+  int ret = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    results[i].output = NULL;
+    results[i].rv = VPP_CLI_NOT_RUN;
+  }
+
+  while (done < n) {
+    long ran = batch_exec_script(cmds + done, n - done, results + done);
+
+    if (ran < 0) {
+      /* No usable script (tmpfs, permissions): pipeline instead */
+      char **replies = calloc(n - done, sizeof(*replies));
+      if (!replies)
+        return -1;
+      vpp_cli_exec_pipelined(cmds + done, n - done, replies);
+      for (size_t i = done; i < n; i++) {
+        results[i].output = replies[i - done];
+        if (results[i].output)
+          results[i].rv = vpp_cli_output_is_error(results[i].output) ? -1 : 0;
+      }
+      free(replies);
+      break;
+    }
+    done += (size_t)ran;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (results[i].rv != 0) {
+      if (results[i].rv == -1)
+        fprintf(stderr, "[vpp] Command failed: %s\nResponse: %s\n", cmds[i],
+                results[i].output ? results[i].output : "");
+      ret = -1;
+    }
+  }
+  return ret;
+}
+
+void vpp_cli_results_free(vpp_cli_result_t *results, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    free(results[i].output);
+    results[i].output = NULL;
+  }
+}
+
+/*
+ * Heuristic used throughout for CLI replies: VPP reports failures as
+ * free text rather than a status code.
+ */
+bool vpp_cli_output_is_error(const char *output) {
+  return output &&
+         (strstr(output, "error") || strstr(output, "Error") ||
+          strstr(output, "unknown input") || strstr(output, "failed"));
 }
 
 /*
@@ -134,8 +869,7 @@ int vpp_cli_exec_check(const char *cmd) {
   }
 
   /* Check for error indicators in response */
-  if (strstr(response, "error") || strstr(response, "Error") ||
-      strstr(response, "unknown input") || strstr(response, "failed")) {
+  if (vpp_cli_output_is_error(response)) {
     fprintf(stderr, "[vpp] Command failed: %s\nResponse: %s\n", cmd, response);
     ret = -1;
   }
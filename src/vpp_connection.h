@@ -6,17 +6,39 @@
 #define _VPP_CONNECTION_H_
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define VPP_CLIENT_NAME "clixon-vpp-plugin"
+#define VPP_CLI_SOCKET "/run/vpp/cli.sock" /* Override with VPP_CLI_SOCK */
+
+/* Per-command result of vpp_cli_exec_batch() */
+typedef struct {
+  char *output; /* Allocated, release with vpp_cli_results_free() */
+  int rv;       /* 0 ok, -1 VPP reported an error, VPP_CLI_NOT_RUN */
+} vpp_cli_result_t;
+
+#define VPP_CLI_NOT_RUN (-2)
+
+#define VPP_CLI_MAX_SESSIONS 8 /* Upper bound for vpp_cli_sessions() */
 
 /* Connection management */
 int vpp_connect(void);
 void vpp_disconnect(void);
 bool vpp_is_connected(void);
 int vpp_reconnect(void);
+uint64_t vpp_connection_epoch(void);
+uint32_t vpp_connection_pid(void); /* VPP's PID at the last connect, 0 if unknown */
 
 /* CLI command execution */
 char *vpp_cli_exec(const char *cmd);
 int vpp_cli_exec_check(const char *cmd);
+int vpp_cli_exec_pipelined(const char *const *cmds, size_t n, char **replies);
+unsigned vpp_cli_sessions(void);
+int vpp_cli_exec_pipelined_on(unsigned session, const char *const *cmds,
+                              size_t n, char **replies);
+int vpp_cli_exec_batch(const char **cmds, size_t n, vpp_cli_result_t *results);
+void vpp_cli_results_free(vpp_cli_result_t *results, size_t n);
+bool vpp_cli_output_is_error(const char *output);
 
 #endif /* _VPP_CONNECTION_H_ */
@@ -0,0 +1,263 @@
+/*
+ * vpp_ifcache.c - Interface name <-> sw_if_index cache
+ *
+ * index -> name is a flat array indexed by sw_if_index (VPP allocates
+ * them densely), name -> index an open-addressing hash over the same
+ * entries. Both directions are O(1).
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vpp_connection.h"
+#include "vpp_ifcache.h"
+#include "vpp_interface.h"
+
+#define IFCACHE_MISS_HOLDOFF_MS 250 /* Min. age before a miss reloads */
+#define IFCACHE_HASH_MIN 256
+#define IFCACHE_HASH_EMPTY 0           /* Slots hold sw_if_index + 1 */
+#define IFCACHE_HASH_TOMB UINT32_MAX
+
+typedef struct {
+  char name[64];
+  bool used;
+} ifcache_slot_t;
+
+static ifcache_slot_t *by_index = NULL;
+static uint32_t nindex = 0;
+static uint32_t *hash = NULL;
+static uint32_t hsize = 0;     /* Power of two */
+static uint32_t hfill = 0;     /* Entries plus tombstones */
+static bool loaded = false;
+static bool stale = false;
+static uint64_t loaded_epoch = 0;
+static long long loaded_ms = 0;
+static uint64_t changes = 0; /* Interfaces created/deleted through us */
+
+static long long now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint32_t name_hash(const char *name) {
+  uint32_t h = 2166136261u; /* FNV-1a */
+  while (*name) {
+    h ^= (uint8_t)*name++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/* Hash position holding name, or -1 */
+static long hash_find(const char *name) {
+  uint32_t mask = hsize - 1;
+  uint32_t pos;
+
+  if (hsize == 0)
+    return -1;
+  for (pos = name_hash(name) & mask;; pos = (pos + 1) & mask) {
+    uint32_t v = hash[pos];
+    if (v == IFCACHE_HASH_EMPTY)
+      return -1;
+    if (v != IFCACHE_HASH_TOMB && strcmp(by_index[v - 1].name, name) == 0)
+      return (long)pos;
+  }
+}
+
+static void hash_put(uint32_t sw_if_index) {
+  uint32_t mask = hsize - 1;
+  uint32_t pos = name_hash(by_index[sw_if_index].name) & mask;
+
+  while (hash[pos] != IFCACHE_HASH_EMPTY && hash[pos] != IFCACHE_HASH_TOMB)
+    pos = (pos + 1) & mask;
+  if (hash[pos] == IFCACHE_HASH_EMPTY)
+    hfill++;
+  hash[pos] = sw_if_index + 1;
+}
+
+static int hash_resize(uint32_t size) {
+  uint32_t *nhash = calloc(size, sizeof(*nhash));
+
+  if (!nhash)
+    return -1;
+  free(hash);
+  hash = nhash;
+  hsize = size;
+  hfill = 0;
+  for (uint32_t i = 0; i < nindex; i++) {
+    if (by_index[i].used)
+      hash_put(i);
+  }
+  return 0;
+}
+
+static void ifcache_clear(void) {
+  if (by_index)
+    memset(by_index, 0, nindex * sizeof(*by_index));
+  if (hash)
+    memset(hash, 0, hsize * sizeof(*hash));
+  hfill = 0;
+}
+
+static void ifcache_remove_index(uint32_t sw_if_index) {
+  long pos;
+
+  if (sw_if_index >= nindex || !by_index[sw_if_index].used)
+    return;
+  pos = hash_find(by_index[sw_if_index].name);
+  if (pos >= 0)
+    hash[pos] = IFCACHE_HASH_TOMB;
+  by_index[sw_if_index].used = false;
+}
+
+static void ifcache_insert(const char *name, uint32_t sw_if_index) {
+  long pos;
+
+  if (!name || !*name || sw_if_index == VPP_IFCACHE_NONE)
+    return;
+
+  if (sw_if_index >= nindex) {
+    uint32_t n = nindex ? nindex : 64;
+    ifcache_slot_t *nslots;
+    while (n <= sw_if_index)
+      n *= 2;
+    nslots = realloc(by_index, n * sizeof(*nslots));
+    if (!nslots)
+      return;
+    memset(nslots + nindex, 0, (n - nindex) * sizeof(*nslots));
+    by_index = nslots;
+    nindex = n;
+  }
+
+  /* Name moved to another index, or index reused for another name */
+  pos = hash_find(name);
+  if (pos >= 0)
+    ifcache_remove_index(hash[pos] - 1);
+  ifcache_remove_index(sw_if_index);
+
+  snprintf(by_index[sw_if_index].name, sizeof(by_index[sw_if_index].name),
+           "%s", name);
+  by_index[sw_if_index].used = true;
+
+  if (hsize == 0 || (hfill + 1) * 2 > hsize) {
+    uint32_t size = hsize ? hsize : IFCACHE_HASH_MIN;
+    while ((hfill + 1) * 2 > size)
+      size *= 2;
+    if (hash_resize(size) < 0)
+      return;
+  }
+  hash_put(sw_if_index);
+}
+
+static int ifcache_load(void) {
+  vpp_if_table_t table = {0};
+
+  if (vpp_interface_dump_brief(&table) != 0) {
+    vpp_if_table_free(&table);
+    loaded = false;
+    return -1;
+  }
+  ifcache_clear();
+  for (uint32_t idx = 0; idx < table.max; idx++) {
+    if (vpp_if_present(&table, idx))
+      ifcache_insert(table.cold[idx].name, idx);
+  }
+  vpp_if_table_free(&table);
+
+  loaded = true;
+  stale = false;
+  loaded_epoch = vpp_connection_epoch();
+  loaded_ms = now_ms();
+  return 0;
+}
+
+/* Drop a table built against a previous VPP instance */
+static void ifcache_check_generation(void) {
+  if (!loaded || loaded_epoch != vpp_connection_epoch())
+    ifcache_load();
+}
+
+/* After a miss: reload once, unless the table is fresh and complete */
+static bool ifcache_reload_on_miss(void) {
+  if (!stale && now_ms() - loaded_ms < IFCACHE_MISS_HOLDOFF_MS)
+    return false;
+  return ifcache_load() == 0;
+}
+
+uint32_t vpp_ifcache_name_to_index(const char *name) {
+  long pos;
+
+  if (!name)
+    return VPP_IFCACHE_NONE;
+
+  ifcache_check_generation();
+  pos = hash_find(name);
+  if (pos < 0 && ifcache_reload_on_miss())
+    pos = hash_find(name);
+  return pos < 0 ? VPP_IFCACHE_NONE : hash[pos] - 1;
+}
+
+int vpp_ifcache_index_to_name(uint32_t sw_if_index, char *name, size_t len) {
+  ifcache_check_generation();
+  if ((sw_if_index >= nindex || !by_index[sw_if_index].used) &&
+      !ifcache_reload_on_miss())
+    return -1;
+  if (sw_if_index >= nindex || !by_index[sw_if_index].used)
+    return -1;
+  snprintf(name, len, "%s", by_index[sw_if_index].name);
+  return 0;
+}
+
+void vpp_ifcache_add(const char *name, uint32_t sw_if_index) {
+  changes++;
+  if (loaded)
+    ifcache_insert(name, sw_if_index);
+}
+
+void vpp_ifcache_remove(const char *name) {
+  long pos;
+
+  changes++;
+  if (!loaded || !name)
+    return;
+  pos = hash_find(name);
+  if (pos >= 0)
+    ifcache_remove_index(hash[pos] - 1);
+}
+
+void vpp_ifcache_mark_stale(void) {
+  changes++;
+  stale = true;
+}
+
+void vpp_ifcache_invalidate(void) {
+  changes++;
+  loaded = false;
+}
+
+/* What VPP reports wins over what we were told or loaded earlier */
+void vpp_ifcache_sync(const vpp_if_table_t *t) {
+  if (!loaded || loaded_epoch != vpp_connection_epoch())
+    ifcache_clear();
+  for (uint32_t idx = 0; idx < t->max; idx++) {
+    if (vpp_if_present(t, idx) &&
+        (idx >= nindex || !by_index[idx].used ||
+         strcmp(by_index[idx].name, t->cold[idx].name) != 0))
+      ifcache_insert(t->cold[idx].name, idx);
+  }
+  for (uint32_t idx = 0; idx < nindex; idx++) {
+    if (by_index[idx].used && !vpp_if_present(t, idx))
+      ifcache_remove_index(idx);
+  }
+
+  loaded = true;
+  stale = false;
+  loaded_epoch = vpp_connection_epoch();
+  loaded_ms = now_ms();
+}
+
+uint64_t vpp_ifcache_changes(void) { return changes; }
@@ -0,0 +1,40 @@
+/*
+ * vpp_ifcache.h - Interface name <-> sw_if_index cache
+ *
+ * Persistent bidirectional map between VPP interface names and
+ * sw_if_index values, so lookups no longer cost a full interface dump.
+ * The table is loaded with one "show interface", kept current by the
+ * create/delete paths and dropped when the VPP connection epoch changes
+ * (VPP restarted). A lookup miss triggers at most one reload. Interfaces
+ * deleted and re-created behind our back are caught by the interface
+ * dumps made for other reasons, which correct the table as they pass,
+ * and by failed ops, which drop it.
+ */
+
+#ifndef _VPP_IFCACHE_H_
+#define _VPP_IFCACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vpp_interface.h"
+
+#define VPP_IFCACHE_NONE ((uint32_t)-1)
+
+/* Lookups: VPP_IFCACHE_NONE / -1 when the interface does not exist */
+uint32_t vpp_ifcache_name_to_index(const char *name);
+int vpp_ifcache_index_to_name(uint32_t sw_if_index, char *name, size_t len);
+
+/* Updates from code that creates or deletes interfaces */
+void vpp_ifcache_add(const char *name, uint32_t sw_if_index);
+void vpp_ifcache_remove(const char *name);
+void vpp_ifcache_mark_stale(void);  /* Created, index not known yet */
+void vpp_ifcache_invalidate(void);
+
+/* Take names and indices from a fresh dump of every interface */
+void vpp_ifcache_sync(const vpp_if_table_t *t);
+
+/* Counts the updates above; other caches of interface state compare it */
+uint64_t vpp_ifcache_changes(void);
+
+#endif /* _VPP_IFCACHE_H_ */
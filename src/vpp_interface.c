@@ -9,195 +9,335 @@
  */
 
 #include <arpa/inet.h>
-#include <ctype.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "vpp_connection.h"
+#include "vpp_ifcache.h"
 #include "vpp_interface.h"
+#include "vpp_tok.h"
 
 /*
- * Parse "show interface" output to extract interface information
- *
- * Example output (fixed-width columns):
- *               Name               Idx    State  MTU (L3/IP4/IP6/MPLS) Counter
- * Count HundredGigabitEthernet8a/0/0      1     down         9000/0/0/0 local0
- * 0     down          0/0/0/0
+ * Interface table
  */
-static int parse_show_interface(const char *output,
-                                vpp_interface_info_t **interfaces) {
-  vpp_interface_info_t *head = NULL;
-  vpp_interface_info_t *tail = NULL;
-  const char *line;
-  const char *next;
-  char linebuf[512];
-  int line_num = 0;
 
-  if (!output || !interfaces) {
+#define IF_TABLE_MIN 64
+#define IF_HASH_MIN 128
+
+static uint32_t if_name_hash(const char *name, size_t len) {
+  uint32_t h = 2166136261u; /* FNV-1a */
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)name[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/* Lookup by a name that need not be NUL-terminated */
+static uint32_t if_table_find_n(const vpp_if_table_t *t, const char *name,
+                                size_t len) {
+  uint32_t mask = t->hsize - 1;
+  uint32_t pos;
+
+  if (t->hsize == 0 || len >= sizeof(t->cold[0].name))
+    return VPP_IF_NONE;
+  for (pos = if_name_hash(name, len) & mask; t->hash[pos];
+       pos = (pos + 1) & mask) {
+    const char *n = t->cold[t->hash[pos] - 1].name;
+    if (strncmp(n, name, len) == 0 && n[len] == '\0')
+      return t->hash[pos] - 1;
+  }
+  return VPP_IF_NONE;
+}
+
+uint32_t vpp_if_table_find(const vpp_if_table_t *t, const char *name) {
+  return name ? if_table_find_n(t, name, strlen(name)) : VPP_IF_NONE;
+}
+
+static void if_hash_put(vpp_if_table_t *t, uint32_t idx) {
+  const char *name = t->cold[idx].name;
+  uint32_t mask = t->hsize - 1;
+  uint32_t pos = if_name_hash(name, strlen(name)) & mask;
+
+  while (t->hash[pos])
+    pos = (pos + 1) & mask;
+  t->hash[pos] = idx + 1;
+  t->hfill++;
+}
+
+static int if_hash_grow(vpp_if_table_t *t) {
+  uint32_t size = t->hsize ? t->hsize * 2 : IF_HASH_MIN;
+  uint32_t *nhash = calloc(size, sizeof(*nhash));
+
+  if (!nhash)
     return -1;
+  free(t->hash);
+  t->hash = nhash;
+  t->hsize = size;
+  t->hfill = 0;
+  for (uint32_t i = 0; i < t->max; i++) {
+    if (t->hot[i].flags & VPP_IF_F_PRESENT)
+      if_hash_put(t, i);
   }
-  *interfaces = NULL;
+  return 0;
+}
 
-  line = output;
-  while (line && *line) {
-    /* Find end of line */
-    next = strchr(line, '\n');
-    size_t len = next ? (size_t)(next - line) : strlen(line);
+/* Forget the previous dump, keep the allocations */
+static void if_table_reset(vpp_if_table_t *t) {
+  if (t->hot)
+    memset(t->hot, 0, t->max * sizeof(*t->hot));
+  if (t->cold)
+    memset(t->cold, 0, t->max * sizeof(*t->cold));
+  if (t->hash)
+    memset(t->hash, 0, t->hsize * sizeof(*t->hash));
+  t->max = 0;
+  t->count = 0;
+  t->hfill = 0;
+}
 
-    if (len >= sizeof(linebuf)) {
-      len = sizeof(linebuf) - 1;
-    }
-    memcpy(linebuf, line, len);
-    linebuf[len] = '\0';
+/* Claim the slot for idx, growing the arrays as needed */
+static int if_table_add(vpp_if_table_t *t, uint32_t idx, vpp_slice_t name) {
+  if (idx == VPP_IF_NONE || name.len >= sizeof(t->cold[0].name))
+    return -1;
 
-    line_num++;
+  if (idx >= t->cap) {
+    uint32_t cap = t->cap ? t->cap : IF_TABLE_MIN;
+    vpp_if_hot_t *nhot;
+    vpp_if_cold_t *ncold;
+
+    while (cap <= idx)
+      cap *= 2;
+    nhot = realloc(t->hot, cap * sizeof(*nhot));
+    if (!nhot)
+      return -1;
+    t->hot = nhot;
+    ncold = realloc(t->cold, cap * sizeof(*ncold));
+    if (!ncold)
+      return -1;
+    t->cold = ncold;
+    memset(t->hot + t->cap, 0, (cap - t->cap) * sizeof(*t->hot));
+    memset(t->cold + t->cap, 0, (cap - t->cap) * sizeof(*t->cold));
+    t->cap = cap;
+  }
+
+  if (t->hot[idx].flags & VPP_IF_F_PRESENT)
+    return -1; /* Duplicate index */
+  if ((t->hfill + 1) * 2 > t->hsize && if_hash_grow(t) < 0)
+    return -1;
 
-    /* Skip header line (contains "Name" and "Idx") */
-    if (strstr(linebuf, "Name") && strstr(linebuf, "Idx")) {
-      line = next ? next + 1 : NULL;
-      continue;
-    }
+  t->hot[idx].sw_if_index = idx;
+  t->hot[idx].sup_sw_if_index = idx;
+  t->hot[idx].bond_sw_if_index = VPP_IF_NONE;
+  t->hot[idx].flags = VPP_IF_F_PRESENT;
+  vpp_tok_copy(name, t->cold[idx].name, sizeof(t->cold[idx].name));
+  if (idx >= t->max)
+    t->max = idx + 1;
+  t->count++;
+  if_hash_put(t, idx);
+  return 0;
+}
 
-    /* Skip empty or short lines */
-    if (len < 20) {
-      line = next ? next + 1 : NULL;
-      continue;
-    }
+void vpp_if_table_free(vpp_if_table_t *t) {
+  free(t->hot);
+  free(t->cold);
+  free(t->hash);
+  memset(t, 0, sizeof(*t));
+}
 
-    /* Parse fixed-width format:
-     * Columns: Name (30 chars), Idx, State, MTU/MTU/MTU/MTU, Counter, Count
-     * Name starts at column 0 and goes until we find multiple spaces before a
-     * digit
-     */
-    char name[64] = {0};
-    int idx = -1;
-    char state[16] = {0};
-    int mtu1 = 0;
-
-    /* The format seems to be:
-     * Name is left-aligned, followed by spaces, then index right-aligned around
-     * column 30
-     */
-
-    /* Find where name ends - look for pattern of spaces followed by digit
-     * (index) */
-    int name_end = 0;
-    int i;
-    for (i = 0; i < (int)len - 2; i++) {
-      if (!isspace(linebuf[i])) {
-        name_end = i + 1;
-      }
-      /* Look for transition from spaces to digit */
-      if (isspace(linebuf[i]) && isspace(linebuf[i + 1]) &&
-          isdigit(linebuf[i + 2])) {
-        break;
-      }
-    }
+static const char *if_type_from_name(const char *name) {
+  if (strncmp(name, "local", 5) == 0)
+    return "local";
+  if (strncmp(name, "loop", 4) == 0)
+    return "loopback";
+  if (strncmp(name, "tap", 3) == 0)
+    return "tap";
+  if (strncmp(name, "vxlan", 5) == 0)
+    return "vxlan";
+  if (strncmp(name, "memif", 5) == 0)
+    return "memif";
+  if (strncmp(name, "host-", 5) == 0)
+    return "af-packet";
+  if (strncmp(name, "BondEthernet", 12) == 0)
+    return "bond";
+  if (strchr(name, '.') != NULL)
+    return "sub-interface";
+  return "ethernet";
+}
 
-    if (name_end > 0 && name_end < 64) {
-      memcpy(name, linebuf, name_end);
-      name[name_end] = '\0';
-    }
+/*
+ * Parse "show interface" output into the table
+ *
+ * Example output (fixed-width columns):
+ *               Name               Idx    State  MTU (L3/IP4/IP6/MPLS)     Counter          Count
+ * HundredGigabitEthernet8a/0/0      1     down         9000/0/0/0
+ * local0                            0     down          0/0/0/0
+ */
+static int parse_show_interface(const char *output, vpp_if_table_t *t) {
+  vpp_tok_t tok;
+  vpp_slice_t line;
+  vpp_tok_ifrow_t row;
 
-    /* Parse rest: idx state mtu/mtu/mtu/mtu */
-    if (name[0] && i < (int)len) {
-      int mtu2, mtu3, mtu4;
-      char *rest = linebuf + i;
-
-      /* Skip leading spaces and parse */
-      while (*rest && isspace(*rest))
-        rest++;
-
-      if (sscanf(rest, "%d %15s %d/%d/%d/%d", &idx, state, &mtu1, &mtu2, &mtu3,
-                 &mtu4) >= 2) {
-
-        /* Create interface info */
-        vpp_interface_info_t *info = calloc(1, sizeof(vpp_interface_info_t));
-        if (info) {
-          info->sw_if_index = (uint32_t)idx;
-          strncpy(info->name, name, sizeof(info->name) - 1);
-          info->mtu = (uint32_t)mtu1;
-          info->admin_up = (strcmp(state, "up") == 0);
-          info->link_up = info->admin_up;
-
-          /* Determine type from name */
-          if (strncmp(name, "local", 5) == 0) {
-            strcpy(info->type, "local");
-          } else if (strncmp(name, "loop", 4) == 0) {
-            strcpy(info->type, "loopback");
-          } else if (strncmp(name, "tap", 3) == 0) {
-            strcpy(info->type, "tap");
-          } else if (strncmp(name, "vxlan", 5) == 0) {
-            strcpy(info->type, "vxlan");
-          } else if (strncmp(name, "memif", 5) == 0) {
-            strcpy(info->type, "memif");
-          } else if (strncmp(name, "host-", 5) == 0) {
-            strcpy(info->type, "af-packet");
-          } else if (strncmp(name, "BondEthernet", 12) == 0) {
-            strcpy(info->type, "bond");
-          } else if (strchr(name, '.') != NULL) {
-            strcpy(info->type, "sub-interface");
-          } else {
-            strcpy(info->type, "ethernet");
-          }
-
-          /* Add to list */
-          info->next = NULL;
-          if (tail == NULL) {
-            head = tail = info;
-          } else {
-            tail->next = info;
-            tail = info;
-          }
-        }
-      }
-    }
+  if (!output || !t) {
+    return -1;
+  }
+  if_table_reset(t);
 
-    line = next ? next + 1 : NULL;
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    vpp_if_cold_t *cold;
+
+    /* Title and counter lines are not rows */
+    if (!vpp_tok_show_interface_row(line, &row) ||
+        if_table_add(t, row.sw_if_index, row.name) != 0)
+      continue;
+
+    t->hot[row.sw_if_index].mtu = row.mtu;
+    if (vpp_tok_eq(row.state, "up"))
+      t->hot[row.sw_if_index].flags |= VPP_IF_F_ADMIN_UP | VPP_IF_F_LINK_UP;
+    cold = &t->cold[row.sw_if_index];
+    snprintf(cold->type, sizeof(cold->type), "%s",
+             if_type_from_name(cold->name));
+  }
+
+  /* Sub-interfaces: parent is the name before the '.' */
+  for (uint32_t idx = 0; idx < t->max; idx++) {
+    const char *dot;
+    uint32_t sup;
+
+    if (!(t->hot[idx].flags & VPP_IF_F_PRESENT) ||
+        (dot = strchr(t->cold[idx].name, '.')) == NULL)
+      continue;
+    sup = if_table_find_n(t, t->cold[idx].name,
+                          (size_t)(dot - t->cold[idx].name));
+    if (sup != VPP_IF_NONE)
+      t->hot[idx].sup_sw_if_index = sup;
   }
 
-  *interfaces = head;
   return 0;
 }
 
 /*
- * Parse MAC address from "show hardware-interfaces" output
+ * Parse "show hardware-interfaces" (all interfaces, one call)
+ *
+ * Example output:
+ *               Name                Idx   Link  Hardware
+ * HundredGigabitEthernet8a/0/0       1     up   HundredGigabitEthernet8a/0/0
+ *   Link speed: 100 Gbps
+ *   RX Queues:
+ *     queue thread         mode
+ *     0     main (0)       polling
+ *   Ethernet address b8:3f:d2:b9:b2:9e
+ *   Mellanox ConnectX-5 Family
+ *     carrier up full duplex max-frame-size 9022
+ * local0                             0    down  local0
+ *   Link speed: unknown
+ *   local
+ *
+ * A block starts with an unindented line naming the interface (its Idx
+ * column is the hw_if_index, not the sw_if_index); detail lines are
+ * indented.
  */
-static int get_interface_mac(const char *ifname, uint8_t *mac) {
-  char cmd[128];
-  char *response;
 
-  snprintf(cmd, sizeof(cmd), "show hardware-interfaces %s", ifname);
-  response = vpp_cli_exec(cmd);
+/* "100 Gbps", "2.5 Gbps", "100 Mbps", "unknown" -> Mbps, 0 if unknown */
+static uint32_t parse_link_speed(vpp_slice_t s) {
+  vpp_slice_t num;
+  vpp_slice_t unit;
+  uint64_t whole;
+  uint64_t frac;
+  double val;
+
+  if (!vpp_tok_field(&s, &num) || !vpp_tok_field(&s, &unit) ||
+      !vpp_tok_u64(&num, &whole))
+    return 0;
+  val = (double)whole;
+  if (vpp_tok_skip(&num, ".")) {
+    size_t digits = num.len;
+    if (vpp_tok_u64(&num, &frac)) {
+      double div = 1;
+      for (digits -= num.len; digits > 0; digits--)
+        div *= 10;
+      val += (double)frac / div;
+    }
+  }
+  if (unit.ptr[0] == 'T')
+    val *= 1000000;
+  else if (unit.ptr[0] == 'G')
+    val *= 1000;
+  else if (unit.ptr[0] == 'K')
+    val /= 1000;
+  return (uint32_t)val;
+}
 
-  if (response) {
-    /* Look for Ethernet address: xx:xx:xx:xx:xx:xx */
-    char *p = strstr(response, "Ethernet address ");
-    if (p) {
-      p += strlen("Ethernet address ");
-      if (sscanf(p, "%02hhx:%02hhx:%02hhx:%02hhx:%02hhx:%02hhx", &mac[0],
-                 &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]) == 6) {
-        free(response);
-        return 0;
-      }
+static void parse_hw_detail(vpp_if_hot_t *hot, vpp_if_cold_t *cold,
+                            vpp_slice_t line) {
+  size_t indent = vpp_tok_indent(line);
+  vpp_slice_t p = {line.ptr + indent, line.len - indent};
+
+  if (vpp_tok_skip(&p, "Link speed:")) {
+    hot->link_speed = parse_link_speed(p);
+  } else if (vpp_tok_skip(&p, "Ethernet address ")) {
+    /* Own copy: sscanf() takes strlen() of the rest of the output */
+    char mac[24];
+    vpp_slice_t word;
+    if (vpp_tok_field(&p, &word)) {
+      vpp_tok_copy(word, mac, sizeof(mac));
+      vpp_mac_string_to_bytes(mac, cold->mac);
     }
-    free(response);
+  } else if (vpp_tok_prefix(p, "carrier ")) {
+    const char *d = vpp_tok_find(p, " duplex");
+    if (d && d - p.ptr >= 4 && strncmp(d - 4, "full", 4) == 0)
+      hot->link_duplex = VPP_LINK_DUPLEX_FULL;
+    else if (d && d - p.ptr >= 4 && strncmp(d - 4, "half", 4) == 0)
+      hot->link_duplex = VPP_LINK_DUPLEX_HALF;
+  } else if (indent == 2 && !cold->driver[0] && p.len > 0 &&
+             !vpp_tok_has(p, ':')) {
+    /* Device class line, e.g. "Mellanox ConnectX-5 Family" or "local" */
+    vpp_tok_copy(vpp_tok_trim(p), cold->driver, sizeof(cold->driver));
   }
+}
 
-  memset(mac, 0, 6);
-  return -1;
+static void parse_show_hardware(const char *output, vpp_if_table_t *t) {
+  uint32_t idx = VPP_IF_NONE;
+  vpp_tok_t tok;
+  vpp_slice_t line;
+
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    if (line.len > 0 && vpp_tok_indent(line) == 0) {
+      /* Block header; the title line matches no interface */
+      vpp_slice_t name;
+      vpp_tok_field(&line, &name);
+      idx = if_table_find_n(t, name.ptr, name.len);
+    } else if (idx != VPP_IF_NONE && line.len > 0) {
+      parse_hw_detail(&t->hot[idx], &t->cold[idx], line);
+    }
+  }
+
+  /* Sub-interfaces have no hardware block: take the parent's */
+  for (idx = 0; idx < t->max; idx++) {
+    uint32_t sup = t->hot[idx].sup_sw_if_index;
+
+    if (!(t->hot[idx].flags & VPP_IF_F_PRESENT) || sup == idx)
+      continue;
+    memcpy(t->cold[idx].mac, t->cold[sup].mac, sizeof(t->cold[idx].mac));
+    t->hot[idx].link_speed = t->hot[sup].link_speed;
+    t->hot[idx].link_duplex = t->hot[sup].link_duplex;
+  }
 }
 
-int vpp_interface_dump(vpp_interface_info_t **interfaces) {
+/*
+ * Interface table from "show interface" only: names, indexes, state, MTU
+ */
+int vpp_interface_dump_brief(vpp_if_table_t *t) {
   char *response;
   int ret;
 
-  if (!interfaces) {
+  if (!t) {
     return -1;
   }
-  *interfaces = NULL;
 
   /* Execute "show interface" command */
   response = vpp_cli_exec("show interface");
@@ -207,66 +347,125 @@ int vpp_interface_dump(vpp_interface_info_t **interfaces) {
   }
 
   /* Parse response */
-  ret = parse_show_interface(response, interfaces);
+  ret = parse_show_interface(response, t);
   free(response);
 
+  return ret;
+}
+
+/*
+ * Full interface table: "show interface" plus one bulk
+ * "show hardware-interfaces" for MAC, link speed, duplex and driver
+ */
+int vpp_interface_dump(vpp_if_table_t *t) {
+  char *response;
+  int ret = vpp_interface_dump_brief(t);
+
   if (ret != 0) {
     return ret;
   }
 
-  /* Optionally get MAC addresses for each interface */
-  vpp_interface_info_t *iface;
-  for (iface = *interfaces; iface; iface = iface->next) {
-    if (strcmp(iface->type, "local") != 0) {
-      get_interface_mac(iface->name, iface->mac);
-    }
+  response = vpp_cli_exec("show hardware-interfaces");
+  if (!response) {
+    fprintf(stderr, "[vpp] Failed to execute 'show hardware-interfaces'\n");
+    return 0; /* Brief data is still valid */
   }
+  parse_show_hardware(response, t);
+  free(response);
 
   return 0;
 }
 
-void vpp_interface_list_free(vpp_interface_info_t *list) {
-  vpp_interface_info_t *curr, *next;
-  for (curr = list; curr; curr = next) {
-    next = curr->next;
-    free(curr);
+/*
+ * Parse "show bond details" member lists into bond_sw_if_index
+ *
+ * Example output:
+ * BondEthernet0
+ *   mode: lacp
+ *   load balance: l2
+ *   number of active members: 1
+ *     TenGigabitEthernet3/0/0
+ *   number of members: 2
+ *     TenGigabitEthernet3/0/0
+ *     TenGigabitEthernet3/0/1
+ *   device instance: 0
+ */
+static void parse_show_bond_members(const char *output, vpp_if_table_t *t) {
+  uint32_t bond = VPP_IF_NONE;
+  bool in_members = false;
+  vpp_tok_t tok;
+  vpp_slice_t line;
+
+  vpp_tok_init_str(&tok, output);
+  while (vpp_tok_line(&tok, &line)) {
+    size_t indent = vpp_tok_indent(line);
+    vpp_slice_t name;
+
+    if (line.len > 0 && indent == 0) {
+      vpp_tok_field(&line, &name);
+      bond = if_table_find_n(t, name.ptr, name.len);
+      in_members = false;
+    } else if (indent == 2) {
+      in_members = vpp_tok_prefix(vpp_tok_trim(line), "number of members:");
+    } else if (in_members && bond != VPP_IF_NONE && indent > 2 &&
+               vpp_tok_field(&line, &name)) {
+      uint32_t m = if_table_find_n(t, name.ptr, name.len);
+      if (m != VPP_IF_NONE)
+        t->hot[m].bond_sw_if_index = bond;
+    }
   }
 }
 
-uint32_t vpp_interface_name_to_index(const char *name) {
-  vpp_interface_info_t *list, *curr;
-  uint32_t idx = (uint32_t)-1;
-
-  if (vpp_interface_dump(&list) == 0) {
-    for (curr = list; curr; curr = curr->next) {
-      if (strcmp(curr->name, name) == 0) {
-        idx = curr->sw_if_index;
-        break;
-      }
-    }
-    vpp_interface_list_free(list);
+static vpp_if_table_t snap;
+static bool snap_valid = false;
+static uint64_t snap_epoch = 0;
+static uint64_t snap_changes = 0;
+static long long snap_ms = 0;
+
+static long long now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+const vpp_if_table_t *vpp_interface_snapshot(void) {
+  char *response;
+
+  if (snap_valid && snap_epoch == vpp_connection_epoch() &&
+      snap_changes == vpp_ifcache_changes() &&
+      now_ms() - snap_ms < VPP_SNAPSHOT_TTL_MS)
+    return &snap;
+
+  snap_valid = false;
+  if (vpp_interface_dump_brief(&snap) != 0)
+    return NULL;
+  vpp_ifcache_sync(&snap);
+  response = vpp_cli_exec("show bond details");
+  if (response) {
+    parse_show_bond_members(response, &snap);
+    free(response);
   }
-  return idx;
+
+  snap_valid = true;
+  snap_epoch = vpp_connection_epoch();
+  snap_changes = vpp_ifcache_changes();
+  snap_ms = now_ms();
+  return &snap;
+}
+
+void vpp_interface_snapshot_invalidate(void) { snap_valid = false; }
+
+uint32_t vpp_interface_name_to_index(const char *name) {
+  return vpp_ifcache_name_to_index(name);
 }
 
 int vpp_interface_set_flags(uint32_t sw_if_index, bool admin_up) {
   char cmd[256];
-  vpp_interface_info_t *list, *curr;
-  const char *ifname = NULL;
+  char ifname[64];
 
   /* Find interface name by index */
-  if (vpp_interface_dump(&list) == 0) {
-    for (curr = list; curr; curr = curr->next) {
-      if (curr->sw_if_index == sw_if_index) {
-        ifname = curr->name;
-        break;
-      }
-    }
-  }
-
-  if (!ifname) {
+  if (vpp_ifcache_index_to_name(sw_if_index, ifname, sizeof(ifname)) != 0) {
     fprintf(stderr, "[vpp] Interface with index %u not found\n", sw_if_index);
-    vpp_interface_list_free(list);
     return -1;
   }
 
@@ -274,37 +473,22 @@ int vpp_interface_set_flags(uint32_t sw_if_index, bool admin_up) {
   snprintf(cmd, sizeof(cmd), "set interface state %s %s", ifname,
            admin_up ? "up" : "down");
 
-  vpp_interface_list_free(list);
-
   return vpp_cli_exec_check(cmd);
 }
 
 int vpp_interface_set_mtu(uint32_t sw_if_index, uint16_t mtu) {
   char cmd[256];
-  vpp_interface_info_t *list, *curr;
-  const char *ifname = NULL;
+  char ifname[64];
 
   /* Find interface name by index */
-  if (vpp_interface_dump(&list) == 0) {
-    for (curr = list; curr; curr = curr->next) {
-      if (curr->sw_if_index == sw_if_index) {
-        ifname = curr->name;
-        break;
-      }
-    }
-  }
-
-  if (!ifname) {
+  if (vpp_ifcache_index_to_name(sw_if_index, ifname, sizeof(ifname)) != 0) {
     fprintf(stderr, "[vpp] Interface with index %u not found\n", sw_if_index);
-    vpp_interface_list_free(list);
     return -1;
   }
 
   /* Build command: set interface mtu <mtu> <name> */
   snprintf(cmd, sizeof(cmd), "set interface mtu %u %s", mtu, ifname);
 
-  vpp_interface_list_free(list);
-
   return vpp_cli_exec_check(cmd);
 }
 
@@ -312,22 +496,11 @@ int vpp_interface_add_ip4_address(uint32_t sw_if_index, uint32_t address,
                                   uint8_t prefix_len) {
   char cmd[256];
   char ip_str[INET_ADDRSTRLEN];
-  vpp_interface_info_t *list, *curr;
-  const char *ifname = NULL;
+  char ifname[64];
 
   /* Find interface name by index */
-  if (vpp_interface_dump(&list) == 0) {
-    for (curr = list; curr; curr = curr->next) {
-      if (curr->sw_if_index == sw_if_index) {
-        ifname = curr->name;
-        break;
-      }
-    }
-  }
-
-  if (!ifname) {
+  if (vpp_ifcache_index_to_name(sw_if_index, ifname, sizeof(ifname)) != 0) {
     fprintf(stderr, "[vpp] Interface with index %u not found\n", sw_if_index);
-    vpp_interface_list_free(list);
     return -1;
   }
 
@@ -338,8 +511,6 @@ int vpp_interface_add_ip4_address(uint32_t sw_if_index, uint32_t address,
   snprintf(cmd, sizeof(cmd), "set interface ip address %s %s/%u", ifname,
            ip_str, prefix_len);
 
-  vpp_interface_list_free(list);
-
   return vpp_cli_exec_check(cmd);
 }
 
@@ -374,19 +545,14 @@ int vpp_interface_create_loopback(uint32_t *sw_if_index) {
     return -1;
   }
 
+  vpp_ifcache_mark_stale();
+
   /* Parse response: "loop0" or similar */
   if (sw_if_index) {
-    /* Get the interface index */
-    vpp_interface_info_t *list, *curr;
-    if (vpp_interface_dump(&list) == 0) {
-      /* Find the newest loop interface */
-      for (curr = list; curr; curr = curr->next) {
-        if (strncmp(curr->name, "loop", 4) == 0) {
-          *sw_if_index = curr->sw_if_index;
-        }
-      }
-      vpp_interface_list_free(list);
-    }
+    char *newline = strchr(response, '\n');
+    if (newline)
+      *newline = '\0';
+    *sw_if_index = vpp_ifcache_name_to_index(response);
   }
 
   free(response);
@@ -400,7 +566,11 @@ int vpp_interface_delete_loopback(const char *ifname) {
   char cmd[256];
 
   snprintf(cmd, sizeof(cmd), "delete loopback interface intfc %s", ifname);
-  return vpp_cli_exec_check(cmd);
+  if (vpp_cli_exec_check(cmd) != 0) {
+    return -1;
+  }
+  vpp_ifcache_remove(ifname);
+  return 0;
 }
 
 /*
@@ -465,6 +635,7 @@ int vpp_interface_create_loopback_mac(const char *mac_str, char *ifname_out,
     ifname_out[ifname_len - 1] = '\0';
   }
 
+  vpp_ifcache_mark_stale();
   free(response);
   return 0;
 }
@@ -515,6 +686,7 @@ int vpp_interface_create_subif(const char *parent_ifname, uint16_t vlan_id,
     snprintf(ifname_out, ifname_len, "%s.%u", parent_ifname, sub_id);
   }
 
+  vpp_ifcache_mark_stale();
   free(response);
   return 0;
 }
@@ -533,7 +705,11 @@ int vpp_interface_delete_subif(const char *ifname) {
   snprintf(cmd, sizeof(cmd), "delete sub-interface %s", ifname);
   fprintf(stderr, "[vpp] Deleting sub-interface: %s\n", cmd);
 
-  return vpp_cli_exec_check(cmd);
+  if (vpp_cli_exec_check(cmd) != 0) {
+    return -1;
+  }
+  vpp_ifcache_remove(ifname);
+  return 0;
 }
 
 /*
@@ -582,6 +758,7 @@ int vpp_interface_create_qinq_subif(const char *parent_ifname,
     snprintf(ifname_out, ifname_len, "%s.%u", parent_ifname, sub_id);
   }
 
+  vpp_ifcache_mark_stale();
   free(response);
   return 0;
 }
@@ -653,6 +830,7 @@ int vpp_interface_create_bond(const char *mode, const char *lb,
     ifname_out[ifname_len - 1] = '\0';
   }
 
+  vpp_ifcache_mark_stale();
   free(response);
   return 0;
 }
@@ -670,7 +848,11 @@ int vpp_interface_delete_bond(const char *ifname) {
   snprintf(cmd, sizeof(cmd), "delete bond %s", ifname);
   fprintf(stderr, "[vpp] Deleting bond: %s\n", cmd);
 
-  return vpp_cli_exec_check(cmd);
+  if (vpp_cli_exec_check(cmd) != 0) {
+    return -1;
+  }
+  vpp_ifcache_remove(ifname);
+  return 0;
 }
 
 /*
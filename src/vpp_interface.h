@@ -9,24 +9,76 @@
 #include <stddef.h>
 #include <stdint.h>
 
-/* Interface information structure */
-typedef struct vpp_interface_info {
+/* Link duplex, from "show hardware-interfaces" */
+typedef enum {
+  VPP_LINK_DUPLEX_UNKNOWN = 0,
+  VPP_LINK_DUPLEX_FULL,
+  VPP_LINK_DUPLEX_HALF,
+} vpp_link_duplex_t;
+
+/* vpp_if_hot_t flags */
+#define VPP_IF_F_PRESENT 0x01 /* Slot holds an interface */
+#define VPP_IF_F_ADMIN_UP 0x02
+#define VPP_IF_F_LINK_UP 0x04
+
+/* Per-interface numeric state, scanned on every poll */
+typedef struct {
   uint32_t sw_if_index;
-  uint32_t sup_sw_if_index;
+  uint32_t sup_sw_if_index; /* Parent for sub-interfaces, else itself */
+  uint32_t bond_sw_if_index; /* Bond it is a member of, or VPP_IF_NONE */
+  uint32_t mtu;
+  uint32_t link_speed;      /* Mbps, 0 = unknown */
+  uint8_t flags;            /* VPP_IF_F_* */
+  uint8_t link_duplex;      /* vpp_link_duplex_t */
+} vpp_if_hot_t;
+
+/* Per-interface strings, only touched when rendering */
+typedef struct {
   char name[64];
   char type[32];
+  char driver[48];          /* Device class, e.g. "Mellanox ConnectX-5 Family" */
   uint8_t mac[6];
-  uint32_t mtu;
-  uint32_t link_speed;
-  bool admin_up;
-  bool link_up;
-  struct vpp_interface_info *next;
-} vpp_interface_info_t;
+} vpp_if_cold_t;
+
+/*
+ * Interface table indexed by sw_if_index
+ *
+ * hot[i] / cold[i] describe sw_if_index i when hot[i].flags has
+ * VPP_IF_F_PRESENT. The arrays only grow and are kept across dumps, so
+ * a steady-state poll allocates nothing. Zero-initialise before first
+ * use, release with vpp_if_table_free().
+ */
+typedef struct {
+  vpp_if_hot_t *hot;
+  vpp_if_cold_t *cold;
+  uint32_t cap;    /* Slots allocated */
+  uint32_t max;    /* Highest present sw_if_index + 1 */
+  uint32_t count;  /* Present interfaces */
+  uint32_t *hash;  /* name -> sw_if_index + 1, open addressing */
+  uint32_t hsize;  /* Power of two */
+  uint32_t hfill;
+} vpp_if_table_t;
+
+#define VPP_IF_NONE ((uint32_t)-1)
+
+static inline bool vpp_if_present(const vpp_if_table_t *t, uint32_t idx) {
+  return idx < t->max && (t->hot[idx].flags & VPP_IF_F_PRESENT);
+}
 
 /* Interface operations */
-int vpp_interface_dump(vpp_interface_info_t **interfaces);
-void vpp_interface_list_free(vpp_interface_info_t *list);
-uint32_t vpp_interface_name_to_index(const char *name);
+int vpp_interface_dump(vpp_if_table_t *t);       /* Incl. hardware data */
+int vpp_interface_dump_brief(vpp_if_table_t *t); /* "show interface" only */
+uint32_t vpp_if_table_find(const vpp_if_table_t *t, const char *name);
+void vpp_if_table_free(vpp_if_table_t *t);
+uint32_t vpp_interface_name_to_index(const char *name); /* Cached */
+
+/* Cached brief table plus bond membership, for validating changes
+ * before they are sent. Refreshed when older than
+ * VPP_SNAPSHOT_TTL_MS, after VPP restarted or after interfaces were
+ * created or deleted; NULL if VPP cannot be read. */
+#define VPP_SNAPSHOT_TTL_MS 1000
+const vpp_if_table_t *vpp_interface_snapshot(void);
+void vpp_interface_snapshot_invalidate(void);
 
 int vpp_interface_set_flags(uint32_t sw_if_index, bool admin_up);
 int vpp_interface_set_mtu(uint32_t sw_if_index, uint16_t mtu);
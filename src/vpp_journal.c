@@ -0,0 +1,111 @@
+/*
+ * vpp_journal.c - Rollback journal for applied VPP operations
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "vpp_journal.h"
+
+void vpp_journal_init(vpp_journal_t *j) {
+  vpp_op_queue_init(&j->undo);
+  j->lost = 0;
+}
+
+void vpp_journal_free(vpp_journal_t *j) {
+  vpp_op_queue_free(&j->undo);
+  j->lost = 0;
+}
+
+/* Queue the inverse of one applied op
+ * Returns 1 if it has none, 0 if queued or nothing to undo, -1 on error */
+static int journal_invert(vpp_journal_t *j, const vpp_op_t *op,
+                          const vpp_if_table_t *snap) {
+  uint32_t idx = snap ? vpp_if_table_find(snap, op->ifname) : VPP_IF_NONE;
+  uint32_t bond;
+  vpp_op_t *inv;
+
+  switch (op->type) {
+  case VPP_OP_CREATE_BOND:
+    inv = vpp_op_submit(&j->undo, VPP_OP_DELETE_BOND, op->ifname);
+    break;
+  case VPP_OP_CREATE_SUBIF:
+    inv = vpp_op_submit(&j->undo, VPP_OP_DELETE_SUBIF, op->ifname);
+    break;
+  case VPP_OP_CREATE_LCP:
+    inv = vpp_op_submit(&j->undo, VPP_OP_DELETE_LCP, op->ifname);
+    break;
+  case VPP_OP_BOND_ADD_MEMBER:
+    inv = vpp_op_submit(&j->undo, VPP_OP_BOND_DEL_MEMBER, op->ifname);
+    break;
+  case VPP_OP_BOND_DEL_MEMBER:
+    if (idx == VPP_IF_NONE)
+      return 1;
+    if ((bond = snap->hot[idx].bond_sw_if_index) == VPP_IF_NONE)
+      return 0;
+    if ((inv = vpp_op_submit(&j->undo, VPP_OP_BOND_ADD_MEMBER,
+                             op->ifname)) != NULL)
+      snprintf(inv->arg, sizeof(inv->arg), "%s", snap->cold[bond].name);
+    break;
+  case VPP_OP_ADD_ADDR:
+  case VPP_OP_DEL_ADDR:
+    inv = vpp_op_submit(&j->undo,
+                        op->type == VPP_OP_ADD_ADDR ? VPP_OP_DEL_ADDR
+                                                    : VPP_OP_ADD_ADDR,
+                        op->ifname);
+    if (inv)
+      snprintf(inv->arg, sizeof(inv->arg), "%s", op->arg);
+    break;
+  case VPP_OP_SET_DESCRIPTION:
+    inv = vpp_op_submit(&j->undo, op->type, op->ifname);
+    if (inv)
+      snprintf(inv->text, sizeof(inv->text), "%s", op->text_prev);
+    break;
+  case VPP_OP_SET_STATE:
+  case VPP_OP_SET_MTU:
+    /* Not there before: the interface was created by this commit and
+     * deleting it undoes this too */
+    if (idx == VPP_IF_NONE)
+      return 0;
+    if (op->type == VPP_OP_SET_MTU && snap->hot[idx].mtu == 0)
+      return 1;
+    if ((inv = vpp_op_submit(&j->undo, op->type, op->ifname)) != NULL)
+      inv->value = op->type == VPP_OP_SET_MTU
+                       ? snap->hot[idx].mtu
+                       : (snap->hot[idx].flags & VPP_IF_F_ADMIN_UP) != 0;
+    break;
+  default:
+    /* Deletions: bond mode, VLAN or host-if are gone with the interface */
+    return 1;
+  }
+  return inv ? 0 : -1;
+}
+
+int vpp_journal_record(vpp_journal_t *j, const vpp_op_queue_t *q,
+                       const uint32_t *order, const vpp_if_table_t *snap) {
+  for (size_t k = q->len; k-- > 0;) {
+    const vpp_op_t *op = &q->ops[order ? order[k] : k];
+    int rv;
+
+    if (op->rv != 0)
+      continue;
+    if ((rv = journal_invert(j, op, snap)) < 0)
+      return -1;
+    if (rv > 0) {
+      fprintf(stderr, "[vpp] %s on %s cannot be rolled back\n",
+              vpp_op_type_str(op->type), op->ifname);
+      j->lost++;
+    }
+  }
+  return 0;
+}
+
+int vpp_journal_rollback(vpp_journal_t *j) {
+  int failed;
+
+  /* One pipeline on one session keeps the newest-first order */
+  failed = vpp_op_drain(&j->undo);
+  vpp_op_queue_reset(&j->undo);
+  j->lost = 0;
+  return failed;
+}
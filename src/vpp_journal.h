@@ -0,0 +1,44 @@
+/*
+ * vpp_journal.h - Rollback journal for applied VPP operations
+ *
+ * Every op a commit applied records its inverse: delete for create,
+ * the previous MTU, admin state or description for a set, remove for
+ * add-address. Rolling back replays the inverses newest first as one
+ * pipelined batch, so undoing a commit costs what the commit applied,
+ * not the size of the configuration.
+ *
+ * Previous values come from the interface snapshot taken before the
+ * commit ran, descriptions from the op itself. Deletions of bonds,
+ * sub-interfaces and LCP pairs cannot be undone from what the snapshot
+ * knows; they are counted in lost.
+ */
+
+#ifndef _VPP_JOURNAL_H_
+#define _VPP_JOURNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vpp_interface.h"
+#include "vpp_op.h"
+
+typedef struct {
+  vpp_op_queue_t undo; /* Inverses of the applied ops, newest first */
+  size_t lost;         /* Applied ops without an inverse */
+} vpp_journal_t;
+
+void vpp_journal_init(vpp_journal_t *j);
+void vpp_journal_free(vpp_journal_t *j);
+
+/* Journal the inverse of every applied op (rv == 0) of q
+ * order: execution order of q (vpp_plan_t.order), NULL for queue order
+ * snap: interfaces as they were before q ran
+ * Returns 0, -1 on allocation failure */
+int vpp_journal_record(vpp_journal_t *j, const vpp_op_queue_t *q,
+                       const uint32_t *order, const vpp_if_table_t *snap);
+
+/* Replay the journal as one batch and empty it
+ * Returns the number of inverses that failed, -1 if the transport broke */
+int vpp_journal_rollback(vpp_journal_t *j);
+
+#endif /* _VPP_JOURNAL_H_ */
@@ -0,0 +1,285 @@
+/*
+ * vpp_op.c - Queued, pipelined VPP write operations
+ *
+ * Queue handling and CLI rendering are shared by both builds. In
+ * VPP_STUB_MODE the ops are drained as CLI commands pipelined over the
+ * persistent CLI socket session; otherwise vpp_op_vapi.c provides the
+ * transport.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vpp_connection.h"
+#include "vpp_ifcache.h"
+#include "vpp_op.h"
+
+#define VPP_OP_QUEUE_MIN 64
+
+static const char *op_names[] = {
+    [VPP_OP_CREATE_BOND] = "create-bond",
+    [VPP_OP_DELETE_BOND] = "delete-bond",
+    [VPP_OP_BOND_ADD_MEMBER] = "bond-add-member",
+    [VPP_OP_BOND_DEL_MEMBER] = "bond-del-member",
+    [VPP_OP_CREATE_SUBIF] = "create-subif",
+    [VPP_OP_DELETE_SUBIF] = "delete-subif",
+    [VPP_OP_SET_STATE] = "set-state",
+    [VPP_OP_SET_MTU] = "set-mtu",
+    [VPP_OP_ADD_ADDR] = "add-address",
+    [VPP_OP_DEL_ADDR] = "del-address",
+    [VPP_OP_CREATE_LCP] = "create-lcp",
+    [VPP_OP_DELETE_LCP] = "delete-lcp",
+    [VPP_OP_SET_DESCRIPTION] = "set-description",
+};
+
+const char *vpp_op_type_str(vpp_op_type_t type) {
+  if ((size_t)type < sizeof(op_names) / sizeof(op_names[0]) && op_names[type])
+    return op_names[type];
+  return "unknown";
+}
+
+void vpp_op_queue_init(vpp_op_queue_t *q) {
+  memset(q, 0, sizeof(*q));
+  q->next_context = 1;
+}
+
+void vpp_op_queue_reset(vpp_op_queue_t *q) { q->len = 0; }
+
+void vpp_op_queue_free(vpp_op_queue_t *q) {
+  free(q->ops);
+  vpp_op_queue_init(q);
+}
+
+vpp_op_t *vpp_op_submit(vpp_op_queue_t *q, vpp_op_type_t type,
+                        const char *ifname) {
+  vpp_op_t *op;
+
+  if (q->len == q->cap) {
+    size_t cap = q->cap ? q->cap * 2 : VPP_OP_QUEUE_MIN;
+    vpp_op_t *nops = realloc(q->ops, cap * sizeof(*nops));
+    if (!nops)
+      return NULL;
+    q->ops = nops;
+    q->cap = cap;
+  }
+
+  op = &q->ops[q->len++];
+  memset(op, 0, sizeof(*op));
+  op->type = type;
+  op->context = q->next_context++;
+  op->rv = VPP_OP_NOT_SENT;
+  if (ifname)
+    snprintf(op->ifname, sizeof(op->ifname), "%s", ifname);
+  return op;
+}
+
+int vpp_op_drain(vpp_op_queue_t *q) {
+  if (q->len == 0)
+    return 0;
+
+  if (vpp_op_send(q->ops, q->len, 0) < 0) {
+    vpp_ifcache_invalidate();
+    return -1;
+  }
+  return vpp_op_collect(q->ops, q->len);
+}
+
+static uint64_t now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+int vpp_op_send(vpp_op_t *ops, size_t n, unsigned session) {
+  uint64_t start = now_us();
+  int rv = vpp_op_transport_drain(ops, n, session);
+  uint64_t usec = now_us() - start;
+
+  /* Pipelined: every op waited for the whole batch */
+  for (size_t i = 0; i < n; i++)
+    ops[i].usec = usec > UINT32_MAX ? UINT32_MAX : (uint32_t)usec;
+  return rv;
+}
+
+int vpp_op_collect(vpp_op_t *ops, size_t n) {
+  int failed = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    vpp_op_t *op = &ops[i];
+
+    if (op->rv != 0) {
+      /* Maybe VPP no longer has the interface under that name or index */
+      if (failed++ == 0 && op->ifname[0])
+        vpp_ifcache_invalidate();
+      continue;
+    }
+    /* Keep the name <-> index cache in step with what was applied */
+    switch (op->type) {
+    case VPP_OP_CREATE_BOND:
+    case VPP_OP_CREATE_SUBIF:
+      if (vpp_ifcache_name_to_index(op->ifname) == VPP_IFCACHE_NONE)
+        vpp_ifcache_mark_stale();
+      break;
+    case VPP_OP_DELETE_BOND:
+    case VPP_OP_DELETE_SUBIF:
+      vpp_ifcache_remove(op->ifname);
+      break;
+    default:
+      break;
+    }
+  }
+  return failed;
+}
+
+/*
+ * Free-form text, such as a description, goes at the end of a CLI line:
+ * a CR or LF in it would end the command and start another one
+ */
+bool vpp_op_text_ok(const char *text) {
+  for (const unsigned char *p = (const unsigned char *)text; *p; p++)
+    if (*p < 0x20 || *p == 0x7f)
+      return false;
+  return true;
+}
+
+/*
+ * Render an op as a VPP CLI command, same syntax as the synchronous
+ * helpers in vpp_interface.c
+ */
+int vpp_op_format(const vpp_op_t *op, char *buf, size_t len) {
+  int pos = 0;
+
+  switch (op->type) {
+  case VPP_OP_CREATE_BOND:
+    pos = snprintf(buf, len, "create bond mode %s", op->mode);
+    if (op->lb[0] &&
+        (strcmp(op->mode, "lacp") == 0 || strcmp(op->mode, "xor") == 0))
+      pos += snprintf(buf + pos, len - pos, " load-balance %s", op->lb);
+    if (op->mac[0])
+      pos += snprintf(buf + pos, len - pos, " hw-addr %s", op->mac);
+    if (op->value > 0)
+      pos += snprintf(buf + pos, len - pos, " id %u", op->value);
+    break;
+  case VPP_OP_DELETE_BOND:
+    pos = snprintf(buf, len, "delete bond %s", op->ifname);
+    break;
+  case VPP_OP_BOND_ADD_MEMBER:
+    pos = snprintf(buf, len, "bond add %s %s", op->arg, op->ifname);
+    break;
+  case VPP_OP_BOND_DEL_MEMBER:
+    pos = snprintf(buf, len, "bond del %s", op->ifname);
+    break;
+  case VPP_OP_CREATE_SUBIF:
+    pos = snprintf(buf, len, "create sub-interfaces %s %u dot1q %u exact-match",
+                   op->arg, op->value, op->value2);
+    break;
+  case VPP_OP_DELETE_SUBIF:
+    pos = snprintf(buf, len, "delete sub-interface %s", op->ifname);
+    break;
+  case VPP_OP_SET_STATE:
+    pos = snprintf(buf, len, "set interface state %s %s", op->ifname,
+                   op->value ? "up" : "down");
+    break;
+  case VPP_OP_SET_MTU:
+    pos = snprintf(buf, len, "set interface mtu %u %s", op->value, op->ifname);
+    break;
+  case VPP_OP_ADD_ADDR:
+    pos = snprintf(buf, len, "set interface ip address %s %s", op->ifname,
+                   op->arg);
+    break;
+  case VPP_OP_DEL_ADDR:
+    pos = snprintf(buf, len, "set interface ip address del %s %s", op->ifname,
+                   op->arg);
+    break;
+  case VPP_OP_CREATE_LCP:
+    pos = snprintf(buf, len, "lcp create %s host-if %s", op->ifname, op->arg);
+    if (op->arg2[0])
+      pos += snprintf(buf + pos, len - pos, " netns %s", op->arg2);
+    if (op->value)
+      pos += snprintf(buf + pos, len - pos, " tun");
+    break;
+  case VPP_OP_DELETE_LCP:
+    pos = snprintf(buf, len, "lcp delete %s", op->ifname);
+    break;
+  case VPP_OP_SET_DESCRIPTION:
+    if (!vpp_op_text_ok(op->text))
+      return -1;
+    /* Without text VPP clears the description */
+    pos = snprintf(buf, len, "set interface description %s%s%s", op->ifname,
+                   op->text[0] ? " " : "", op->text);
+    break;
+  default:
+    return -1;
+  }
+
+  return (pos > 0 && (size_t)pos < len) ? 0 : -1;
+}
+
+#ifdef VPP_STUB_MODE
+
+/* One CLI session per concurrent drain */
+unsigned vpp_op_transport_sessions(void) { return vpp_cli_sessions(); }
+
+/*
+ * CLI transport: render every op, pipeline the lot over the CLI session
+ * and match the replies back by position.
+ */
+int vpp_op_transport_drain(vpp_op_t *ops, size_t n, unsigned session) {
+  char **cmds;
+  char **replies;
+  int ret = 0;
+
+  cmds = calloc(n, sizeof(*cmds));
+  replies = calloc(n, sizeof(*replies));
+  if (!cmds || !replies) {
+    free(cmds);
+    free(replies);
+    return -1;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    char cmd[512];
+    if (vpp_op_format(&ops[i], cmd, sizeof(cmd)) < 0 ||
+        (cmds[i] = strdup(cmd)) == NULL) {
+      ret = -1;
+      goto done;
+    }
+  }
+
+  if (vpp_cli_exec_pipelined_on(session, (const char *const *)cmds, n,
+                                 replies) < 0)
+    ret = -1;
+
+  for (size_t i = 0; i < n; i++) {
+    vpp_op_t *op = &ops[i];
+
+    if (!replies[i]) {
+      op->rv = VPP_OP_NOT_SENT;
+      continue;
+    }
+    if (vpp_cli_output_is_error(replies[i])) {
+      char *nl = strchr(replies[i], '\n');
+      if (nl)
+        *nl = '\0';
+      op->rv = -1;
+      snprintf(op->error, sizeof(op->error), "%s", replies[i]);
+      fprintf(stderr, "[vpp] %s (ctx %u) failed: %s: %s\n",
+              vpp_op_type_str(op->type), op->context, cmds[i], op->error);
+    } else {
+      op->rv = 0;
+    }
+  }
+
+done:
+  for (size_t i = 0; i < n; i++) {
+    free(cmds[i]);
+    free(replies[i]);
+  }
+  free(cmds);
+  free(replies);
+  return ret;
+}
+
+#endif /* VPP_STUB_MODE */
@@ -0,0 +1,102 @@
+/*
+ * vpp_op.h - Queued, pipelined VPP write operations
+ *
+ * Write requests are queued as vpp_op_t records and sent in one go by
+ * vpp_op_drain(): nothing waits for a reply before the next request is
+ * on the wire. Each op carries its own context id and result, so a
+ * failure is reported against the request that caused it.
+ *
+ * Transport depends on the build:
+ *   VPP_STUB_MODE - CLI commands pipelined over the CLI socket session
+ *   VAPI          - binary API messages on a non-blocking VAPI context
+ */
+
+#ifndef _VPP_OP_H_
+#define _VPP_OP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Operation types */
+typedef enum {
+  VPP_OP_CREATE_BOND,     /* ifname=BondEthernetN mode lb mac, value=id */
+  VPP_OP_DELETE_BOND,     /* ifname */
+  VPP_OP_BOND_ADD_MEMBER, /* ifname=member, arg=bond */
+  VPP_OP_BOND_DEL_MEMBER, /* ifname=member */
+  VPP_OP_CREATE_SUBIF,    /* ifname=parent.sub, arg=parent, value=sub, value2=vlan */
+  VPP_OP_DELETE_SUBIF,    /* ifname */
+  VPP_OP_SET_STATE,       /* ifname, value=admin up */
+  VPP_OP_SET_MTU,         /* ifname, value=mtu, value2=previous, 0 unknown */
+  VPP_OP_ADD_ADDR,        /* ifname, arg=address/prefix */
+  VPP_OP_DEL_ADDR,        /* ifname, arg=address/prefix */
+  VPP_OP_CREATE_LCP,      /* ifname, arg=host-if, arg2=netns, value=tun */
+  VPP_OP_DELETE_LCP,      /* ifname */
+  VPP_OP_SET_DESCRIPTION, /* ifname, text, text_prev=replaced text */
+} vpp_op_type_t;
+
+/* Result of an op that never reached VPP (transport failure) */
+#define VPP_OP_NOT_SENT (-2)
+
+/* One write request */
+typedef struct {
+  vpp_op_type_t type;
+  uint32_t context;  /* Unique per queue, assigned on submit */
+  char ifname[64];   /* Interface the op acts on */
+  char arg[128];
+  char arg2[64];
+  char mode[16];     /* Bond mode */
+  char lb[8];        /* Bond load-balance */
+  char mac[18];      /* Bond hw-addr */
+  uint32_t value;
+  uint32_t value2;
+  char text[257];      /* Interface description */
+  char text_prev[257]; /* Description it replaces, for rollback */
+  int rv;            /* 0 ok, -1 rejected by VPP, VPP_OP_NOT_SENT */
+  char error[128];   /* VPP's reason when rv != 0 */
+  uint32_t usec;     /* Duration of the drain that carried it */
+} vpp_op_t;
+
+/* A batch of ops, drained as one pipeline */
+typedef struct {
+  vpp_op_t *ops;
+  size_t len;
+  size_t cap;
+  uint32_t next_context;
+} vpp_op_queue_t;
+
+/* Queue management */
+void vpp_op_queue_init(vpp_op_queue_t *q);
+void vpp_op_queue_reset(vpp_op_queue_t *q);
+void vpp_op_queue_free(vpp_op_queue_t *q);
+
+/* Append an op; returns the zeroed slot with type, ifname and context set */
+vpp_op_t *vpp_op_submit(vpp_op_queue_t *q, vpp_op_type_t type,
+                        const char *ifname);
+
+/* Send every queued op, collect all replies
+ * Returns the number of failed ops (0 = all applied), -1 if the transport
+ * broke; per-op outcome is in op->rv / op->error */
+int vpp_op_drain(vpp_op_queue_t *q);
+
+/* Drain ops on one transport session and stamp op->usec
+ * Returns what vpp_op_transport_drain() returns */
+int vpp_op_send(vpp_op_t *ops, size_t n, unsigned session);
+
+/* Bookkeeping after ops were drained (interface cache upkeep)
+ * Must run on the calling thread; returns the number of failed ops */
+int vpp_op_collect(vpp_op_t *ops, size_t n);
+
+/* Render an op as the equivalent VPP CLI command
+ * Fails on text that would not stay on one CLI line */
+int vpp_op_format(const vpp_op_t *op, char *buf, size_t len);
+bool vpp_op_text_ok(const char *text); /* No control characters */
+const char *vpp_op_type_str(vpp_op_type_t type);
+
+/* Transport backend, one per build (vpp_op.c / vpp_op_vapi.c)
+ * Sessions 0 .. vpp_op_transport_sessions()-1 can drain concurrently
+ * from different threads; session 0 is the one vpp_op_drain() uses. */
+unsigned vpp_op_transport_sessions(void);
+int vpp_op_transport_drain(vpp_op_t *ops, size_t n, unsigned session);
+
+#endif /* _VPP_OP_H_ */
@@ -0,0 +1,433 @@
+/*
+ * vpp_op_vapi.c - VAPI transport for queued VPP write operations
+ *
+ * Ops are sent on a dedicated non-blocking VAPI context. VAPI stamps
+ * each request with its own context id and routes the reply to the
+ * callback registered with it, so all requests go out back to back and
+ * one vapi_dispatch() collects the replies. Names are resolved through
+ * the interface cache; only an op naming an interface created earlier
+ * in the same batch has to wait, until the create reply has told us
+ * (and the cache) its sw_if_index.
+ *
+ * Built instead of the CLI transport in vpp_op.c when VPP_STUB_MODE is
+ * not defined (make VPP_API=vapi).
+ */
+
+#ifndef VPP_STUB_MODE
+
+#include <arpa/inet.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vapi/vapi.h>
+#include <vapi/interface.api.vapi.h>
+#include <vapi/bond.api.vapi.h>
+#include <vapi/lcp.api.vapi.h>
+#include <vapi/vlib.api.vapi.h>
+
+#include "vpp_connection.h"
+#include "vpp_ifcache.h"
+#include "vpp_op.h"
+#include "vpp_tstats.h"
+
+/* Message ids are defined once, by the DEFINE_VAPI_MSG_IDS_* in
+ * vpp_api_vapi.c; the headers above only declare them */
+
+#define OP_MAX_OUTSTANDING 1024
+#define OP_RESPONSE_QUEUE 1024
+
+static vapi_ctx_t op_ctx = NULL;
+static bool op_connected = false;
+
+static const char *bond_mode_names[] = {"round-robin", "active-backup", "xor",
+                                        "broadcast", "lacp"};
+static const char *bond_lb_names[] = {"l2", "l34", "l23", "rr", "bc", "ab"};
+
+static int op_connect(void) {
+  vapi_error_e rv;
+
+  if (op_connected)
+    return 0;
+  if (!op_ctx && vapi_ctx_alloc(&op_ctx) != VAPI_OK) {
+    op_ctx = NULL;
+    return -1;
+  }
+  rv = vapi_connect(op_ctx, "clixon-vpp-ops", NULL, OP_MAX_OUTSTANDING,
+                    OP_RESPONSE_QUEUE, VAPI_MODE_NONBLOCKING, true);
+  if (rv != VAPI_OK) {
+    fprintf(stderr, "[vpp-op] vapi_connect failed: %d\n", rv);
+    return -1;
+  }
+  op_connected = true;
+  return 0;
+}
+
+static int str_index(const char *s, const char **tbl, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (strcmp(s, tbl[i]) == 0)
+      return (int)i;
+  }
+  return -1;
+}
+
+static int op_parse_prefix(const char *str, vapi_type_prefix *prefix) {
+  char ip[64];
+  const char *slash = strchr(str, '/');
+  size_t iplen;
+
+  if (!slash)
+    return -1;
+  iplen = (size_t)(slash - str);
+  if (iplen >= sizeof(ip))
+    return -1;
+  memcpy(ip, str, iplen);
+  ip[iplen] = '\0';
+
+  memset(prefix, 0, sizeof(*prefix));
+  prefix->len = (uint8_t)atoi(slash + 1);
+  if (inet_pton(AF_INET, ip, prefix->address.un.ip4) == 1) {
+    prefix->address.af = ADDRESS_IP4;
+    return 0;
+  }
+  if (inet_pton(AF_INET6, ip, prefix->address.un.ip6) == 1) {
+    prefix->address.af = ADDRESS_IP6;
+    return 0;
+  }
+  return -1;
+}
+
+static int op_parse_mac(const char *str, uint8_t *mac) {
+  unsigned int b[6];
+
+  if (sscanf(str, "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3], &b[4],
+             &b[5]) != 6)
+    return -1;
+  for (int i = 0; i < 6; i++)
+    mac[i] = (uint8_t)b[i];
+  return 0;
+}
+
+/*
+ * Reply handling
+ */
+
+/* Transport statistics, verb "api <op type>" */
+static void op_record(const vpp_op_t *op, bool error) {
+  char verb[32];
+
+  /* op->usec holds the send stamp until vpp_op_send() sets the total */
+  snprintf(verb, sizeof(verb), "api %s", vpp_op_type_str(op->type));
+  vpp_tstats_record(verb, (uint32_t)vpp_tstats_now_usec() - op->usec, 0,
+                    error);
+}
+
+static void op_complete(vpp_op_t *op, vapi_error_e rv, int retval,
+                        uint32_t sw_if_index) {
+  op_record(op, rv != VAPI_OK || retval != 0);
+  if (rv != VAPI_OK) {
+    op->rv = -1;
+    snprintf(op->error, sizeof(op->error), "VAPI error %d", rv);
+  } else if (retval != 0) {
+    op->rv = -1;
+    snprintf(op->error, sizeof(op->error), "VPP API retval %d", retval);
+  } else {
+    op->rv = 0;
+    if (sw_if_index != (uint32_t)~0)
+      vpp_ifcache_add(op->ifname, sw_if_index);
+  }
+  if (op->rv != 0)
+    fprintf(stderr, "[vpp-op] %s %s (ctx %u) failed: %s\n",
+            vpp_op_type_str(op->type), op->ifname, op->context, op->error);
+}
+
+#define OP_REPLY_CB(m)                                                         \
+  static vapi_error_e op_##m##_cb(struct vapi_ctx_s *ctx, void *cctx,          \
+                                  vapi_error_e rv, bool is_last,               \
+                                  vapi_payload_##m *reply) {                   \
+    (void)ctx;                                                                 \
+    (void)is_last;                                                             \
+    op_complete(cctx, rv, reply ? reply->retval : -1, ~0);                     \
+    return VAPI_OK;                                                            \
+  }
+
+#define OP_CREATE_REPLY_CB(m)                                                  \
+  static vapi_error_e op_##m##_cb(struct vapi_ctx_s *ctx, void *cctx,          \
+                                  vapi_error_e rv, bool is_last,               \
+                                  vapi_payload_##m *reply) {                   \
+    (void)ctx;                                                                 \
+    (void)is_last;                                                             \
+    op_complete(cctx, rv, reply ? reply->retval : -1,                          \
+                reply ? reply->sw_if_index : ~0);                              \
+    return VAPI_OK;                                                            \
+  }
+
+OP_CREATE_REPLY_CB(bond_create2_reply)
+OP_REPLY_CB(bond_delete_reply)
+OP_REPLY_CB(bond_add_member_reply)
+OP_REPLY_CB(bond_detach_member_reply)
+OP_CREATE_REPLY_CB(create_subif_reply)
+OP_REPLY_CB(delete_subif_reply)
+OP_REPLY_CB(sw_interface_set_flags_reply)
+OP_REPLY_CB(sw_interface_set_mtu_reply)
+OP_REPLY_CB(sw_interface_add_del_address_reply)
+OP_REPLY_CB(lcp_itf_pair_add_del_v2_reply)
+
+/* No binary API for it: the CLI text rides in cli_inband, and a CLI
+ * error comes back as reply text with retval 0 */
+static vapi_error_e
+op_cli_inband_reply_cb(struct vapi_ctx_s *ctx, void *cctx, vapi_error_e rv,
+                       bool is_last, vapi_payload_cli_inband_reply *reply) {
+  vpp_op_t *op = cctx;
+  (void)ctx;
+  (void)is_last;
+
+  if (rv == VAPI_OK && reply && reply->retval == 0 &&
+      reply->reply.length > 0) {
+    char text[sizeof(op->error)];
+    snprintf(text, sizeof(text), "%.*s", (int)reply->reply.length,
+             (const char *)reply->reply.buf);
+    if (vpp_cli_output_is_error(text)) {
+      op_record(op, true);
+      op->rv = -1;
+      snprintf(op->error, sizeof(op->error), "%s", text);
+      fprintf(stderr, "[vpp-op] %s %s (ctx %u) failed: %s\n",
+              vpp_op_type_str(op->type), op->ifname, op->context, op->error);
+      return VAPI_OK;
+    }
+  }
+  op_complete(op, rv, reply ? reply->retval : -1, ~0);
+  return VAPI_OK;
+}
+
+/*
+ * Sending
+ *
+ * A full request ring makes the generated senders return VAPI_EAGAIN
+ * without consuming the message; dispatch one reply and try again.
+ */
+#define OP_SEND(m, msg, op)                                                    \
+  do {                                                                         \
+    while ((rv = vapi_##m(op_ctx, msg, op_##m##_reply_cb, op)) == VAPI_EAGAIN) \
+      vapi_dispatch_one(op_ctx);                                               \
+    if (rv != VAPI_OK)                                                         \
+      vapi_msg_free(op_ctx, msg);                                              \
+  } while (0)
+
+/* Interfaces an op needs to exist; NULL entries are not needed */
+static void op_requires(const vpp_op_t *op, const char **a, const char **b) {
+  *a = *b = NULL;
+  switch (op->type) {
+  case VPP_OP_CREATE_BOND:
+    break;
+  case VPP_OP_CREATE_SUBIF:
+    *a = op->arg;
+    break;
+  case VPP_OP_BOND_ADD_MEMBER:
+    *a = op->ifname;
+    *b = op->arg;
+    break;
+  default:
+    *a = op->ifname;
+    break;
+  }
+}
+
+static vapi_error_e op_send(vpp_op_t *op) {
+  vapi_error_e rv = VAPI_OK;
+  uint32_t idx = VPP_IFCACHE_NONE;
+
+  /* A bond being created has no index yet; don't make its name miss */
+  if (op->type == VPP_OP_CREATE_SUBIF)
+    idx = vpp_ifcache_name_to_index(op->arg);
+  else if (op->type != VPP_OP_CREATE_BOND)
+    idx = vpp_ifcache_name_to_index(op->ifname);
+
+  switch (op->type) {
+  case VPP_OP_CREATE_BOND: {
+    vapi_msg_bond_create2 *msg = vapi_alloc_bond_create2(op_ctx);
+    int mode = str_index(op->mode, bond_mode_names, 5);
+    int lb = op->lb[0] ? str_index(op->lb, bond_lb_names, 6) : 0;
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.mode = mode < 0 ? BOND_API_MODE_LACP : mode + 1;
+    msg->payload.lb = lb < 0 ? BOND_API_LB_ALGO_L2 : lb;
+    msg->payload.id = op->value > 0 ? op->value : ~0;
+    if (op->mac[0] && op_parse_mac(op->mac, msg->payload.mac_address) == 0)
+      msg->payload.use_custom_mac = true;
+    OP_SEND(bond_create2, msg, op);
+    break;
+  }
+  case VPP_OP_DELETE_BOND: {
+    vapi_msg_bond_delete *msg = vapi_alloc_bond_delete(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    OP_SEND(bond_delete, msg, op);
+    break;
+  }
+  case VPP_OP_BOND_ADD_MEMBER: {
+    vapi_msg_bond_add_member *msg = vapi_alloc_bond_add_member(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    msg->payload.bond_sw_if_index = vpp_ifcache_name_to_index(op->arg);
+    OP_SEND(bond_add_member, msg, op);
+    break;
+  }
+  case VPP_OP_BOND_DEL_MEMBER: {
+    vapi_msg_bond_detach_member *msg = vapi_alloc_bond_detach_member(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    OP_SEND(bond_detach_member, msg, op);
+    break;
+  }
+  case VPP_OP_CREATE_SUBIF: {
+    vapi_msg_create_subif *msg = vapi_alloc_create_subif(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    msg->payload.sub_id = op->value;
+    msg->payload.sub_if_flags =
+        SUB_IF_API_FLAG_ONE_TAG | SUB_IF_API_FLAG_EXACT_MATCH;
+    msg->payload.outer_vlan_id = (uint16_t)op->value2;
+    OP_SEND(create_subif, msg, op);
+    break;
+  }
+  case VPP_OP_DELETE_SUBIF: {
+    vapi_msg_delete_subif *msg = vapi_alloc_delete_subif(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    OP_SEND(delete_subif, msg, op);
+    break;
+  }
+  case VPP_OP_SET_STATE: {
+    vapi_msg_sw_interface_set_flags *msg =
+        vapi_alloc_sw_interface_set_flags(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    msg->payload.flags = op->value ? IF_STATUS_API_FLAG_ADMIN_UP : 0;
+    OP_SEND(sw_interface_set_flags, msg, op);
+    break;
+  }
+  case VPP_OP_SET_MTU: {
+    vapi_msg_sw_interface_set_mtu *msg =
+        vapi_alloc_sw_interface_set_mtu(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.sw_if_index = idx;
+    for (int i = 0; i < 4; i++)
+      msg->payload.mtu[i] = op->value;
+    OP_SEND(sw_interface_set_mtu, msg, op);
+    break;
+  }
+  case VPP_OP_ADD_ADDR:
+  case VPP_OP_DEL_ADDR: {
+    vapi_msg_sw_interface_add_del_address *msg =
+        vapi_alloc_sw_interface_add_del_address(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    if (op_parse_prefix(op->arg, &msg->payload.prefix) < 0) {
+      vapi_msg_free(op_ctx, msg);
+      return VAPI_EINVAL;
+    }
+    msg->payload.sw_if_index = idx;
+    msg->payload.is_add = op->type == VPP_OP_ADD_ADDR;
+    OP_SEND(sw_interface_add_del_address, msg, op);
+    break;
+  }
+  case VPP_OP_CREATE_LCP:
+  case VPP_OP_DELETE_LCP: {
+    vapi_msg_lcp_itf_pair_add_del_v2 *msg =
+        vapi_alloc_lcp_itf_pair_add_del_v2(op_ctx);
+    if (!msg)
+      return VAPI_ENOMEM;
+    msg->payload.is_add = op->type == VPP_OP_CREATE_LCP;
+    msg->payload.sw_if_index = idx;
+    snprintf((char *)msg->payload.host_if_name,
+             sizeof(msg->payload.host_if_name), "%s", op->arg);
+    snprintf((char *)msg->payload.netns, sizeof(msg->payload.netns), "%s",
+             op->arg2);
+    msg->payload.host_if_type =
+        op->value ? LCP_API_ITF_HOST_TUN : LCP_API_ITF_HOST_TAP;
+    OP_SEND(lcp_itf_pair_add_del_v2, msg, op);
+    break;
+  }
+  case VPP_OP_SET_DESCRIPTION: {
+    vapi_msg_cli_inband *msg;
+    char cmd[512];
+    size_t len;
+    if (vpp_op_format(op, cmd, sizeof(cmd)) < 0)
+      return VAPI_EINVAL;
+    len = strlen(cmd);
+    if (!(msg = vapi_alloc_cli_inband(op_ctx, len)))
+      return VAPI_ENOMEM;
+    msg->payload.cmd.length = len;
+    memcpy(msg->payload.cmd.buf, cmd, len);
+    OP_SEND(cli_inband, msg, op);
+    break;
+  }
+  default:
+    return VAPI_EINVAL;
+  }
+  return rv;
+}
+
+/* First of the op's interfaces without a known sw_if_index, or NULL */
+static const char *op_unresolved(const char *a, const char *b) {
+  if (a && vpp_ifcache_name_to_index(a) == VPP_IFCACHE_NONE)
+    return a;
+  if (b && vpp_ifcache_name_to_index(b) == VPP_IFCACHE_NONE)
+    return b;
+  return NULL;
+}
+
+/*
+ * One VAPI context: it already keeps every request of a drain in flight,
+ * and a second context would buy no parallelism on VPP's main thread
+ */
+unsigned vpp_op_transport_sessions(void) { return 1; }
+
+int vpp_op_transport_drain(vpp_op_t *ops, size_t n, unsigned session) {
+  (void)session;
+  if (op_connect() < 0)
+    return -1;
+
+  for (size_t i = 0; i < n; i++) {
+    vpp_op_t *op = &ops[i];
+    const char *a, *b, *missing;
+    vapi_error_e rv;
+
+    op_requires(op, &a, &b);
+    if (op_unresolved(a, b)) {
+      /* Barrier: let outstanding creates report their sw_if_index */
+      vapi_dispatch(op_ctx);
+      if ((missing = op_unresolved(a, b)) != NULL) {
+        op->rv = -1;
+        snprintf(op->error, sizeof(op->error), "Interface %s not found",
+                 missing);
+        continue;
+      }
+    }
+
+    op->usec = (uint32_t)vpp_tstats_now_usec();
+    rv = op_send(op);
+    if (rv != VAPI_OK) {
+      op->rv = VPP_OP_NOT_SENT;
+      snprintf(op->error, sizeof(op->error), "VAPI send error %d", rv);
+    }
+  }
+
+  if (vapi_dispatch(op_ctx) != VAPI_OK) {
+    fprintf(stderr, "[vpp-op] vapi_dispatch failed\n");
+    return -1;
+  }
+  return 0;
+}
+
+#endif /* !VPP_STUB_MODE */
@@ -0,0 +1,561 @@
+/*
+ * vpp_plan.c - Dependency-ordered execution of queued VPP operations
+ *
+ * Levels are computed by relaxation over per-interface records: every
+ * op starts at level 0 and is pushed past whatever it depends on until
+ * nothing moves. The number of passes is bounded by the graph depth; a
+ * cycle shows up as levels that keep growing.
+ *
+ * VPP keeps a sub-interface's MTU within its parent's, so MTU changes
+ * of a parent and its VLANs never share a level: a parent going up is
+ * set before its VLANs, a parent going down after them.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vpp_connection.h"
+#include "vpp_ifcache.h"
+#include "vpp_plan.h"
+
+#define VPP_PLAN_MIN_CHUNK 16 /* Fewer ops are not worth another session */
+#define PLAN_NONE UINT32_MAX
+#define VPP_PLAN_MTU_MIN 64
+#define VPP_PLAN_MTU_MAX 9216 /* Same range as the YANG model */
+
+/* What the ops of one transaction do to one interface name */
+typedef struct {
+  const char *name;   /* Not NUL-terminated, see len */
+  size_t len;
+  uint32_t creator;   /* Op creating it, or PLAN_NONE */
+  uint32_t destroyer; /* Op deleting it, or PLAN_NONE */
+  uint32_t users_end; /* Level after the last op that must precede delete */
+  uint32_t teardown_end; /* Level after the last teardown op on it */
+  uint32_t mtu_op;    /* Op setting its MTU, or PLAN_NONE */
+  uint32_t mtu_subs_end; /* Level after the last MTU op of its VLANs */
+  uint32_t detach_op; /* Op detaching it from a bond, or PLAN_NONE */
+} plan_name_t;
+
+typedef struct {
+  plan_name_t *names;
+  uint32_t *hash;     /* Index into names + 1, 0 = empty */
+  uint32_t hsize;
+  uint32_t count;
+} plan_names_t;
+
+static uint32_t plan_hash(const char *name, size_t len) {
+  uint32_t h = 2166136261u; /* FNV-1a */
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)name[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+/* Record for name, created on first sight */
+static plan_name_t *plan_name(plan_names_t *t, const char *name, size_t len) {
+  uint32_t mask = t->hsize - 1;
+  uint32_t pos;
+  plan_name_t *r;
+
+  for (pos = plan_hash(name, len) & mask; t->hash[pos];
+       pos = (pos + 1) & mask) {
+    r = &t->names[t->hash[pos] - 1];
+    if (r->len == len && memcmp(r->name, name, len) == 0)
+      return r;
+  }
+  r = &t->names[t->count];
+  r->name = name;
+  r->len = len;
+  r->creator = PLAN_NONE;
+  r->destroyer = PLAN_NONE;
+  r->users_end = 0;
+  r->teardown_end = 0;
+  r->mtu_op = PLAN_NONE;
+  r->mtu_subs_end = 0;
+  r->detach_op = PLAN_NONE;
+  t->hash[pos] = ++t->count;
+  return r;
+}
+
+/* Interface records an op refers to */
+typedef struct {
+  plan_name_t *self;   /* op->ifname */
+  plan_name_t *other;  /* Bond or parent, or NULL */
+} plan_refs_t;
+
+static void plan_resolve(plan_names_t *t, const vpp_op_t *op,
+                         plan_refs_t *refs) {
+  const char *dot;
+
+  refs->self = plan_name(t, op->ifname, strlen(op->ifname));
+  refs->other = NULL;
+  switch (op->type) {
+  case VPP_OP_BOND_ADD_MEMBER:
+  case VPP_OP_CREATE_SUBIF:
+    refs->other = plan_name(t, op->arg, strlen(op->arg));
+    break;
+  case VPP_OP_DELETE_SUBIF:
+  case VPP_OP_SET_MTU:
+    if ((dot = strchr(op->ifname, '.')) != NULL)
+      refs->other = plan_name(t, op->ifname, (size_t)(dot - op->ifname));
+    break;
+  default:
+    break;
+  }
+}
+
+/* Undoes part of an interface's setup */
+static bool plan_is_teardown(vpp_op_type_t type) {
+  return type == VPP_OP_DEL_ADDR || type == VPP_OP_DELETE_LCP ||
+         type == VPP_OP_BOND_DEL_MEMBER;
+}
+
+/* Sets something up that a teardown on the same interface may clash
+ * with: replacement address, new bond membership, new LCP pair */
+static bool plan_is_buildup(vpp_op_type_t type) {
+  return type == VPP_OP_ADD_ADDR || type == VPP_OP_CREATE_LCP ||
+         type == VPP_OP_BOND_ADD_MEMBER;
+}
+
+static inline void plan_after(uint32_t *lvl, uint32_t end) {
+  if (end > *lvl)
+    *lvl = end;
+}
+
+/* An MTU op lowering the MTU; an unknown previous MTU counts as rising */
+static inline bool plan_mtu_falls(const vpp_op_t *op) {
+  return op->value2 != 0 && op->value < op->value2;
+}
+
+/* Level of op i given the current levels of everything else */
+static uint32_t plan_level_of(const vpp_op_queue_t *q, const vpp_op_t *op,
+                              const plan_refs_t *refs, const uint32_t *level) {
+  plan_name_t *self = refs->self;
+  plan_name_t *other = refs->other;
+  uint32_t lvl = 0;
+
+  switch (op->type) {
+  case VPP_OP_CREATE_BOND:
+  case VPP_OP_CREATE_SUBIF:
+    /* A re-created name waits for the old one to go */
+    if (self->destroyer != PLAN_NONE)
+      plan_after(&lvl, level[self->destroyer] + 1);
+    if (other && other->creator != PLAN_NONE)
+      plan_after(&lvl, level[other->creator] + 1);
+    break;
+  case VPP_OP_DELETE_BOND:
+  case VPP_OP_DELETE_SUBIF:
+    plan_after(&lvl, self->users_end);
+    break;
+  default:
+    if (self->creator != PLAN_NONE && !plan_is_teardown(op->type))
+      plan_after(&lvl, level[self->creator] + 1);
+    if (other && other->creator != PLAN_NONE)
+      plan_after(&lvl, level[other->creator] + 1);
+    if (plan_is_buildup(op->type))
+      plan_after(&lvl, self->teardown_end);
+    break;
+  }
+
+  if (op->type == VPP_OP_SET_MTU) {
+    /* A rising parent first, then its VLANs; a falling one last */
+    if (other && other->mtu_op != PLAN_NONE &&
+        !plan_mtu_falls(&q->ops[other->mtu_op]))
+      plan_after(&lvl, level[other->mtu_op] + 1);
+    if (plan_mtu_falls(op))
+      plan_after(&lvl, self->mtu_subs_end);
+  }
+  return lvl;
+}
+
+/* Publish op i's level to the records that later ops look at */
+static void plan_note_level(const vpp_op_t *op, const plan_refs_t *refs,
+                            uint32_t lvl) {
+  plan_name_t *self = refs->self;
+
+  if (plan_is_teardown(op->type))
+    plan_after(&self->teardown_end, lvl + 1);
+  if (op->type == VPP_OP_SET_MTU && refs->other)
+    plan_after(&refs->other->mtu_subs_end, lvl + 1);
+
+  /* Ops on the old incarnation precede its deletion */
+  if (op->type == VPP_OP_DELETE_SUBIF) {
+    if (refs->other)
+      plan_after(&refs->other->users_end, lvl + 1);
+  } else if (op->type != VPP_OP_DELETE_BOND &&
+             op->type != VPP_OP_CREATE_BOND &&
+             op->type != VPP_OP_CREATE_SUBIF &&
+             (self->creator == PLAN_NONE || plan_is_teardown(op->type))) {
+    plan_after(&self->users_end, lvl + 1);
+  }
+}
+
+/* Name records and per-op references for the ops of q */
+static int plan_names_init(plan_names_t *names, plan_refs_t **refsp,
+                           const vpp_op_queue_t *q) {
+  size_t n = q->len;
+  plan_refs_t *refs;
+
+  memset(names, 0, sizeof(*names));
+  /* At most two names per op; hash kept under half full */
+  for (names->hsize = 16; names->hsize < 4 * n; names->hsize *= 2)
+    ;
+  names->names = calloc(2 * n, sizeof(*names->names));
+  names->hash = calloc(names->hsize, sizeof(*names->hash));
+  refs = *refsp = calloc(n, sizeof(*refs));
+  if (!names->names || !names->hash || !refs)
+    return -1;
+
+  for (size_t i = 0; i < n; i++) {
+    const vpp_op_t *op = &q->ops[i];
+
+    plan_resolve(names, op, &refs[i]);
+    switch (op->type) {
+    case VPP_OP_CREATE_BOND:
+    case VPP_OP_CREATE_SUBIF:
+      refs[i].self->creator = (uint32_t)i;
+      break;
+    case VPP_OP_DELETE_BOND:
+    case VPP_OP_DELETE_SUBIF:
+      refs[i].self->destroyer = (uint32_t)i;
+      break;
+    case VPP_OP_SET_MTU:
+      refs[i].self->mtu_op = (uint32_t)i;
+      break;
+    case VPP_OP_BOND_DEL_MEMBER:
+      refs[i].self->detach_op = (uint32_t)i;
+      break;
+    default:
+      break;
+    }
+  }
+  return 0;
+}
+
+static void plan_names_free(plan_names_t *names, plan_refs_t *refs) {
+  free(names->names);
+  free(names->hash);
+  free(refs);
+}
+
+int vpp_plan_build(vpp_plan_t *plan, const vpp_op_queue_t *q) {
+  size_t n = q->len;
+  plan_names_t names;
+  plan_refs_t *refs = NULL;
+  uint32_t *count = NULL;
+  bool moved = true;
+  size_t pass;
+  int ret = -1;
+
+  memset(plan, 0, sizeof(*plan));
+  plan->nops = n;
+  if (n == 0)
+    return 0;
+
+  plan->level = calloc(n, sizeof(*plan->level));
+  plan->order = calloc(n, sizeof(*plan->order));
+  if (plan_names_init(&names, &refs, q) < 0 || !plan->level || !plan->order)
+    goto done;
+
+  /* Relax until stable; an acyclic graph settles within n + 1 passes.
+   * The first pass only fills the records, so there is always a second:
+   * an op may depend on one queued after it. */
+  for (pass = 0; moved && pass <= n + 1; pass++) {
+    moved = pass == 0;
+    for (size_t i = 0; i < n; i++) {
+      uint32_t lvl = plan_level_of(q, &q->ops[i], &refs[i], plan->level);
+      if (lvl > plan->level[i]) {
+        plan->level[i] = lvl;
+        moved = true;
+      }
+      plan_note_level(&q->ops[i], &refs[i], plan->level[i]);
+    }
+  }
+  if (moved) {
+    fprintf(stderr, "[vpp] Operation dependencies form a cycle\n");
+    goto done;
+  }
+
+  /* Group by level, keeping queue order inside a level */
+  for (size_t i = 0; i < n; i++) {
+    if (plan->level[i] + 1 > plan->nlevels)
+      plan->nlevels = plan->level[i] + 1;
+  }
+  plan->start = calloc(plan->nlevels + 1, sizeof(*plan->start));
+  count = calloc(plan->nlevels, sizeof(*count));
+  if (!plan->start || !count)
+    goto done;
+  for (size_t i = 0; i < n; i++)
+    count[plan->level[i]]++;
+  for (uint32_t l = 0; l < plan->nlevels; l++) {
+    plan->start[l + 1] = plan->start[l] + count[l];
+    count[l] = plan->start[l];
+  }
+  for (size_t i = 0; i < n; i++)
+    plan->order[count[plan->level[i]]++] = (uint32_t)i;
+  ret = 0;
+
+done:
+  plan_names_free(&names, refs);
+  free(count);
+  if (ret < 0)
+    vpp_plan_free(plan);
+  return ret;
+}
+
+void vpp_plan_free(vpp_plan_t *plan) {
+  free(plan->level);
+  free(plan->order);
+  free(plan->start);
+  memset(plan, 0, sizeof(*plan));
+}
+
+/*
+ * Validation against VPP's current interfaces
+ */
+
+static bool plan_exists(const vpp_if_table_t *snap, const plan_name_t *r,
+                        const char *name) {
+  return r->creator != PLAN_NONE ||
+         vpp_if_table_find(snap, name) != VPP_IF_NONE;
+}
+
+/* MTU a sub-interface's parent will have once the plan ran, 0 if unknown */
+static uint32_t plan_parent_mtu(const vpp_if_table_t *snap,
+                                const vpp_op_queue_t *q,
+                                const plan_name_t *parent, char *name,
+                                size_t len) {
+  uint32_t idx;
+
+  snprintf(name, len, "%.*s", (int)parent->len, parent->name);
+  if (parent->mtu_op != PLAN_NONE)
+    return q->ops[parent->mtu_op].value;
+  idx = vpp_if_table_find(snap, name);
+  return idx != VPP_IF_NONE ? snap->hot[idx].mtu : 0;
+}
+
+static int plan_check_op(const vpp_if_table_t *snap, const vpp_op_queue_t *q,
+                         const plan_refs_t *refs, size_t i, char *err,
+                         size_t errlen) {
+  const vpp_op_t *op = &q->ops[i];
+  const plan_name_t *self = refs[i].self;
+  const plan_name_t *other = refs[i].other;
+  char parent[64];
+  uint32_t idx;
+  uint32_t mtu;
+
+  switch (op->type) {
+  case VPP_OP_CREATE_SUBIF:
+    if (!plan_exists(snap, other, op->arg)) {
+      snprintf(err, errlen, "Parent interface %s of %s does not exist",
+               op->arg, op->ifname);
+      return -1;
+    }
+    /* FALLTHROUGH */
+  case VPP_OP_CREATE_BOND:
+    if (vpp_if_table_find(snap, op->ifname) != VPP_IF_NONE &&
+        self->destroyer == PLAN_NONE) {
+      snprintf(err, errlen, "Interface %s already exists", op->ifname);
+      return -1;
+    }
+    return 0;
+  case VPP_OP_BOND_ADD_MEMBER:
+    if (!plan_exists(snap, other, op->arg)) {
+      snprintf(err, errlen, "Bond %s does not exist", op->arg);
+      return -1;
+    }
+    if (strchr(op->ifname, '.') ||
+        strncmp(op->ifname, "BondEthernet", 12) == 0) {
+      snprintf(err, errlen, "%s cannot be a bond member", op->ifname);
+      return -1;
+    }
+    idx = vpp_if_table_find(snap, op->ifname);
+    if (idx != VPP_IF_NONE && snap->hot[idx].bond_sw_if_index != VPP_IF_NONE &&
+        self->detach_op == PLAN_NONE) {
+      snprintf(err, errlen, "%s is already a member of %s", op->ifname,
+               snap->cold[snap->hot[idx].bond_sw_if_index].name);
+      return -1;
+    }
+    break;
+  case VPP_OP_SET_MTU:
+    if (op->value < VPP_PLAN_MTU_MIN || op->value > VPP_PLAN_MTU_MAX) {
+      snprintf(err, errlen, "MTU %u for %s is outside %u..%u", op->value,
+               op->ifname, VPP_PLAN_MTU_MIN, VPP_PLAN_MTU_MAX);
+      return -1;
+    }
+    if (!other)
+      break;
+    mtu = plan_parent_mtu(snap, q, other, parent, sizeof(parent));
+    if (mtu > 0 && op->value > mtu) {
+      snprintf(err, errlen, "MTU %u for %s exceeds MTU %u of parent %s",
+               op->value, op->ifname, mtu, parent);
+      return -1;
+    }
+    break;
+  case VPP_OP_SET_DESCRIPTION:
+    if (!vpp_op_text_ok(op->text)) {
+      snprintf(err, errlen, "Description of %s contains control characters",
+               op->ifname);
+      return -1;
+    }
+    break;
+  default:
+    break;
+  }
+
+  if (!plan_exists(snap, self, op->ifname)) {
+    snprintf(err, errlen, "Interface %s does not exist", op->ifname);
+    return -1;
+  }
+  return 0;
+}
+
+int vpp_plan_check(const vpp_plan_t *plan, const vpp_op_queue_t *q,
+                   const vpp_if_table_t *snap, char *err, size_t errlen) {
+  plan_names_t names;
+  plan_refs_t *refs = NULL;
+  int ret = -1;
+
+  if (plan->nops != q->len) {
+    snprintf(err, errlen, "Plan does not match the operation queue");
+    return -1;
+  }
+  if (q->len == 0)
+    return 0;
+  if (plan_names_init(&names, &refs, q) < 0) {
+    snprintf(err, errlen, "Out of memory");
+    goto done;
+  }
+
+  /* Dependency order, so the first complaint is the root cause */
+  for (size_t k = 0; k < plan->nops; k++) {
+    if (plan_check_op(snap, q, refs, plan->order[k], err, errlen) < 0)
+      goto done;
+  }
+  ret = 0;
+
+done:
+  plan_names_free(&names, refs);
+  return ret;
+}
+
+/*
+ * Execution
+ */
+
+typedef struct {
+  vpp_op_t *ops;
+  size_t n;
+  unsigned session;
+  int rv;
+} plan_chunk_t;
+
+static void *plan_chunk_run(void *arg) {
+  plan_chunk_t *c = arg;
+  c->rv = vpp_op_send(c->ops, c->n, c->session);
+  return NULL;
+}
+
+/* Drain one level, spread over up to nsess transport sessions */
+static int plan_drain_level(vpp_op_t *ops, size_t n, unsigned nsess) {
+  plan_chunk_t chunks[VPP_CLI_MAX_SESSIONS];
+  pthread_t tids[VPP_CLI_MAX_SESSIONS];
+  bool started[VPP_CLI_MAX_SESSIONS] = {false};
+  size_t per;
+  int rv = 0;
+
+  if (nsess > (n + VPP_PLAN_MIN_CHUNK - 1) / VPP_PLAN_MIN_CHUNK)
+    nsess = (unsigned)((n + VPP_PLAN_MIN_CHUNK - 1) / VPP_PLAN_MIN_CHUNK);
+  if (nsess > VPP_CLI_MAX_SESSIONS)
+    nsess = VPP_CLI_MAX_SESSIONS;
+  /* Extra sessions follow the main one, which must be up first */
+  if (nsess > 1 && !vpp_is_connected() && vpp_connect() != 0)
+    nsess = 1;
+  if (nsess <= 1)
+    return vpp_op_send(ops, n, 0);
+
+  per = (n + nsess - 1) / nsess;
+  for (unsigned s = 0; s < nsess; s++) {
+    size_t off = s * per;
+    chunks[s].ops = ops + off;
+    chunks[s].n = off < n ? (n - off < per ? n - off : per) : 0;
+    chunks[s].session = s;
+    chunks[s].rv = 0;
+  }
+  for (unsigned s = 1; s < nsess; s++) {
+    if (chunks[s].n > 0 &&
+        pthread_create(&tids[s], NULL, plan_chunk_run, &chunks[s]) == 0)
+      started[s] = true;
+  }
+  plan_chunk_run(&chunks[0]);
+  for (unsigned s = 1; s < nsess; s++) {
+    if (started[s])
+      pthread_join(tids[s], NULL);
+    else if (chunks[s].n > 0)
+      plan_chunk_run(&chunks[s]); /* No thread, run it here */
+  }
+
+  for (unsigned s = 0; s < nsess; s++) {
+    if (chunks[s].rv < 0)
+      rv = -1;
+  }
+  return rv;
+}
+
+int vpp_plan_execute(const vpp_plan_t *plan, vpp_op_queue_t *q) {
+  unsigned nsess = vpp_op_transport_sessions();
+  vpp_op_t *level_ops = NULL;
+  size_t widest = 0;
+  int failed = 0;
+  uint32_t l;
+
+  if (plan->nops != q->len)
+    return -1;
+  if (q->len == 0)
+    return 0;
+
+  for (l = 0; l < plan->nlevels; l++) {
+    if (plan->start[l + 1] - plan->start[l] > widest)
+      widest = plan->start[l + 1] - plan->start[l];
+  }
+  level_ops = malloc(widest * sizeof(*level_ops));
+  if (!level_ops)
+    return -1;
+
+  for (l = 0; l < plan->nlevels && failed == 0; l++) {
+    const uint32_t *idx = &plan->order[plan->start[l]];
+    size_t n = plan->start[l + 1] - plan->start[l];
+    int rv;
+
+    /* Ops of a level are gathered so each session gets a plain array */
+    for (size_t i = 0; i < n; i++)
+      level_ops[i] = q->ops[idx[i]];
+    rv = plan_drain_level(level_ops, n, nsess);
+    if (rv == 0)
+      failed = vpp_op_collect(level_ops, n);
+    for (size_t i = 0; i < n; i++)
+      q->ops[idx[i]] = level_ops[i];
+    if (rv < 0) {
+      vpp_ifcache_invalidate();
+      failed = -1;
+    }
+  }
+
+  /* Anything past the failing level stays unsent */
+  if (failed != 0 && l < plan->nlevels) {
+    for (size_t i = plan->start[l]; i < plan->nops; i++) {
+      vpp_op_t *op = &q->ops[plan->order[i]];
+      snprintf(op->error, sizeof(op->error),
+               "Not sent: commit stopped at an earlier failure");
+    }
+    fprintf(stderr, "[vpp] Stopped after level %u of %u, %zu ops not sent\n",
+            l, plan->nlevels, plan->nops - plan->start[l]);
+  }
+
+  free(level_ops);
+  return failed;
+}
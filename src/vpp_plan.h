@@ -0,0 +1,50 @@
+/*
+ * vpp_plan.h - Dependency-ordered execution of queued VPP operations
+ *
+ * The ops of a transaction have an implicit order: a bond exists before
+ * its members are added, a parent before its sub-interfaces, an
+ * interface before its LCP pair and addresses, and an old address is
+ * gone before its replacement is added. The planner turns the queue
+ * into dependency levels; each level only depends on earlier ones and
+ * is sent as one pipeline, split across the transport's parallel
+ * sessions. Commit time follows the depth of the graph, not the number
+ * of ops.
+ */
+
+#ifndef _VPP_PLAN_H_
+#define _VPP_PLAN_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vpp_interface.h"
+#include "vpp_op.h"
+
+/* Execution plan for one vpp_op_queue_t */
+typedef struct {
+  size_t nops;      /* Queue length the plan was built for */
+  uint32_t *level;  /* level[i]: dependency level of ops[i] */
+  uint32_t *order;  /* Op indexes grouped by level, queue order kept */
+  uint32_t *start;  /* Level l is order[start[l] .. start[l + 1]) */
+  uint32_t nlevels;
+} vpp_plan_t;
+
+/* Build the plan; -1 on allocation failure or a dependency cycle */
+int vpp_plan_build(vpp_plan_t *plan, const vpp_op_queue_t *q);
+
+/* Check the plan against a snapshot of VPP's interfaces: interfaces
+ * exist (or are created earlier in the plan), bond members are free,
+ * MTUs are in range and fit the parent
+ * Returns 0 if the plan can be applied, -1 with the reason in err */
+int vpp_plan_check(const vpp_plan_t *plan, const vpp_op_queue_t *q,
+                   const vpp_if_table_t *snap, char *err, size_t errlen);
+
+/* Run the plan level by level, stopping after the first level with a
+ * failure; ops of later levels keep rv = VPP_OP_NOT_SENT
+ * Returns the number of failed ops (0 = all applied), -1 if the
+ * transport broke */
+int vpp_plan_execute(const vpp_plan_t *plan, vpp_op_queue_t *q);
+
+void vpp_plan_free(vpp_plan_t *plan);
+
+#endif /* _VPP_PLAN_H_ */
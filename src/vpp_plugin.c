@@ -4,11 +4,15 @@
 
 #include <arpa/inet.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 #include <syslog.h>
+#include <time.h>
 #include <unistd.h>
 
 /* Clixon includes */
@@ -16,11 +20,27 @@
 #include <clixon/clixon.h>
 #include <clixon/clixon_backend_transaction.h>
 
+#include "vpp_api.h"
 #include "vpp_connection.h"
+#include "vpp_ifcache.h"
 #include "vpp_interface.h"
+#include "vpp_journal.h"
+#include "vpp_op.h"
+#include "vpp_plan.h"
+#include "vpp_ready.h"
+#include "vpp_startup.h"
+#include "vpp_stats.h"
+#include "vpp_tstats.h"
 
 #define PLUGIN_NAME "vpp-control-plane"
 #define VPP_NS "http://example.com/vpp/interfaces"
+#define VPP_IF_DEFAULT_MTU 1500 /* YANG default of interface/mtu */
+#define VPP_IF_BOOT_MTU 9000    /* What a starting VPP gives interfaces */
+#define VPP_CONFIG_FILE "/var/lib/clixon/vpp/vpp_config.xml" /* Override with VPP_CONFIG_FILE */
+#define VPP_STARTUP_SCRIPT "/var/lib/clixon/vpp/vpp_startup.exec" /* Override with VPP_STARTUP_SCRIPT */
+
+/* Interface table for state polls, reused across requests */
+static vpp_if_table_t state_ifs;
 
 /*
  * RPC callback: create-loopback
@@ -794,6 +814,402 @@ static int rpc_lcp_set_netns(clixon_handle h, cxobj *xn, cbuf *cbret, void *arg,
   return ret;
 }
 
+/*
+ * Startup replay command list, executed with one vpp_cli_exec_batch()
+ */
+typedef struct {
+  char **cmds;
+  size_t len;
+  size_t cap;
+} startup_cmds_t;
+
+static void startup_cmd_add(startup_cmds_t *sc, const char *cmd) {
+  if (sc->len == sc->cap) {
+    size_t cap = sc->cap ? sc->cap * 2 : 64;
+    char **ncmds = realloc(sc->cmds, cap * sizeof(*ncmds));
+    if (!ncmds)
+      return;
+    sc->cmds = ncmds;
+    sc->cap = cap;
+  }
+  if ((sc->cmds[sc->len] = strdup(cmd)) != NULL)
+    sc->len++;
+}
+
+static void startup_cmds_free(startup_cmds_t *sc) {
+  for (size_t i = 0; i < sc->len; i++)
+    free(sc->cmds[i]);
+  free(sc->cmds);
+  memset(sc, 0, sizeof(*sc));
+}
+
+/* Children of x named name, in document order */
+static cxobj *child_next(cxobj *x, cxobj *prev, const char *name) {
+  if (!x)
+    return NULL;
+  while ((prev = xml_child_each(x, prev, CX_ELMNT)) != NULL)
+    if (strcmp(xml_name(prev), name) == 0)
+      return prev;
+  return NULL;
+}
+
+/* Interfaces whose settings come from the running datastore instead */
+static bool in_running(clicon_hash_t *running, const char *name) {
+  return running && clicon_hash_lookup(running, name) != NULL;
+}
+
+static void startup_plan_bond(cxobj *xb, clicon_hash_t *running,
+                              vpp_op_queue_t *q) {
+  const char *name = xml_find_body(xb, "name");
+  const char *mode = xml_find_body(xb, "mode");
+  const char *lb = xml_find_body(xb, "load-balance");
+  const char *members = xml_find_body(xb, "members");
+  const char *id = xml_find_body(xb, "id");
+  char member[64];
+  vpp_op_t *op;
+
+  if (!name || !*name || !(op = vpp_op_submit(q, VPP_OP_CREATE_BOND, name)))
+    return;
+  snprintf(op->mode, sizeof(op->mode), "%s", mode && *mode ? mode : "lacp");
+  snprintf(op->lb, sizeof(op->lb), "%s", lb && *lb ? lb : "l2");
+  op->value = strncmp(name, "BondEthernet", 12) == 0 ? (uint32_t)atoi(name + 12)
+              : id                                   ? (uint32_t)atoi(id)
+                                                     : 0;
+  if (!in_running(running, name) &&
+      (op = vpp_op_submit(q, VPP_OP_SET_STATE, name)) != NULL)
+    op->value = 1;
+
+  /* "Eth0,Eth1" */
+  for (const char *m = members; m && *m;) {
+    size_t len;
+
+    while (*m == ' ' || *m == ',')
+      m++;
+    len = strcspn(m, ",");
+    while (len > 0 && m[len - 1] == ' ')
+      len--;
+    if (len > 0) {
+      snprintf(member, sizeof(member), "%.*s", (int)len, m);
+      if (!in_running(running, member) &&
+          (op = vpp_op_submit(q, VPP_OP_SET_STATE, member)) != NULL)
+        op->value = 1;
+      if ((op = vpp_op_submit(q, VPP_OP_BOND_ADD_MEMBER, member)) != NULL)
+        snprintf(op->arg, sizeof(op->arg), "%s", name);
+    }
+    m += strcspn(m, ",");
+  }
+}
+
+static void startup_plan_subif(cxobj *xif, clicon_hash_t *running,
+                               vpp_op_queue_t *q) {
+  const char *name = xml_find_body(xif, "name");
+  const char *dot = name ? strchr(name, '.') : NULL;
+  vpp_op_t *op;
+
+  if (!dot || in_running(running, name) ||
+      !(op = vpp_op_submit(q, VPP_OP_CREATE_SUBIF, name)))
+    return;
+  snprintf(op->arg, sizeof(op->arg), "%.*s", (int)(dot - name), name);
+  op->value = (uint32_t)atoi(dot + 1);
+  op->value2 = op->value;
+}
+
+static void startup_plan_lcp(cxobj *xl, vpp_op_queue_t *q) {
+  const char *vpp_if = xml_find_body(xl, "vpp-interface");
+  const char *host_if = xml_find_body(xl, "host-interface");
+  const char *netns = xml_find_body(xl, "netns");
+  vpp_op_t *op;
+
+  if (!vpp_if || !*vpp_if || !host_if || !*host_if ||
+      !(op = vpp_op_submit(q, VPP_OP_CREATE_LCP, vpp_if)))
+    return;
+  snprintf(op->arg, sizeof(op->arg), "%s", host_if);
+  snprintf(op->arg2, sizeof(op->arg2), "%s", netns ? netns : "");
+}
+
+static void startup_plan_addrs(cxobj *xif, const char *name, const char *list,
+                               vpp_op_queue_t *q) {
+  cxobj *xa = NULL;
+  vpp_op_t *op;
+
+  while ((xa = child_next(xif, xa, list)) != NULL) {
+    const char *addr = xml_find_body(xa, "address");
+    const char *plen = xml_find_body(xa, "prefix-length");
+    int prefix = plen ? atoi(plen) : 0;
+
+    if (!addr || !*addr || prefix <= 0 ||
+        !(op = vpp_op_submit(q, VPP_OP_ADD_ADDR, name)))
+      continue;
+    snprintf(op->arg, sizeof(op->arg), "%s/%d", addr, prefix);
+  }
+}
+
+static void startup_plan_interface(cxobj *xif, clicon_hash_t *running,
+                                   vpp_op_queue_t *q) {
+  const char *name = xml_find_body(xif, "name");
+  const char *enabled = xml_find_body(xif, "enabled");
+  const char *mtu = xml_find_body(xif, "mtu");
+  vpp_op_t *op;
+
+  if (!name || !*name || in_running(running, name))
+    return;
+  if (mtu && (op = vpp_op_submit(q, VPP_OP_SET_MTU, name)) != NULL) {
+    op->value = (uint32_t)strtoul(mtu, NULL, 10);
+    op->value2 = VPP_IF_BOOT_MTU;
+  }
+  if (enabled && strcmp(enabled, "true") == 0 &&
+      (op = vpp_op_submit(q, VPP_OP_SET_STATE, name)) != NULL)
+    op->value = 1;
+  startup_plan_addrs(xif, name, "ipv4-address", q);
+  startup_plan_addrs(xif, name, "ipv6-address", q);
+}
+
+/*
+ * vpp_config.xml as ops: bonds and their members, sub-interfaces, then
+ * LCP pairs on top of both, then MTUs, link state and addresses. The
+ * file is what the CLI plugin saves; each pass walks one section of the
+ * parsed tree, so the plan is linear in the config. Interfaces in
+ * running are left to it.
+ */
+static void startup_plan(cxobj *xcfg, clicon_hash_t *running,
+                         vpp_op_queue_t *q) {
+  cxobj *xifs = xml_find_type(xcfg, NULL, "interfaces", CX_ELMNT);
+  cxobj *xbonds = xml_find_type(xcfg, NULL, "bonds", CX_ELMNT);
+  cxobj *xlcps = xml_find_type(xcfg, NULL, "lcps", CX_ELMNT);
+  cxobj *x;
+
+  x = NULL;
+  while ((x = child_next(xbonds, x, "bond")) != NULL)
+    startup_plan_bond(x, running, q);
+  x = NULL;
+  while ((x = child_next(xifs, x, "interface")) != NULL)
+    startup_plan_subif(x, running, q);
+  x = NULL;
+  while ((x = child_next(xlcps, x, "lcp")) != NULL)
+    startup_plan_lcp(x, q);
+  x = NULL;
+  while ((x = child_next(xifs, x, "interface")) != NULL)
+    startup_plan_interface(x, running, q);
+}
+
+/* Replay everything in one batch instead of a round trip each
+ * Returns the number of commands that failed */
+static size_t startup_replay(clixon_handle h, startup_cmds_t *sc) {
+  vpp_cli_result_t *results;
+  size_t failed = 0;
+
+  if (sc->len == 0)
+    return 0;
+  if (!(results = calloc(sc->len, sizeof(*results))))
+    return sc->len;
+  vpp_cli_exec_batch((const char **)sc->cmds, sc->len, results);
+  for (size_t i = 0; i < sc->len; i++) {
+    if (results[i].rv != 0) {
+      failed++;
+      clixon_log(h, LOG_WARNING, "%s: Startup command failed: %s",
+                 PLUGIN_NAME, sc->cmds[i]);
+    }
+  }
+  clixon_log(h, LOG_NOTICE, "%s: Replayed %zu commands, %zu failed",
+             PLUGIN_NAME, sc->len, failed);
+  vpp_cli_results_free(results, sc->len);
+  free(results);
+  return failed;
+}
+
+/*
+ * What VPP already has, as far as replayed ops go: the interface
+ * snapshot (presence, MTU, admin state, bond membership), the LCP pairs
+ * and "show interface addr". Three reads, however large the replay.
+ */
+typedef struct {
+  const vpp_if_table_t *snap;
+  vpp_api_set_t *lcps;
+  char *addrs;
+} live_state_t;
+
+static void live_read(live_state_t *live) {
+  live->snap = vpp_interface_snapshot();
+  live->lcps = vpp_api_get_lcps();
+  live->addrs = vpp_cli_exec("show interface addr");
+}
+
+static void live_free(live_state_t *live) {
+  vpp_api_set_free(live->lcps);
+  free(live->addrs);
+  memset(live, 0, sizeof(*live));
+}
+
+/* addrs is "show interface addr": "NAME (up):" then "  L3 ADDR" lines */
+static bool addr_present(const char *addrs, const char *ifname,
+                         const char *addr) {
+  size_t nlen = strlen(ifname);
+  size_t alen = strlen(addr);
+  bool in = false;
+  const char *l = addrs;
+
+  while (l && *l) {
+    const char *eol = strchr(l, '\n');
+    const char *end = eol ? eol : l + strlen(l);
+
+    while (end > l && (end[-1] == ' ' || end[-1] == '\r'))
+      end--;
+    if (*l != ' ') {
+      in = (size_t)(end - l) > nlen && strncmp(l, ifname, nlen) == 0 &&
+           l[nlen] == ' ';
+    } else if (in) {
+      while (l < end && *l == ' ')
+        l++;
+      if (strncmp(l, "L3 ", 3) == 0 && (size_t)(end - l - 3) == alen &&
+          strncmp(l + 3, addr, alen) == 0)
+        return true;
+    }
+    l = eol ? eol + 1 : NULL;
+  }
+  return false;
+}
+
+/* VPP already has what op would set */
+static bool live_has(const live_state_t *live, const vpp_op_t *op) {
+  const vpp_if_table_t *snap = live->snap;
+  uint32_t idx = snap ? vpp_if_table_find(snap, op->ifname) : VPP_IF_NONE;
+  const vpp_if_hot_t *hot = idx != VPP_IF_NONE ? &snap->hot[idx] : NULL;
+  vpp_api_iter_t it = vpp_api_iter(live->lcps);
+  const vpp_lcp_info_t *l;
+
+  switch (op->type) {
+  case VPP_OP_CREATE_BOND:
+  case VPP_OP_CREATE_SUBIF:
+    return hot != NULL;
+  case VPP_OP_BOND_ADD_MEMBER:
+    return hot && hot->bond_sw_if_index != VPP_IF_NONE &&
+           hot->bond_sw_if_index == vpp_if_table_find(snap, op->arg);
+  case VPP_OP_SET_MTU:
+    return hot && hot->mtu == op->value;
+  case VPP_OP_SET_STATE:
+    return hot && ((hot->flags & VPP_IF_F_ADMIN_UP) != 0) == (op->value != 0);
+  case VPP_OP_ADD_ADDR:
+    return live->addrs && addr_present(live->addrs, op->ifname, op->arg);
+  case VPP_OP_CREATE_LCP:
+    while ((l = vpp_api_iter_next(&it)) != NULL)
+      if (strcmp(l->vpp_if, op->ifname) == 0)
+        return true;
+    return false;
+  default:
+    return false; /* Descriptions are not read back; setting one is cheap */
+  }
+}
+
+/* MTU ops start from what VPP has, where it has the interface, so the
+ * plan orders a parent against its VLANs the right way round */
+static void ops_mtu_prev(vpp_op_queue_t *q, const vpp_if_table_t *snap) {
+  uint32_t idx;
+
+  for (size_t i = 0; snap && i < q->len; i++) {
+    vpp_op_t *op = &q->ops[i];
+
+    if (op->type == VPP_OP_SET_MTU &&
+        (idx = vpp_if_table_find(snap, op->ifname)) != VPP_IF_NONE &&
+        snap->hot[idx].mtu != 0)
+      op->value2 = snap->hot[idx].mtu;
+  }
+}
+
+/* Commands for the ops of q in plan order into sc, leaving out what live
+ * says VPP has
+ * Returns how many were left out */
+static size_t ops_pending(const vpp_op_queue_t *q, const live_state_t *live,
+                          startup_cmds_t *sc) {
+  vpp_plan_t plan = {0};
+  bool planned = vpp_plan_build(&plan, q) == 0;
+  size_t present = 0;
+  char cmd[512];
+
+  for (size_t i = 0; i < q->len; i++) {
+    const vpp_op_t *op = &q->ops[planned ? plan.order[i] : i];
+
+    if (vpp_op_format(op, cmd, sizeof(cmd)) < 0)
+      continue;
+    if (live_has(live, op))
+      present++;
+    else
+      startup_cmd_add(sc, cmd);
+  }
+  vpp_plan_free(&plan);
+  return present;
+}
+
+/*
+ * VPP readiness
+ *
+ * The backend neither waits for VPP nor is restarted with it. An
+ * inotify watch on VPP's sockets wakes the event loop when VPP comes up
+ * or back, one "show version" confirms it answers, and the saved
+ * configuration is applied right away. A socket that is there but not
+ * accepting yet is retried after READY_RETRY_MS, doubling up to
+ * READY_RETRY_MAX_MS.
+ */
+#define READY_RETRY_MS 20
+#define READY_RETRY_MAX_MS 1000
+
+static bool ready_registered;
+static bool ready_retry_pending;
+static int ready_retry_ms;
+
+static int ready_retry(int fd, void *arg);
+static int sync_retry(int fd, void *arg);
+static bool sync_retry_pending;
+static void vpp_sync(clixon_handle h);
+static void sync_reset(void);
+static void config_drop(void);
+
+static void ready_apply(clixon_handle h) {
+  struct timeval t;
+
+  if (vpp_is_connected() || vpp_connect() == 0) {
+    ready_retry_ms = 0;
+    vpp_sync(h);
+    return;
+  }
+  if (!vpp_ready_sockets() || ready_retry_pending)
+    return; /* The watch reports when VPP shows up */
+
+  ready_retry_ms = ready_retry_ms ? ready_retry_ms * 2 : READY_RETRY_MS;
+  if (ready_retry_ms > READY_RETRY_MAX_MS)
+    ready_retry_ms = READY_RETRY_MAX_MS;
+  gettimeofday(&t, NULL);
+  t.tv_usec += ready_retry_ms * 1000;
+  t.tv_sec += t.tv_usec / 1000000;
+  t.tv_usec %= 1000000;
+  if (clixon_event_reg_timeout(t, ready_retry, h, "vpp readiness retry") == 0)
+    ready_retry_pending = true;
+}
+
+static int ready_retry(int fd, void *arg) {
+  (void)fd;
+  ready_retry_pending = false;
+  ready_apply(arg);
+  return 0;
+}
+
+static int ready_event(int fd, void *arg) {
+  clixon_handle h = arg;
+  int bits = vpp_ready_read();
+
+  (void)fd;
+  if (bits & VPP_READY_GONE) {
+    clixon_log(h, LOG_WARNING, "%s: VPP went away, waiting for it to return",
+               PLUGIN_NAME);
+    vpp_disconnect();
+    vpp_interface_snapshot_invalidate();
+  }
+  if (bits & VPP_READY_UP) {
+    clixon_log(h, LOG_NOTICE, "%s: VPP sockets are up", PLUGIN_NAME);
+    ready_apply(h);
+  }
+  return 0;
+}
+
 /*
  * Plugin daemon start callback
  */
@@ -851,234 +1267,24 @@ static int vpp_plugin_start(clixon_handle h) {
              "%s: Registered all RPCs (loopback, sub-if, bond, lcp)",
              PLUGIN_NAME);
 
-  if (vpp_connect() != 0) {
-    clixon_err(OE_PLUGIN, 0, "Failed to connect to VPP - is VPP running?");
-    clixon_log(h, LOG_WARNING,
-               "%s: Will retry VPP connection on first operation", PLUGIN_NAME);
-  } else {
-    /* VPP connected - load startup configuration from vpp_config.xml */
-    clixon_log(h, LOG_NOTICE, "%s: Loading startup configuration", PLUGIN_NAME);
-
-    FILE *fp = fopen("/var/lib/clixon/vpp/vpp_config.xml", "r");
-    if (fp) {
-      char line[1024];
-      char bond_name[64] = {0}, mode[32] = {0}, lb[16] = {0},
-           members[512] = {0};
-      char lcp_vpp_if[128] = {0}, lcp_host_if[64] = {0}, lcp_netns[64] = {0};
-      int in_bond = 0, in_lcp = 0;
-
-      /* Parse bonds */
-      while (fgets(line, sizeof(line), fp)) {
-        char *start, *end;
-        if (strstr(line, "<bond>")) {
-          in_bond = 1;
-          bond_name[0] = mode[0] = lb[0] = members[0] = 0;
-        } else if (strstr(line, "</bond>") && in_bond) {
-          in_bond = 0;
-          if (bond_name[0]) {
-            int bond_id = (strncmp(bond_name, "BondEthernet", 12) == 0)
-                              ? atoi(bond_name + 12)
-                              : 0;
-            if (!mode[0])
-              strcpy(mode, "lacp");
-            if (!lb[0])
-              strcpy(lb, "l2");
-            clixon_log(h, LOG_NOTICE, "%s: Creating bond %s", PLUGIN_NAME,
-                       bond_name);
-            char cmd[256];
-            snprintf(cmd, sizeof(cmd),
-                     "create bond mode %s id %d load-balance %s", mode, bond_id,
-                     lb);
-            vpp_cli_exec(cmd);
-            snprintf(cmd, sizeof(cmd), "set interface state %s up", bond_name);
-            vpp_cli_exec(cmd);
-            if (members[0]) {
-              char *m = strtok(members, ",");
-              while (m) {
-                while (*m == ' ')
-                  m++;
-                if (*m) {
-                  snprintf(cmd, sizeof(cmd), "set interface state %s up", m);
-                  vpp_cli_exec(cmd);
-                  snprintf(cmd, sizeof(cmd), "bond add %s %s", bond_name, m);
-                  vpp_cli_exec(cmd);
-                }
-                m = strtok(NULL, ",");
-              }
-            }
-          }
-        } else if (in_bond) {
-          if ((start = strstr(line, "<name>")) &&
-              (end = strstr(line, "</name>"))) {
-            start += 6;
-            strncpy(bond_name, start, end - start);
-            bond_name[end - start] = 0;
-          } else if ((start = strstr(line, "<mode>")) &&
-                     (end = strstr(line, "</mode>"))) {
-            start += 6;
-            strncpy(mode, start, end - start);
-            mode[end - start] = 0;
-          } else if ((start = strstr(line, "<load-balance>")) &&
-                     (end = strstr(line, "</load-balance>"))) {
-            start += 14;
-            strncpy(lb, start, end - start);
-            lb[end - start] = 0;
-          } else if ((start = strstr(line, "<members>")) &&
-                     (end = strstr(line, "</members>"))) {
-            start += 9;
-            strncpy(members, start, end - start);
-            members[end - start] = 0;
-          }
-        }
-      }
-
-      /* Parse LCPs */
-      rewind(fp);
-      while (fgets(line, sizeof(line), fp)) {
-        char *start, *end;
-        if (strstr(line, "<lcp>")) {
-          in_lcp = 1;
-          lcp_vpp_if[0] = lcp_host_if[0] = lcp_netns[0] = 0;
-        } else if (strstr(line, "</lcp>") && in_lcp) {
-          in_lcp = 0;
-          if (lcp_vpp_if[0] && lcp_host_if[0]) {
-            clixon_log(h, LOG_NOTICE, "%s: Creating LCP %s -> %s", PLUGIN_NAME,
-                       lcp_vpp_if, lcp_host_if);
-            char cmd[256];
-            if (lcp_netns[0])
-              snprintf(cmd, sizeof(cmd), "lcp create %s host-if %s netns %s",
-                       lcp_vpp_if, lcp_host_if, lcp_netns);
-            else
-              snprintf(cmd, sizeof(cmd), "lcp create %s host-if %s", lcp_vpp_if,
-                       lcp_host_if);
-            vpp_cli_exec(cmd);
-          }
-        } else if (in_lcp) {
-          if ((start = strstr(line, "<vpp-interface>")) &&
-              (end = strstr(line, "</vpp-interface>"))) {
-            start += 15;
-            strncpy(lcp_vpp_if, start, end - start);
-            lcp_vpp_if[end - start] = 0;
-          } else if ((start = strstr(line, "<host-interface>")) &&
-                     (end = strstr(line, "</host-interface>"))) {
-            start += 16;
-            strncpy(lcp_host_if, start, end - start);
-            lcp_host_if[end - start] = 0;
-          } else if ((start = strstr(line, "<netns>")) &&
-                     (end = strstr(line, "</netns>"))) {
-            start += 7;
-            strncpy(lcp_netns, start, end - start);
-            lcp_netns[end - start] = 0;
-          }
-        }
-      }
-
-      /* Parse interfaces for subinterfaces and IP addresses */
-      rewind(fp);
-      char ifname[128] = {0}, ipv4[64] = {0}, ipv6[128] = {0};
-      int ipv4_prefix = 0, ipv6_prefix = 0, enabled = 0;
-      int in_if = 0, in_ipv4 = 0, in_ipv6 = 0;
-
-      while (fgets(line, sizeof(line), fp)) {
-        char *start, *end;
-        if (strstr(line, "<interface>") && !strstr(line, "vpp-interface")) {
-          in_if = 1;
-          ifname[0] = ipv4[0] = ipv6[0] = 0;
-          ipv4_prefix = ipv6_prefix = enabled = 0;
-        } else if (strstr(line, "</interface>") && in_if) {
-          in_if = 0;
-          if (ifname[0]) {
-            char cmd[256];
-            /* Create subinterface if it has a dot (VLAN) */
-            if (strchr(ifname, '.')) {
-              char parent[128];
-              int vlanid;
-              strncpy(parent, ifname, sizeof(parent) - 1);
-              char *dot = strchr(parent, '.');
-              if (dot) {
-                *dot = 0;
-                vlanid = atoi(dot + 1);
-                clixon_log(h, LOG_NOTICE,
-                           "%s: Creating subif %s (parent=%s, vlan=%d)",
-                           PLUGIN_NAME, ifname, parent, vlanid);
-                snprintf(cmd, sizeof(cmd),
-                         "create sub-interfaces %s %d dot1q %d exact-match",
-                         parent, vlanid, vlanid);
-                vpp_cli_exec(cmd);
-              }
-            }
-            /* Enable interface */
-            if (enabled) {
-              snprintf(cmd, sizeof(cmd), "set interface state %s up", ifname);
-              vpp_cli_exec(cmd);
-            }
-            /* Set IPv4 address */
-            if (ipv4[0] && ipv4_prefix > 0) {
-              clixon_log(h, LOG_NOTICE, "%s: Setting %s IPv4 %s/%d",
-                         PLUGIN_NAME, ifname, ipv4, ipv4_prefix);
-              snprintf(cmd, sizeof(cmd), "set interface ip address %s %s/%d",
-                       ifname, ipv4, ipv4_prefix);
-              vpp_cli_exec(cmd);
-            }
-            /* Set IPv6 address */
-            if (ipv6[0] && ipv6_prefix > 0) {
-              clixon_log(h, LOG_NOTICE, "%s: Setting %s IPv6 %s/%d",
-                         PLUGIN_NAME, ifname, ipv6, ipv6_prefix);
-              snprintf(cmd, sizeof(cmd), "set interface ip address %s %s/%d",
-                       ifname, ipv6, ipv6_prefix);
-              vpp_cli_exec(cmd);
-            }
-          }
-        } else if (in_if) {
-          if (strstr(line, "<ipv4-address>"))
-            in_ipv4 = 1;
-          else if (strstr(line, "</ipv4-address>"))
-            in_ipv4 = 0;
-          else if (strstr(line, "<ipv6-address>"))
-            in_ipv6 = 1;
-          else if (strstr(line, "</ipv6-address>"))
-            in_ipv6 = 0;
-          else if ((start = strstr(line, "<name>")) &&
-                   (end = strstr(line, "</name>")) && !in_ipv4 && !in_ipv6) {
-            start += 6;
-            strncpy(ifname, start, end - start);
-            ifname[end - start] = 0;
-          } else if ((start = strstr(line, "<enabled>")) &&
-                     (end = strstr(line, "</enabled>"))) {
-            start += 9;
-            enabled = (strncmp(start, "true", 4) == 0) ? 1 : 0;
-          } else if (in_ipv4) {
-            if ((start = strstr(line, "<address>")) &&
-                (end = strstr(line, "</address>"))) {
-              start += 9;
-              strncpy(ipv4, start, end - start);
-              ipv4[end - start] = 0;
-            } else if ((start = strstr(line, "<prefix-length>")) &&
-                       (end = strstr(line, "</prefix-length>"))) {
-              start += 15;
-              ipv4_prefix = atoi(start);
-            }
-          } else if (in_ipv6) {
-            if ((start = strstr(line, "<address>")) &&
-                (end = strstr(line, "</address>"))) {
-              start += 9;
-              strncpy(ipv6, start, end - start);
-              ipv6[end - start] = 0;
-            } else if ((start = strstr(line, "<prefix-length>")) &&
-                       (end = strstr(line, "</prefix-length>"))) {
-              start += 15;
-              ipv6_prefix = atoi(start);
-            }
-          }
-        }
-      }
-
-      fclose(fp);
-      clixon_log(h, LOG_NOTICE, "%s: Startup configuration applied",
+  if (!ready_registered) {
+    int fd = vpp_ready_open();
+
+    if (fd >= 0 && clixon_event_reg_fd(fd, ready_event, h, "vpp readiness") == 0)
+      ready_registered = true;
+    else
+      clixon_log(h, LOG_WARNING,
+                 "%s: Cannot watch for VPP, will retry VPP connection on "
+                 "first operation",
                  PLUGIN_NAME);
-    }
   }
 
+  /* Apply the configuration now, or as soon as VPP is up */
+  ready_apply(h);
+  if (!vpp_is_connected())
+    clixon_log(h, LOG_NOTICE, "%s: VPP is not up yet, waiting for it",
+               PLUGIN_NAME);
+
   return 0;
 }
 
@@ -1087,6 +1293,20 @@ static int vpp_plugin_start(clixon_handle h) {
  */
 static int vpp_plugin_exit(clixon_handle h) {
   clixon_log(h, LOG_NOTICE, "%s: Stopping VPP plugin", PLUGIN_NAME);
+  if (ready_retry_pending)
+    clixon_event_unreg_timeout(ready_retry, h);
+  ready_retry_pending = false;
+  if (sync_retry_pending)
+    clixon_event_unreg_timeout(sync_retry, h);
+  sync_retry_pending = false;
+  sync_reset();
+  config_drop();
+  if (ready_registered) {
+    clixon_event_unreg_fd(vpp_ready_open(), ready_event);
+    ready_registered = false;
+  }
+  vpp_ready_close();
+  vpp_if_table_free(&state_ifs);
   vpp_disconnect();
   return 0;
 }
@@ -1095,191 +1315,767 @@ static int vpp_plugin_exit(clixon_handle h) {
  * Transaction begin callback
  */
 static int vpp_trans_begin(clixon_handle h, transaction_data td) {
-  (void)td;
+  uint64_t start = vpp_stats_now_usec();
+  int retval = 0;
+
   clixon_log(h, LOG_DEBUG, "%s: Transaction begin", PLUGIN_NAME);
+  vpp_stats_begin(transaction_id(td));
 
   if (!vpp_is_connected()) {
     if (vpp_connect() != 0) {
       clixon_err(OE_PLUGIN, 0, "Cannot connect to VPP");
-      return -1;
+      retval = -1;
     }
   }
+  /* A VPP that restarted unnoticed gets running before the diff */
+  vpp_sync(h);
 
-  return 0;
+  vpp_stats_phase(VPP_STATS_BEGIN, vpp_stats_now_usec() - start);
+  return retval;
+}
+
+/*
+ * Commit diff handling
+ *
+ * Clixon hands the commit callback the difference between running and
+ * candidate: the topmost added nodes (avec), the topmost deleted nodes
+ * (dvec) and changed leaves (scvec old / tcvec new). Only those are
+ * turned into VPP requests; unchanged configuration costs nothing.
+ */
+
+/* Interface name for a node at or below /interfaces/interface */
+static const char *commit_ifname(cxobj *x) {
+  for (; x != NULL; x = xml_parent(x)) {
+    cxobj *xp = xml_parent(x);
+    if (strcmp(xml_name(x), "interface") == 0 && xp != NULL &&
+        strcmp(xml_name(xp), "interfaces") == 0)
+      return xml_find_body(x, "name");
+  }
+  return NULL;
+}
+
+/* True for a leaf directly below an interface entry */
+static bool commit_is_if_leaf(cxobj *x) {
+  cxobj *xp = xml_parent(x);
+  return xp != NULL && strcmp(xml_name(xp), "interface") == 0;
+}
+
+/* An interface VPP lacks fails validation, through vpp_plan_check();
+ * only removing something from it has nothing left to do */
+static vpp_op_t *commit_submit(clixon_handle h, vpp_op_queue_t *q,
+                               vpp_op_type_t type, const char *ifname,
+                               bool removal) {
+  if (removal && vpp_interface_name_to_index(ifname) == (uint32_t)-1) {
+    clixon_log(h, LOG_DEBUG, "%s: %s not in VPP, nothing to remove",
+               PLUGIN_NAME, ifname);
+    return NULL;
+  }
+  return vpp_op_submit(q, type, ifname);
+}
+
+static void commit_address(clixon_handle h, vpp_op_queue_t *q,
+                           vpp_op_type_t type, cxobj *x_addr,
+                           const char *ifname) {
+  const char *ip = xml_find_body(x_addr, "ip");
+  const char *prefix = xml_find_body(x_addr, "prefix-length");
+  vpp_op_t *op;
+
+  if (ip == NULL || prefix == NULL)
+    return;
+  clixon_log(h, LOG_DEBUG, "%s: %s IP %s/%s %s %s", PLUGIN_NAME,
+             type == VPP_OP_ADD_ADDR ? "Adding" : "Deleting", ip, prefix,
+             type == VPP_OP_ADD_ADDR ? "to" : "from", ifname);
+  if ((op = commit_submit(h, q, type, ifname,
+                          type == VPP_OP_DEL_ADDR)) != NULL)
+    snprintf(op->arg, sizeof(op->arg), "%s/%s", ip, prefix);
+}
+
+/* A new or changed interface leaf: enabled, mtu, description
+ * xold: previous version of a changed leaf, NULL for a new one */
+static void commit_if_leaf(clixon_handle h, vpp_op_queue_t *q, cxobj *xold,
+                           cxobj *x, const char *ifname) {
+  const char *name = xml_name(x);
+  const char *body = xml_body(x);
+  const char *old;
+  vpp_op_t *op;
+
+  if (body == NULL)
+    return;
+  if (strcmp(name, "enabled") == 0) {
+    if ((op = commit_submit(h, q, VPP_OP_SET_STATE, ifname, false)) != NULL)
+      op->value = (strcmp(body, "true") == 0);
+  } else if (strcmp(name, "mtu") == 0) {
+    if ((op = commit_submit(h, q, VPP_OP_SET_MTU, ifname, false)) != NULL) {
+      old = xold ? xml_body(xold) : NULL;
+      op->value = (uint16_t)atoi(body);
+      /* Until ops_mtu_prev() knows better: a new leaf replaces the
+       * YANG default. The planner orders VLAN MTUs by which way the
+       * parent's moves */
+      op->value2 = old ? (uint16_t)atoi(old) : VPP_IF_DEFAULT_MTU;
+    }
+  } else if (strcmp(name, "description") == 0) {
+    op = commit_submit(h, q, VPP_OP_SET_DESCRIPTION, ifname, false);
+    if (op != NULL) {
+      old = xold ? xml_body(xold) : NULL;
+      snprintf(op->text, sizeof(op->text), "%s", body);
+      snprintf(op->text_prev, sizeof(op->text_prev), "%s", old ? old : "");
+    }
+  }
+}
+
+/* A deleted interface leaf: VPP goes back to the YANG default, or to no
+ * description; xold: the leaf as it was in running */
+static void commit_if_leaf_reset(clixon_handle h, vpp_op_queue_t *q,
+                                 cxobj *xold, const char *ifname) {
+  const char *name = xml_name(xold);
+  const char *old = xml_body(xold);
+  vpp_op_t *op;
+
+  if (old == NULL)
+    return;
+  if (strcmp(name, "enabled") == 0) {
+    if ((op = commit_submit(h, q, VPP_OP_SET_STATE, ifname, true)) != NULL)
+      op->value = 0;
+  } else if (strcmp(name, "mtu") == 0) {
+    if ((op = commit_submit(h, q, VPP_OP_SET_MTU, ifname, true)) != NULL) {
+      op->value = VPP_IF_DEFAULT_MTU;
+      op->value2 = (uint16_t)atoi(old);
+    }
+  } else if (strcmp(name, "description") == 0) {
+    op = commit_submit(h, q, VPP_OP_SET_DESCRIPTION, ifname, true);
+    if (op != NULL)
+      snprintf(op->text_prev, sizeof(op->text_prev), "%s", old);
+  }
+}
+
+/* Added subtree: queue everything it configures */
+static void commit_added(clixon_handle h, vpp_op_queue_t *q, cxobj *x) {
+  const char *name = xml_name(x);
+  const char *ifname;
+  cxobj *xc = NULL;
+
+  if (strcmp(name, "interfaces") == 0 || strcmp(name, "interface") == 0 ||
+      strcmp(name, "ipv4") == 0 || strcmp(name, "ipv6") == 0) {
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+      commit_added(h, q, xc);
+    return;
+  }
+  if ((ifname = commit_ifname(x)) == NULL)
+    return;
+  if (strcmp(name, "address") == 0)
+    commit_address(h, q, VPP_OP_ADD_ADDR, x, ifname);
+  else if (commit_is_if_leaf(x))
+    commit_if_leaf(h, q, NULL, x, ifname);
+}
+
+/* Deleted subtree: remove its addresses, reset its leaves to default */
+static void commit_deleted(clixon_handle h, vpp_op_queue_t *q, cxobj *x) {
+  const char *name = xml_name(x);
+  const char *ifname;
+  cxobj *xc = NULL;
+
+  if (strcmp(name, "interfaces") == 0 || strcmp(name, "interface") == 0 ||
+      strcmp(name, "ipv4") == 0 || strcmp(name, "ipv6") == 0) {
+    while ((xc = xml_child_each(x, xc, CX_ELMNT)) != NULL)
+      commit_deleted(h, q, xc);
+    return;
+  }
+  if ((ifname = commit_ifname(x)) == NULL)
+    return;
+  if (strcmp(name, "address") == 0)
+    commit_address(h, q, VPP_OP_DEL_ADDR, x, ifname);
+  else if (commit_is_if_leaf(x))
+    commit_if_leaf_reset(h, q, x, ifname);
+}
+
+/* Changed leaf, old (source) and new (target) version */
+static void commit_changed(clixon_handle h, vpp_op_queue_t *q, cxobj *xs,
+                           cxobj *xt) {
+  const char *ifname = commit_ifname(xt);
+  cxobj *xp = xml_parent(xt);
+
+  if (ifname == NULL)
+    return;
+  if (commit_is_if_leaf(xt)) {
+    commit_if_leaf(h, q, xs, xt, ifname);
+  } else if (xp != NULL && strcmp(xml_name(xp), "address") == 0 &&
+             strcmp(xml_name(xt), "prefix-length") == 0) {
+    /* Prefix length of an existing address: replace it */
+    commit_address(h, q, VPP_OP_DEL_ADDR, xml_parent(xs), ifname);
+    commit_address(h, q, VPP_OP_ADD_ADDR, xp, ifname);
+  }
+}
+
+/*
+ * Commit plan
+ *
+ * Validate turns the diff into the op queue, plans it and checks the
+ * plan against a snapshot of VPP's interfaces, so a bad commit fails
+ * before anything is sent. The result rides on the transaction to the
+ * commit callback, which only executes it and journals the inverse of
+ * what it applied. A failed commit, or a revert requested by Clixon,
+ * replays that journal.
+ */
+typedef struct {
+  vpp_op_queue_t q;
+  vpp_plan_t plan;
+  bool planned; /* plan is valid for q */
+  bool applied; /* Commit succeeded and was not reverted */
+  vpp_journal_t journal;
+} commit_ctx_t;
+
+static void commit_ctx_free(commit_ctx_t *ctx) {
+  if (ctx == NULL)
+    return;
+  vpp_plan_free(&ctx->plan);
+  vpp_op_queue_free(&ctx->q);
+  vpp_journal_free(&ctx->journal);
+  free(ctx);
+}
+
+static commit_ctx_t *commit_ctx_build(clixon_handle h, transaction_data td) {
+  commit_ctx_t *ctx;
+  cxobj **vec;
+  cxobj **tvec;
+  size_t len;
+  size_t i;
+
+  if ((ctx = calloc(1, sizeof(*ctx))) == NULL) {
+    clixon_err(OE_UNIX, errno, "calloc");
+    return NULL;
+  }
+  /* All writes are queued and pipelined to VPP in one go */
+  vpp_op_queue_init(&ctx->q);
+  vpp_journal_init(&ctx->journal);
+
+  /* Deletions first, so a re-added address is not removed again */
+  vec = transaction_dvec(td);
+  len = transaction_dlen(td);
+  for (i = 0; i < len; i++) {
+    if (vec[i] != NULL)
+      commit_deleted(h, &ctx->q, vec[i]);
+  }
+
+  vec = transaction_scvec(td);
+  tvec = transaction_tcvec(td);
+  len = transaction_clen(td);
+  for (i = 0; i < len; i++) {
+    if (vec[i] != NULL && tvec[i] != NULL)
+      commit_changed(h, &ctx->q, vec[i], tvec[i]);
+  }
+
+  vec = transaction_avec(td);
+  len = transaction_alen(td);
+  for (i = 0; i < len; i++) {
+    if (vec[i] != NULL)
+      commit_added(h, &ctx->q, vec[i]);
+  }
+
+  ops_mtu_prev(&ctx->q, vpp_interface_snapshot());
+  ctx->planned = (vpp_plan_build(&ctx->plan, &ctx->q) == 0);
+  return ctx;
+}
+
+/* Drop a plan left behind by a validate-only or aborted transaction */
+static void commit_ctx_release(transaction_data td) {
+  commit_ctx_free(transaction_arg(td));
+  transaction_arg_set(td, NULL);
 }
 
 /*
  * Transaction validate callback
  */
 static int vpp_trans_validate(clixon_handle h, transaction_data td) {
-  (void)td;
+  uint64_t start = vpp_stats_now_usec();
+  const vpp_if_table_t *snap;
+  commit_ctx_t *ctx;
+  char err[256];
+  int retval = -1;
+
   clixon_log(h, LOG_DEBUG, "%s: Transaction validate", PLUGIN_NAME);
-  return 0;
+
+  commit_ctx_release(td);
+  if ((ctx = commit_ctx_build(h, td)) == NULL)
+    goto done;
+
+  if (ctx->planned && (snap = vpp_interface_snapshot()) != NULL &&
+      vpp_plan_check(&ctx->plan, &ctx->q, snap, err, sizeof(err)) < 0) {
+    clixon_err(OE_PLUGIN, 0, "%s", err);
+    commit_ctx_free(ctx);
+    goto done;
+  }
+  if (ctx->planned) {
+    clixon_log(h, LOG_DEBUG, "%s: %zu VPP requests in %u dependency levels",
+               PLUGIN_NAME, ctx->q.len, ctx->plan.nlevels);
+  }
+  transaction_arg_set(td, ctx);
+  retval = 0;
+
+done:
+  vpp_stats_phase(VPP_STATS_VALIDATE, vpp_stats_now_usec() - start);
+  return retval;
+}
+
+/* Undo what the commit applied */
+static void commit_rollback(clixon_handle h, commit_ctx_t *ctx) {
+  size_t n = ctx->journal.undo.len;
+  size_t lost = ctx->journal.lost;
+  int failed;
+
+  if (n == 0 && lost == 0)
+    return;
+  clixon_log(h, LOG_NOTICE, "%s: Rolling back %zu VPP requests", PLUGIN_NAME,
+             n);
+  failed = vpp_journal_rollback(&ctx->journal);
+  vpp_interface_snapshot_invalidate();
+  if (failed != 0 || lost > 0) {
+    clixon_log(h, LOG_WARNING,
+               "%s: Rollback incomplete: %d requests failed, %zu could not "
+               "be undone",
+               PLUGIN_NAME, failed, lost);
+  }
+}
+
+/* Report a request VPP rejected */
+static void commit_report(clixon_handle h, const vpp_op_t *op) {
+  switch (op->type) {
+  case VPP_OP_SET_STATE:
+    clixon_log(h, LOG_WARNING, "%s: Failed to set admin state for %s: %s",
+               PLUGIN_NAME, op->ifname, op->error);
+    break;
+  case VPP_OP_SET_MTU:
+    clixon_log(h, LOG_WARNING, "%s: Failed to set MTU for %s: %s",
+               PLUGIN_NAME, op->ifname, op->error);
+    break;
+  case VPP_OP_DEL_ADDR:
+    clixon_log(h, LOG_WARNING, "%s: Failed to delete IP %s from %s: %s",
+               PLUGIN_NAME, op->arg, op->ifname, op->error);
+    break;
+  case VPP_OP_ADD_ADDR:
+    clixon_log(h, LOG_WARNING, "%s: Failed to add IP %s to %s: %s",
+               PLUGIN_NAME, op->arg, op->ifname, op->error);
+    break;
+  default:
+    clixon_log(h, LOG_WARNING, "%s: %s on %s failed: %s", PLUGIN_NAME,
+               vpp_op_type_str(op->type), op->ifname, op->error);
+    break;
+  }
 }
 
 /*
  * Transaction commit callback
  */
 static int vpp_trans_commit(clixon_handle h, transaction_data td) {
-  cxobj *target;
-  cxobj *x_ifs;
-  cxobj *x_if;
-  cxobj **dvec;
-  size_t dlen;
+  uint64_t start = vpp_stats_now_usec();
+  commit_ctx_t *ctx = transaction_arg(td);
+  const vpp_if_table_t *snap;
+  const vpp_op_t *first = NULL;
+  vpp_op_queue_t *q;
+  vpp_op_t *op;
   size_t i;
+  size_t unsent = 0;
+  int drained;
+  int retval = -1;
 
   clixon_log(h, LOG_DEBUG, "%s: Transaction commit", PLUGIN_NAME);
 
-  /* First, process deleted elements from dvec */
-  dvec = transaction_dvec(td);
-  dlen = transaction_dlen(td);
-
-  for (i = 0; i < dlen; i++) {
-    cxobj *del = dvec[i];
-    if (del == NULL)
+  /* Normally planned by validate; build it here if validate did not run.
+   * It stays on the transaction for revert, end frees it. */
+  if (ctx == NULL) {
+    if ((ctx = commit_ctx_build(h, td)) == NULL)
+      goto done;
+    transaction_arg_set(td, ctx);
+  }
+  q = &ctx->q;
+
+  /* State before the commit, for the inverses in the journal */
+  snap = vpp_interface_snapshot();
+
+  /* Send in dependency order, then report per request */
+  if (ctx->planned)
+    drained = vpp_plan_execute(&ctx->plan, q);
+  else
+    drained = vpp_op_drain(q);
+  if (vpp_journal_record(&ctx->journal, q,
+                         ctx->planned ? ctx->plan.order : NULL, snap) < 0) {
+    clixon_log(h, LOG_WARNING, "%s: Rollback journal incomplete",
+               PLUGIN_NAME);
+  }
+  vpp_interface_snapshot_invalidate();
+  vpp_stats_ops(q->ops, q->len);
+  if (drained < 0) {
+    clixon_log(h, LOG_WARNING, "%s: Lost VPP connection during commit",
+               PLUGIN_NAME);
+  }
+  for (i = 0; i < q->len; i++) {
+    op = &q->ops[i];
+    if (op->rv == 0)
       continue;
-
-    const char *name = xml_name(del);
-    if (name == NULL)
+    if (op->rv == VPP_OP_NOT_SENT) {
+      unsent++;
       continue;
-
-    /* Check if this is an address deletion */
-    if (strcmp(name, "address") == 0) {
-      const char *ip = xml_find_body(del, "ip");
-      const char *prefix = xml_find_body(del, "prefix-length");
-
-      if (ip && prefix) {
-        /* Find parent interface name by walking up the XML tree */
-        cxobj *parent = xml_parent(del); /* ipv4 or ipv6 container */
-        if (parent) {
-          parent = xml_parent(parent); /* interface */
-          if (parent) {
-            const char *ifname = xml_find_body(parent, "name");
-            if (ifname) {
-              char addr_str[128];
-              snprintf(addr_str, sizeof(addr_str), "%s/%s", ip, prefix);
-              clixon_log(h, LOG_DEBUG, "%s: Deleting IP %s from %s",
-                         PLUGIN_NAME, addr_str, ifname);
-              if (vpp_interface_del_ip_address(ifname, addr_str) != 0) {
-                clixon_log(h, LOG_WARNING, "%s: Failed to delete IP %s from %s",
-                           PLUGIN_NAME, addr_str, ifname);
-              }
-            }
-          }
-        }
-      }
     }
+    if (first == NULL)
+      first = op;
+    commit_report(h, op);
+  }
+  if (unsent > 0) {
+    clixon_log(h, LOG_WARNING, "%s: %zu VPP requests not sent", PLUGIN_NAME,
+               unsent);
+  }
+
+  /* Leave VPP as it was rather than half configured */
+  if (first != NULL || unsent > 0) {
+    commit_rollback(h, ctx);
+    if (first != NULL)
+      clixon_err(OE_PLUGIN, 0, "VPP rejected %s on %s: %s",
+                 vpp_op_type_str(first->type), first->ifname, first->error);
+    else
+      clixon_err(OE_PLUGIN, 0, "Lost VPP connection during commit");
+    goto done;
   }
+  clixon_log(h, LOG_DEBUG, "%s: Commit applied %zu VPP requests", PLUGIN_NAME,
+             q->len);
+  ctx->applied = true;
+  retval = 0;
 
-  /* Now process target configuration for additions */
-  target = transaction_target(td);
-  if (target == NULL) {
-    return 0;
+done:
+  vpp_stats_phase(VPP_STATS_COMMIT, vpp_stats_now_usec() - start);
+  vpp_stats_commit_done(retval == 0);
+  return retval;
+}
+
+/*
+ * Transaction revert callback
+ * A plugin after this one failed its commit: undo ours
+ */
+static int vpp_trans_revert(clixon_handle h, transaction_data td) {
+  commit_ctx_t *ctx = transaction_arg(td);
+
+  if (ctx != NULL) {
+    commit_rollback(h, ctx);
+    ctx->applied = false;
   }
+  return 0;
+}
 
-  /* Find interfaces container */
-  x_ifs = xpath_first(target, NULL, "/interfaces");
-  if (x_ifs == NULL) {
-    return 0;
+/*
+ * Startup exec script
+ *
+ * The configuration as it would be built from scratch: config_ops()
+ * below adds bonds, members and LCP pairs from vpp_config.xml to the
+ * committed interfaces, per interface sub-interface, description, MTU,
+ * admin state and addresses. The planner orders what the queue order
+ * leaves open. MTUs are taken to come from the one a starting VPP gives
+ * interfaces, which new VLANs inherit: a parent MTU lands after its
+ * VLANs' unless it goes above that.
+ */
+static void script_addresses(vpp_op_queue_t *q, cxobj *xif, const char *name,
+                             const char *family) {
+  cxobj *xfam = xml_find_type(xif, NULL, family, CX_ELMNT);
+  cxobj *xa = NULL;
+  vpp_op_t *op;
+
+  while ((xa = child_next(xfam, xa, "address")) != NULL) {
+    const char *ip = xml_find_body(xa, "ip");
+    const char *prefix = xml_find_body(xa, "prefix-length");
+    if (ip && prefix && (op = vpp_op_submit(q, VPP_OP_ADD_ADDR, name)) != NULL)
+      snprintf(op->arg, sizeof(op->arg), "%s/%s", ip, prefix);
   }
+}
 
-  /* Process each interface */
-  x_if = NULL;
-  while ((x_if = xml_child_each(x_ifs, x_if, CX_ELMNT)) != NULL) {
-    if (strcmp(xml_name(x_if), "interface") != 0) {
-      continue;
-    }
+static void script_interfaces(vpp_op_queue_t *q, cxobj *xifs) {
+  cxobj *xif;
+  vpp_op_t *op;
+
+  /* Sub-interfaces all exist before any of them is configured */
+  xif = NULL;
+  while ((xif = child_next(xifs, xif, "interface")) != NULL) {
+    const char *name = xml_find_body(xif, "name");
+    const char *dot = name ? strchr(name, '.') : NULL;
 
-    const char *ifname = xml_find_body(x_if, "name");
-    if (ifname == NULL) {
+    if (!dot || !(op = vpp_op_submit(q, VPP_OP_CREATE_SUBIF, name)))
       continue;
-    }
+    snprintf(op->arg, sizeof(op->arg), "%.*s", (int)(dot - name), name);
+    op->value = (uint32_t)strtoul(dot + 1, NULL, 10);
+    op->value2 = op->value;
+  }
 
-    uint32_t sw_if_index = vpp_interface_name_to_index(ifname);
-    if (sw_if_index == (uint32_t)-1) {
-      clixon_log(h, LOG_WARNING, "Interface %s not found in VPP", ifname);
+  xif = NULL;
+  while ((xif = child_next(xifs, xif, "interface")) != NULL) {
+    const char *name = xml_find_body(xif, "name");
+    const char *descr = xml_find_body(xif, "description");
+    const char *mtu = xml_find_body(xif, "mtu");
+    const char *enabled = xml_find_body(xif, "enabled");
+
+    if (!name)
       continue;
+    /* One bad description must not cost the whole script */
+    if (descr && *descr && vpp_op_text_ok(descr) &&
+        (op = vpp_op_submit(q, VPP_OP_SET_DESCRIPTION, name)) != NULL)
+      snprintf(op->text, sizeof(op->text), "%s", descr);
+    if (mtu && (op = vpp_op_submit(q, VPP_OP_SET_MTU, name)) != NULL) {
+      op->value = (uint32_t)strtoul(mtu, NULL, 10);
+      op->value2 = VPP_IF_BOOT_MTU;
     }
+    if (enabled && (op = vpp_op_submit(q, VPP_OP_SET_STATE, name)) != NULL)
+      op->value = strcmp(enabled, "true") == 0;
+    script_addresses(q, xif, name, "ipv4");
+    script_addresses(q, xif, name, "ipv6");
+  }
+}
 
-    /* Apply description (via vppctl since VAPI doesn't support it) */
-    const char *description = xml_find_body(x_if, "description");
-    if (description != NULL) {
-      char cmd[512];
-      snprintf(cmd, sizeof(cmd),
-               "sudo vppctl -s /run/vpp/cli.sock set interface description %s "
-               "\"%s\"",
-               ifname, description);
-      int ret_desc = system(cmd);
-      if (ret_desc != 0) {
-        clixon_log(h, LOG_WARNING, "Failed to set description for %s", ifname);
-      } else {
-        clixon_log(h, LOG_DEBUG, "%s: Set description for %s: %s", PLUGIN_NAME,
-                   ifname, description);
-      }
-    }
+/*
+ * Applying the saved configuration to VPP
+ *
+ * Two sources make up what VPP should have. vpp_config.xml, saved by
+ * the CLI plugin, is the only one that holds bonds, their members and
+ * LCP pairs; the running datastore holds the interface settings as
+ * committed, descriptions included. Bonds, members and LCP pairs come
+ * from the file, and so do the interfaces running does not know; the
+ * interfaces running knows take its settings instead.
+ *
+ * The file is parsed again only when it changed, as the startup script
+ * is rebuilt from both on every commit.
+ */
+static cxobj *config_xt;
+static struct stat config_st;
+
+static void config_drop(void) {
+  if (config_xt)
+    xml_free(config_xt);
+  config_xt = NULL;
+  memset(&config_st, 0, sizeof(config_st));
+}
 
-    /* Apply enabled state */
-    const char *enabled = xml_find_body(x_if, "enabled");
-    if (enabled != NULL) {
-      bool admin_up = (strcmp(enabled, "true") == 0);
-      if (vpp_interface_set_flags(sw_if_index, admin_up) != 0) {
-        clixon_err(OE_PLUGIN, 0, "Failed to set admin state for %s", ifname);
-      }
-    }
+/* vpp_config.xml's <config>, or NULL if there is none or it is broken */
+static cxobj *config_load(clixon_handle h) {
+  const char *env = getenv("VPP_CONFIG_FILE");
+  const char *path = env && *env ? env : VPP_CONFIG_FILE;
+  cxobj *xt = NULL;
+  struct stat st;
+  FILE *fp;
+  int rv;
+
+  if (stat(path, &st) < 0) {
+    config_drop();
+    return NULL;
+  }
+  if (config_xt && st.st_ino == config_st.st_ino &&
+      st.st_size == config_st.st_size &&
+      st.st_mtim.tv_sec == config_st.st_mtim.tv_sec &&
+      st.st_mtim.tv_nsec == config_st.st_mtim.tv_nsec)
+    return xml_find_type(config_xt, NULL, "config", CX_ELMNT);
+  config_drop();
+  if (!(fp = fopen(path, "r")))
+    return NULL;
+  rv = clixon_xml_parse_file(fp, YB_NONE, NULL, &xt, NULL);
+  fclose(fp);
+  if (rv < 0 || !xt) {
+    clixon_log(h, LOG_WARNING, "%s: Cannot parse %s, bonds and LCP pairs "
+               "left out", PLUGIN_NAME, path);
+    if (xt)
+      xml_free(xt);
+    return NULL;
+  }
+  config_xt = xt;
+  config_st = st;
+  return xml_find_type(config_xt, NULL, "config", CX_ELMNT);
+}
 
-    /* Apply MTU */
-    const char *mtu_str = xml_find_body(x_if, "mtu");
-    if (mtu_str != NULL) {
-      uint16_t mtu = (uint16_t)atoi(mtu_str);
-      if (vpp_interface_set_mtu(sw_if_index, mtu) != 0) {
-        clixon_err(OE_PLUGIN, 0, "Failed to set MTU for %s", ifname);
-      }
+/* vpp_config.xml xcfg and running xrun merged into q; either may be NULL */
+static void config_ops(vpp_op_queue_t *q, cxobj *xcfg, cxobj *xrun) {
+  cxobj *xifs = xml_find_type(xrun, NULL, "interfaces", CX_ELMNT);
+  clicon_hash_t *running = NULL;
+  cxobj *xif = NULL;
+
+  if (xifs && (running = clicon_hash_init()) != NULL)
+    while ((xif = child_next(xifs, xif, "interface")) != NULL) {
+      const char *name = xml_find_body(xif, "name");
+      if (name)
+        clicon_hash_add(running, name, NULL, 0);
     }
+  if (xcfg)
+    startup_plan(xcfg, running, q);
+  script_interfaces(q, xifs);
+  if (running)
+    clicon_hash_free(running);
+}
 
-    /* Apply IPv4 addresses (only new ones via avec would be ideal,
-       but for simplicity we try adding all - duplicates will fail silently) */
-    cxobj *x_ipv4 = xml_find(x_if, "ipv4");
-    if (x_ipv4 != NULL) {
-      cxobj *x_addr = NULL;
-      while ((x_addr = xml_child_each(x_ipv4, x_addr, CX_ELMNT)) != NULL) {
-        if (strcmp(xml_name(x_addr), "address") != 0) {
-          continue;
-        }
-        const char *ip = xml_find_body(x_addr, "ip");
-        const char *prefix = xml_find_body(x_addr, "prefix-length");
-        if (ip && prefix) {
-          char addr_str[64];
-          snprintf(addr_str, sizeof(addr_str), "%s/%s", ip, prefix);
-          clixon_log(h, LOG_DEBUG, "%s: Adding IPv4 %s to %s", PLUGIN_NAME,
-                     addr_str, ifname);
-          /* Ignore errors for already-existing addresses */
-          vpp_interface_add_ip_address(ifname, addr_str);
-        }
-      }
-    }
+/*
+ * Bring VPP up to the saved configuration with one vpp_cli_exec_batch()
+ *
+ * A backend restart mostly finds VPP up and configured, and a VPP that
+ * booted from the startup script has all of it: what VPP already has is
+ * left out, so only what drifted is sent, plus the descriptions, which
+ * VPP cannot be asked for.
+ * Returns -1 if VPP did not take all of it
+ */
+static int config_apply(clixon_handle h) {
+  startup_cmds_t sc = {0};
+  cxobj *xcfg = config_load(h);
+  live_state_t live;
+  vpp_op_queue_t q;
+  cxobj *xrun = NULL;
+  size_t present;
+  size_t failed;
+
+  if (xmldb_get(h, "running", NULL, "/", &xrun) < 0 && xrun) {
+    xml_free(xrun);
+    xrun = NULL;
+  }
+  vpp_op_queue_init(&q);
+  config_ops(&q, xcfg, xrun);
+  if (xrun)
+    xml_free(xrun);
+
+  live_read(&live);
+  ops_mtu_prev(&q, live.snap);
+  present = ops_pending(&q, &live, &sc);
+  live_free(&live);
+  if (present > 0)
+    clixon_log(h, LOG_NOTICE, "%s: %zu of %zu commands already in VPP",
+               PLUGIN_NAME, present, q.len);
+  vpp_op_queue_free(&q);
+  failed = startup_replay(h, &sc);
+  startup_cmds_free(&sc);
+  clixon_log(h, LOG_NOTICE, "%s: Configuration applied", PLUGIN_NAME);
+  return failed > 0 ? -1 : 0;
+}
 
-    /* Apply IPv6 addresses */
-    cxobj *x_ipv6 = xml_find(x_if, "ipv6");
-    if (x_ipv6 != NULL) {
-      cxobj *x_addr = NULL;
-      while ((x_addr = xml_child_each(x_ipv6, x_addr, CX_ELMNT)) != NULL) {
-        if (strcmp(xml_name(x_addr), "address") != 0) {
-          continue;
-        }
-        const char *ip = xml_find_body(x_addr, "ip");
-        const char *prefix = xml_find_body(x_addr, "prefix-length");
-        if (ip && prefix) {
-          char addr_str[128];
-          snprintf(addr_str, sizeof(addr_str), "%s/%s", ip, prefix);
-          clixon_log(h, LOG_DEBUG, "%s: Adding IPv6 %s to %s", PLUGIN_NAME,
-                     addr_str, ifname);
-          /* Ignore errors for already-existing addresses */
-          vpp_interface_add_ip_address(ifname, addr_str);
-        }
-      }
-    }
-  }
+/* Regenerate the script from vpp_config.xml and the configuration just
+ * committed */
+static void startup_script_write(clixon_handle h, cxobj *xt) {
+  const char *env = getenv("VPP_STARTUP_SCRIPT");
+  const char *path = env && *env ? env : VPP_STARTUP_SCRIPT;
+  vpp_op_queue_t q;
+  int rv;
+
+  vpp_op_queue_init(&q);
+  config_ops(&q, config_load(h), xt);
+  rv = vpp_startup_write(path, &q);
+  if (rv < 0)
+    clixon_log(h, LOG_WARNING, "%s: Cannot write %s: %s", PLUGIN_NAME, path,
+               strerror(errno));
+  else if (rv > 0)
+    clixon_log(h, LOG_DEBUG, "%s: Wrote %s, %zu commands", PLUGIN_NAME, path,
+               q.len);
+  vpp_op_queue_free(&q);
+}
 
+/*
+ * Reconciliation after a VPP restart
+ *
+ * Every new CLI session moves vpp_connection_epoch(); VPP's PID tells a
+ * reconnect to the same VPP from a VPP that restarted. A restarted VPP
+ * gets config_apply() again, minus what VPP already has (all of it if
+ * VPP booted from the startup script). It is one batch, and NETCONF,
+ * RESTCONF and CLI sessions stay up while it runs. A reconcile that
+ * left commands failed runs again SYNC_RETRY_MS later, doubling, up to
+ * SYNC_RETRIES times; any sync in between does it sooner.
+ */
+#define SYNC_RETRIES 3
+#define SYNC_RETRY_MS 1000
+
+static uint64_t sync_epoch;
+static uint32_t sync_pid;
+static bool sync_done;
+static unsigned sync_failed; /* Reconciles in a row that failed commands */
+
+/* Forget the VPP seen last: the next start applies vpp_config.xml again */
+static void sync_reset(void) {
+  sync_epoch = 0;
+  sync_pid = 0;
+  sync_done = false;
+  sync_failed = 0;
+}
+
+static int sync_retry(int fd, void *arg) {
+  (void)fd;
+  sync_retry_pending = false;
+  vpp_sync(arg);
+  return 0;
+}
+
+static void sync_retry_schedule(clixon_handle h) {
+  int ms = SYNC_RETRY_MS << (sync_failed - 1);
+  struct timeval t;
+
+  if (sync_retry_pending)
+    return;
+  gettimeofday(&t, NULL);
+  t.tv_sec += ms / 1000;
+  t.tv_usec += (ms % 1000) * 1000;
+  t.tv_sec += t.tv_usec / 1000000;
+  t.tv_usec %= 1000000;
+  if (clixon_event_reg_timeout(t, sync_retry, h, "vpp reconcile retry") == 0)
+    sync_retry_pending = true;
+}
+
+/* Bring a VPP seen through a new session up to date; cheap otherwise */
+static void vpp_sync(clixon_handle h) {
+  uint64_t epoch = vpp_connection_epoch();
+  uint32_t pid = vpp_connection_pid();
+  uint32_t last = sync_pid;
+  bool retry = sync_failed > 0 && sync_failed <= SYNC_RETRIES;
+
+  if (!vpp_is_connected() || (epoch == sync_epoch && !retry))
+    return;
+  sync_epoch = epoch;
+  if (sync_done && pid != 0 && pid == sync_pid && !retry)
+    return; /* Same VPP, new session */
+  sync_pid = pid;
+
+  if (!sync_done) {
+    sync_done = true;
+    clixon_log(h, LOG_NOTICE, "%s: Loading startup configuration",
+               PLUGIN_NAME);
+    config_apply(h);
+    return;
+  }
+  if (!retry || pid != last) {
+    sync_failed = 0;
+    clixon_log(h, LOG_NOTICE,
+               "%s: VPP restarted (pid %u -> %u), reconciling running "
+               "configuration",
+               PLUGIN_NAME, last, pid);
+  } else {
+    clixon_log(h, LOG_NOTICE,
+               "%s: Reconciling running configuration again (%u of %u)",
+               PLUGIN_NAME, sync_failed, SYNC_RETRIES);
+  }
+  vpp_interface_snapshot_invalidate();
+  vpp_ifcache_invalidate();
+  if (config_apply(h) == 0)
+    sync_failed = 0;
+  else if (++sync_failed <= SYNC_RETRIES)
+    sync_retry_schedule(h);
+  else
+    clixon_log(h, LOG_ERR,
+               "%s: Running configuration not fully applied to VPP after "
+               "%u attempts, giving up until VPP restarts",
+               PLUGIN_NAME, sync_failed);
+}
+
+/*
+ * Transaction end callback
+ * Running now holds the target: refresh the startup script
+ */
+static int vpp_trans_end(clixon_handle h, transaction_data td) {
+  commit_ctx_t *ctx = transaction_arg(td);
+
+  if (ctx != NULL && ctx->applied && transaction_target(td) != NULL)
+    startup_script_write(h, transaction_target(td));
+  commit_ctx_release(td);
+  return 0;
+}
+
+/*
+ * Transaction abort callback
+ */
+static int vpp_trans_abort(clixon_handle h, transaction_data td) {
+  (void)h;
+  commit_ctx_release(td);
   return 0;
 }
 
@@ -1307,23 +2103,157 @@ static cxobj *vpp_xml_element(const char *name, cxobj *parent,
   return x_elem;
 }
 
+#define VPP_INTERFACES_NS "http://example.com/vpp/interfaces"
+
+static void vpp_xml_uint(const char *name, cxobj *parent, uint64_t value) {
+  char buf[24];
+
+  snprintf(buf, sizeof(buf), "%" PRIu64, value);
+  vpp_xml_element(name, parent, buf);
+}
+
+/*
+ * State data: commit-statistics
+ * Per-phase latency histograms and the most recent commits
+ */
+static int vpp_statedata_commit_stats(cxobj *xstate) {
+  cxobj *x_stats;
+  cxobj *x;
+  cxobj *xp;
+  char buf[32];
+
+  if ((x_stats = xml_new("commit-statistics", xstate, CX_ELMNT)) == NULL)
+    return -1;
+  xmlns_set(x_stats, NULL, VPP_INTERFACES_NS);
+
+  for (int p = 0; p < VPP_STATS_PHASES; p++) {
+    const vpp_stats_hist_t *hist = vpp_stats_hist(p);
+
+    if ((x = xml_new("phase", x_stats, CX_ELMNT)) == NULL)
+      return -1;
+    vpp_xml_element("name", x, vpp_stats_phase_str(p));
+    vpp_xml_uint("count", x, hist->count);
+    vpp_xml_uint("total-usec", x, hist->total_usec);
+    vpp_xml_uint("min-usec", x, hist->min_usec);
+    vpp_xml_uint("max-usec", x, hist->max_usec);
+    for (unsigned b = 0; b < VPP_STATS_BUCKETS; b++) {
+      if (hist->bucket[b] == 0)
+        continue;
+      if ((xp = xml_new("bucket", x, CX_ELMNT)) == NULL)
+        return -1;
+      vpp_xml_uint("le-usec", xp, vpp_stats_bucket_le(b));
+      vpp_xml_uint("count", xp, hist->bucket[b]);
+    }
+  }
+
+  for (size_t i = 0; i < VPP_STATS_RECENT; i++) {
+    const vpp_stats_commit_t *c = vpp_stats_recent(i);
+    struct tm tm;
+
+    if (c == NULL)
+      break;
+    if ((x = xml_new("recent-commit", x_stats, CX_ELMNT)) == NULL)
+      return -1;
+    vpp_xml_uint("id", x, c->id);
+    gmtime_r(&c->when, &tm);
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    vpp_xml_element("time", x, buf);
+    vpp_xml_element("result", x, c->ok ? "ok" : "failed");
+    vpp_xml_uint("operations", x, c->nops);
+    for (int p = 0; p < VPP_STATS_PHASES; p++) {
+      if (c->count[p] == 0)
+        continue;
+      if ((xp = xml_new("phase", x, CX_ELMNT)) == NULL)
+        return -1;
+      vpp_xml_element("name", xp, vpp_stats_phase_str(p));
+      vpp_xml_uint("count", xp, c->count[p]);
+      vpp_xml_uint("usec", xp, c->usec[p]);
+    }
+  }
+  return 0;
+}
+
+/*
+ * State data: transport-statistics
+ * Counters and latency per VPP command verb
+ */
+static int vpp_statedata_transport_stats(cxobj *xstate) {
+  vpp_tstats_verb_t *verbs;
+  cxobj *x_stats;
+  cxobj *x;
+  cxobj *xb;
+  size_t n;
+  int ret = -1;
+
+  if ((verbs = calloc(VPP_TSTATS_VERBS, sizeof(*verbs))) == NULL)
+    return -1;
+  n = vpp_tstats_read(verbs, VPP_TSTATS_VERBS);
+
+  if ((x_stats = xml_new("transport-statistics", xstate, CX_ELMNT)) == NULL)
+    goto done;
+  xmlns_set(x_stats, NULL, VPP_INTERFACES_NS);
+
+  for (size_t i = 0; i < n; i++) {
+    const vpp_tstats_verb_t *v = &verbs[i];
+
+    if ((x = xml_new("verb", x_stats, CX_ELMNT)) == NULL)
+      goto done;
+    vpp_xml_element("name", x, v->verb);
+    vpp_xml_uint("calls", x, v->calls);
+    vpp_xml_uint("errors", x, v->errors);
+    vpp_xml_uint("bytes-read", x, v->bytes);
+    vpp_xml_uint("total-usec", x, v->total_usec);
+    vpp_xml_uint("max-usec", x, v->max_usec);
+    vpp_xml_uint("p50-usec", x, vpp_tstats_percentile(v, 0.50));
+    vpp_xml_uint("p90-usec", x, vpp_tstats_percentile(v, 0.90));
+    vpp_xml_uint("p99-usec", x, vpp_tstats_percentile(v, 0.99));
+    for (unsigned b = 0; b < VPP_TSTATS_BUCKETS; b++) {
+      if (v->bucket[b] == 0)
+        continue;
+      if ((xb = xml_new("bucket", x, CX_ELMNT)) == NULL)
+        goto done;
+      vpp_xml_uint("le-usec", xb, vpp_tstats_bucket_le(b));
+      vpp_xml_uint("count", xb, v->bucket[b]);
+    }
+  }
+  ret = 0;
+
+done:
+  free(verbs);
+  return ret;
+}
+
 /*
  * State data callback
  * Called by Clixon to populate operational/state data
  */
-#define VPP_INTERFACES_NS "http://example.com/vpp/interfaces"
 
 static int vpp_statedata(clixon_handle h, cvec *nsc, char *xpath,
                          cxobj *xstate) {
   (void)nsc;
-  vpp_interface_info_t *interfaces = NULL;
-  vpp_interface_info_t *curr;
+  vpp_if_table_t *t = &state_ifs;
   cxobj *x_ifs = NULL;
   int ret = 0;
 
   clixon_log(h, LOG_DEBUG, "%s: State data request for: %s", PLUGIN_NAME,
              xpath ? xpath : "(null)");
 
+  /* Commit statistics need no VPP round trip */
+  if (xpath != NULL &&
+      (strstr(xpath, "commit-statistics") != NULL ||
+       strstr(xpath, VPP_INTERFACES_NS) != NULL || strcmp(xpath, "/") == 0) &&
+      vpp_statedata_commit_stats(xstate) < 0) {
+    clixon_log(h, LOG_WARNING, "%s: Failed to add commit statistics",
+               PLUGIN_NAME);
+  }
+  if (xpath != NULL &&
+      (strstr(xpath, "transport-statistics") != NULL ||
+       strstr(xpath, VPP_INTERFACES_NS) != NULL || strcmp(xpath, "/") == 0) &&
+      vpp_statedata_transport_stats(xstate) < 0) {
+    clixon_log(h, LOG_WARNING, "%s: Failed to add transport statistics",
+               PLUGIN_NAME);
+  }
+
   /* Check if this request is for our interfaces module
    * Match both full path and simple "interfaces" queries */
   if (xpath == NULL ||
@@ -1342,13 +2272,15 @@ static int vpp_statedata(clixon_handle h, cvec *nsc, char *xpath,
       return 0;
     }
   }
+  vpp_sync(h);
 
   /* Get interfaces from VPP */
-  if (vpp_interface_dump(&interfaces) != 0) {
+  if (vpp_interface_dump(t) != 0) {
     clixon_log(h, LOG_WARNING, "%s: Failed to dump VPP interfaces",
                PLUGIN_NAME);
     return 0;
   }
+  vpp_ifcache_sync(t);
 
   /* Create interfaces container with proper namespace */
   x_ifs = xml_new("interfaces", xstate, CX_ELMNT);
@@ -1365,7 +2297,13 @@ static int vpp_statedata(clixon_handle h, cvec *nsc, char *xpath,
   }
 
   /* Iterate through VPP interfaces */
-  for (curr = interfaces; curr != NULL; curr = curr->next) {
+  for (uint32_t idx = 0; idx < t->max; idx++) {
+    const vpp_if_hot_t *hot = &t->hot[idx];
+    const vpp_if_cold_t *cold = &t->cold[idx];
+
+    if (!(hot->flags & VPP_IF_F_PRESENT)) {
+      continue;
+    }
     cxobj *x_if = xml_new("interface", x_ifs, CX_ELMNT);
     if (x_if == NULL) {
       continue;
@@ -1374,34 +2312,47 @@ static int vpp_statedata(clixon_handle h, cvec *nsc, char *xpath,
     char buf[64];
 
     /* Name (key) */
-    vpp_xml_element("name", x_if, curr->name);
+    vpp_xml_element("name", x_if, cold->name);
 
     /* Type */
-    vpp_xml_element("type", x_if, curr->type);
+    vpp_xml_element("type", x_if, cold->type);
 
     /* sw-if-index */
-    snprintf(buf, sizeof(buf), "%u", curr->sw_if_index);
+    snprintf(buf, sizeof(buf), "%u", hot->sw_if_index);
     vpp_xml_element("sw-if-index", x_if, buf);
 
     /* oper-status */
-    vpp_xml_element("oper-status", x_if, curr->link_up ? "up" : "down");
+    vpp_xml_element("oper-status", x_if,
+                    (hot->flags & VPP_IF_F_LINK_UP) ? "up" : "down");
 
     /* enabled (admin status) */
-    vpp_xml_element("enabled", x_if, curr->admin_up ? "true" : "false");
+    vpp_xml_element("enabled", x_if,
+                    (hot->flags & VPP_IF_F_ADMIN_UP) ? "true" : "false");
 
     /* MAC address */
     char mac_str[18];
-    vpp_mac_bytes_to_string(curr->mac, mac_str, sizeof(mac_str));
+    vpp_mac_bytes_to_string(cold->mac, mac_str, sizeof(mac_str));
     vpp_xml_element("mac-address", x_if, mac_str);
 
     /* MTU */
-    snprintf(buf, sizeof(buf), "%u", curr->mtu);
+    snprintf(buf, sizeof(buf), "%u", hot->mtu);
     vpp_xml_element("mtu", x_if, buf);
 
-    /* Link speed (if available) */
-    if (curr->link_speed > 0) {
-      snprintf(buf, sizeof(buf), "%u", curr->link_speed);
-      vpp_xml_element("speed", x_if, buf);
+    /* Link speed in Mbps (if available) */
+    if (hot->link_speed > 0) {
+      snprintf(buf, sizeof(buf), "%u", hot->link_speed);
+      vpp_xml_element("link-speed", x_if, buf);
+    }
+
+    /* Link duplex */
+    vpp_xml_element("link-duplex", x_if,
+                    hot->link_duplex == VPP_LINK_DUPLEX_FULL   ? "full"
+                    : hot->link_duplex == VPP_LINK_DUPLEX_HALF ? "half"
+                                                                : "unknown");
+
+    /* Driver (device class) */
+    if (cold->driver[0]) {
+      vpp_xml_element("driver", x_if, cold->driver);
     }
   }
 
@@ -1409,7 +2360,6 @@ static int vpp_statedata(clixon_handle h, cvec *nsc, char *xpath,
              PLUGIN_NAME);
 
 done:
-  vpp_interface_list_free(interfaces);
   return ret;
 }
 
@@ -1424,6 +2374,9 @@ static clixon_plugin_api api = {
     .ca_trans_begin = vpp_trans_begin,
     .ca_trans_validate = vpp_trans_validate,
     .ca_trans_commit = vpp_trans_commit,
+    .ca_trans_revert = vpp_trans_revert,
+    .ca_trans_end = vpp_trans_end,
+    .ca_trans_abort = vpp_trans_abort,
     .ca_statedata = vpp_statedata,
 };
 
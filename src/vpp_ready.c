@@ -0,0 +1,149 @@
+/*
+ * vpp_ready.c - Event-driven VPP readiness
+ *
+ * Each socket's directory is watched, or its nearest existing ancestor
+ * while the directory is missing; watches are re-armed after every
+ * batch of events, so a directory that appears is watched from then on.
+ * Readiness is decided by looking at the sockets themselves, the events
+ * only say when to look. A socket deleted and re-created within one
+ * batch still reports GONE, so a fast VPP restart is not missed.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vpp_connection.h"
+#include "vpp_ready.h"
+
+#define READY_MAX_SOCKETS 2
+#define READY_EVENTS                                                           \
+  (IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF |      \
+   IN_MOVE_SELF | IN_ONLYDIR)
+
+static int ready_fd = -1;
+static bool ready_up; /* Every socket was there at the last look */
+
+static const char *env_or(const char *name, const char *def) {
+  const char *v = getenv(name);
+  return v && *v ? v : def;
+}
+
+static size_t ready_sockets(const char **paths) {
+  size_t n = 0;
+
+  paths[n++] = env_or("VPP_CLI_SOCK", VPP_CLI_SOCKET);
+#ifndef VPP_STUB_MODE
+  paths[n++] = env_or("VPP_API_SOCK", VPP_API_SOCKET);
+#endif
+  return n;
+}
+
+static const char *base_name(const char *path) {
+  const char *slash = strrchr(path, '/');
+  return slash ? slash + 1 : path;
+}
+
+/* Watch the directory of path, or the closest ancestor that exists */
+static void ready_watch(const char *path) {
+  char dir[PATH_MAX];
+  char *slash;
+
+  if (snprintf(dir, sizeof(dir), "%s", path) >= (int)sizeof(dir))
+    return;
+  for (;;) {
+    if (!(slash = strrchr(dir, '/')))
+      snprintf(dir, sizeof(dir), ".");
+    else if (slash == dir)
+      dir[1] = '\0';
+    else
+      *slash = '\0';
+    if (inotify_add_watch(ready_fd, dir, READY_EVENTS) >= 0 ||
+        errno != ENOENT || strcmp(dir, "/") == 0 || strcmp(dir, ".") == 0)
+      return;
+  }
+}
+
+static void ready_arm(void) {
+  const char *paths[READY_MAX_SOCKETS];
+  size_t n = ready_sockets(paths);
+
+  for (size_t i = 0; i < n; i++)
+    ready_watch(paths[i]);
+}
+
+bool vpp_ready_sockets(void) {
+  const char *paths[READY_MAX_SOCKETS];
+  size_t n = ready_sockets(paths);
+  struct stat st;
+
+  for (size_t i = 0; i < n; i++)
+    if (stat(paths[i], &st) != 0 || !S_ISSOCK(st.st_mode))
+      return false;
+  return true;
+}
+
+int vpp_ready_open(void) {
+  if (ready_fd >= 0)
+    return ready_fd;
+  if ((ready_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0) {
+    fprintf(stderr, "[vpp] inotify_init1() failed: %s\n", strerror(errno));
+    return -1;
+  }
+  ready_arm();
+  ready_up = vpp_ready_sockets();
+  return ready_fd;
+}
+
+void vpp_ready_close(void) {
+  if (ready_fd >= 0)
+    close(ready_fd);
+  ready_fd = -1;
+  ready_up = false;
+}
+
+/* An event removed one of the sockets */
+static bool ready_removed(const struct inotify_event *ev) {
+  const char *paths[READY_MAX_SOCKETS];
+  size_t n;
+
+  if (!(ev->mask & (IN_DELETE | IN_MOVED_FROM)) || ev->len == 0)
+    return false;
+  n = ready_sockets(paths);
+  for (size_t i = 0; i < n; i++)
+    if (strcmp(ev->name, base_name(paths[i])) == 0)
+      return true;
+  return false;
+}
+
+int vpp_ready_read(void) {
+  char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool gone = false;
+  bool now;
+  int bits = 0;
+  ssize_t len;
+
+  if (ready_fd < 0)
+    return 0;
+  while ((len = read(ready_fd, buf, sizeof(buf))) > 0) {
+    for (char *p = buf; p < buf + len;) {
+      const struct inotify_event *ev = (const struct inotify_event *)p;
+      gone |= ready_removed(ev);
+      p += sizeof(*ev) + ev->len;
+    }
+  }
+
+  ready_arm();
+  now = vpp_ready_sockets();
+  if (ready_up && (gone || !now))
+    bits |= VPP_READY_GONE;
+  if (now && (!ready_up || gone))
+    bits |= VPP_READY_UP;
+  ready_up = now;
+  return bits;
+}
@@ -0,0 +1,39 @@
+/*
+ * vpp_ready.h - Event-driven VPP readiness
+ *
+ * Watches the directories of VPP's sockets with inotify instead of
+ * polling for them. The watch descriptor goes into the caller's event
+ * loop; when it is readable, vpp_ready_read() says whether every socket
+ * has appeared (probe VPP once and apply the configuration) or one has
+ * vanished (VPP stopped or crashed). Missing parent directories such as
+ * /run/vpp are watched for too, so the watch survives VPP removing its
+ * runtime directory.
+ *
+ * Sockets: the CLI socket (VPP_CLI_SOCK) always, the API socket
+ * (VPP_API_SOCK, default /run/vpp/api.sock) in the VAPI build.
+ */
+
+#ifndef _VPP_READY_H_
+#define _VPP_READY_H_
+
+#include <stdbool.h>
+
+#define VPP_API_SOCKET "/run/vpp/api.sock" /* Override with VPP_API_SOCK */
+
+/* vpp_ready_read() result bits */
+#define VPP_READY_GONE 0x1 /* A socket vanished: VPP went away */
+#define VPP_READY_UP 0x2   /* Every socket is there (again) */
+
+/* Start watching; returns the inotify descriptor to poll, -1 on error
+ * Calling it again returns the same descriptor */
+int vpp_ready_open(void);
+void vpp_ready_close(void);
+
+/* Every socket exists right now */
+bool vpp_ready_sockets(void);
+
+/* Drain pending events; returns VPP_READY_* bits, 0 if nothing changed.
+ * A restart seen in one batch reports GONE | UP: handle GONE first. */
+int vpp_ready_read(void);
+
+#endif /* _VPP_READY_H_ */
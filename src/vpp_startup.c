@@ -0,0 +1,151 @@
+/*
+ * vpp_startup.c - VPP startup exec script from the running configuration
+ *
+ * The script is rendered in memory first and compared with the file on
+ * disk: most commits do not change it, and an unchanged script costs a
+ * read instead of a write and two fsyncs. A new script goes to a
+ * temporary file in the same directory and is renamed over the old one,
+ * so VPP never boots from a half-written file.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vpp_plan.h"
+#include "vpp_startup.h"
+
+#define VPP_STARTUP_HEADER                                                     \
+  "# Generated by the clixon-vpp backend on every commit; do not edit.\n"      \
+  "# Load with: unix { startup-config <this file> }\n"
+
+/* Render the script; *buf is malloc'ed */
+static int startup_render(const vpp_op_queue_t *q, char **buf, size_t *len) {
+  vpp_plan_t plan = {0};
+  bool planned = vpp_plan_build(&plan, q) == 0;
+  char cmd[512];
+  FILE *fp;
+  int rv = 0;
+
+  if (!(fp = open_memstream(buf, len))) {
+    vpp_plan_free(&plan);
+    return -1;
+  }
+  fputs(VPP_STARTUP_HEADER, fp);
+  /* Without a plan the queue order is the one it was built in */
+  for (size_t i = 0; i < q->len; i++) {
+    const vpp_op_t *op = &q->ops[planned ? plan.order[i] : i];
+    if (vpp_op_format(op, cmd, sizeof(cmd)) < 0) {
+      errno = EINVAL;
+      rv = -1;
+      break;
+    }
+    fprintf(fp, "%s\n", cmd);
+  }
+  if (fclose(fp) != 0)
+    rv = -1;
+  vpp_plan_free(&plan);
+  if (rv < 0) {
+    free(*buf);
+    *buf = NULL;
+  }
+  return rv;
+}
+
+/* path already holds exactly buf[0, len) */
+static bool startup_unchanged(const char *path, const char *buf, size_t len) {
+  char chunk[4096];
+  size_t off = 0;
+  size_t n;
+  FILE *fp;
+  bool same = true;
+
+  if (!(fp = fopen(path, "r")))
+    return false;
+  while (same && (n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+    same = off + n <= len && memcmp(chunk, buf + off, n) == 0;
+    off += n;
+  }
+  fclose(fp);
+  return same && off == len;
+}
+
+static int write_all(int fd, const char *buf, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, buf, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    buf += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+/* Make the rename itself durable */
+static void sync_dir(const char *path) {
+  char *copy = strdup(path);
+  int fd;
+
+  if (!copy)
+    return;
+  if ((fd = open(dirname(copy), O_RDONLY | O_DIRECTORY)) >= 0) {
+    fsync(fd);
+    close(fd);
+  }
+  free(copy);
+}
+
+int vpp_startup_write(const char *path, const vpp_op_queue_t *q) {
+  size_t tmplen = strlen(path) + sizeof(".XXXXXX");
+  char *buf = NULL;
+  size_t len = 0;
+  char *tmp;
+  int fd = -1;
+  int saved;
+  int rv = -1;
+
+  if (startup_render(q, &buf, &len) < 0)
+    return -1;
+  if (startup_unchanged(path, buf, len)) {
+    free(buf);
+    return 0;
+  }
+
+  if (!(tmp = malloc(tmplen))) {
+    free(buf);
+    return -1;
+  }
+  snprintf(tmp, tmplen, "%s.XXXXXX", path);
+  if ((fd = mkstemp(tmp)) < 0) {
+    saved = errno;
+    free(tmp);
+    free(buf);
+    errno = saved;
+    return -1;
+  }
+  if (fchmod(fd, 0644) == 0 && write_all(fd, buf, len) == 0 &&
+      fsync(fd) == 0) {
+    rv = close(fd);
+    fd = -1;
+    if (rv == 0 && (rv = rename(tmp, path)) == 0)
+      sync_dir(path);
+  }
+
+  saved = errno;
+  if (fd >= 0)
+    close(fd);
+  if (rv != 0)
+    unlink(tmp);
+  free(tmp);
+  free(buf);
+  errno = saved;
+  return rv == 0 ? 1 : -1;
+}
@@ -0,0 +1,26 @@
+/*
+ * vpp_startup.h - VPP startup exec script from the saved configuration
+ *
+ * After every commit the backend renders the committed interfaces, with
+ * the bonds and LCP pairs of vpp_config.xml, as VPP CLI commands: bonds
+ * and members, sub-interfaces, MTUs, admin state, addresses and LCP
+ * pairs, in the planner's dependency order.
+ * VPP runs the file itself at boot when startup.conf points at it:
+ *
+ *   unix { startup-config /var/lib/clixon/vpp/vpp_startup.exec }
+ *
+ * so the dataplane comes up configured without waiting for the backend.
+ */
+
+#ifndef _VPP_STARTUP_H_
+#define _VPP_STARTUP_H_
+
+#include "vpp_op.h"
+
+/* Write the ops of q to path as an exec script, in plan order
+ * The file is replaced atomically (temporary file, fsync, rename) and
+ * left alone if its content would not change.
+ * Returns 1 if written, 0 if unchanged, -1 on error with errno set */
+int vpp_startup_write(const char *path, const vpp_op_queue_t *q);
+
+#endif /* _VPP_STARTUP_H_ */
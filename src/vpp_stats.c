@@ -0,0 +1,121 @@
+/*
+ * vpp_stats.c - Commit latency instrumentation
+ */
+
+#include <string.h>
+
+#include "vpp_stats.h"
+
+static const char *phase_names[VPP_STATS_PHASES] = {
+    [VPP_STATS_BEGIN] = "begin",
+    [VPP_STATS_VALIDATE] = "validate",
+    [VPP_STATS_COMMIT] = "commit",
+    [VPP_STATS_OP_CREATE] = "create",
+    [VPP_STATS_OP_STATE] = "state",
+    [VPP_STATS_OP_MTU] = "mtu",
+    [VPP_STATS_OP_ADDRESS] = "address",
+    [VPP_STATS_OP_BOND] = "bond",
+    [VPP_STATS_OP_LCP] = "lcp",
+    [VPP_STATS_OP_DESCRIPTION] = "description",
+};
+
+static vpp_stats_hist_t hist[VPP_STATS_PHASES];
+static vpp_stats_commit_t recent[VPP_STATS_RECENT];
+static size_t recent_count = 0; /* Total commits recorded */
+static vpp_stats_commit_t open_rec;
+
+uint64_t vpp_stats_now_usec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+uint64_t vpp_stats_bucket_le(unsigned bucket) {
+  if (bucket >= VPP_STATS_BUCKETS - 1)
+    return UINT64_MAX;
+  return (uint64_t)16 << bucket;
+}
+
+static unsigned stats_bucket(uint64_t usec) {
+  unsigned b = 0;
+
+  while (b < VPP_STATS_BUCKETS - 1 && usec > vpp_stats_bucket_le(b))
+    b++;
+  return b;
+}
+
+static vpp_stats_phase_t stats_op_class(vpp_op_type_t type) {
+  switch (type) {
+  case VPP_OP_CREATE_BOND:
+  case VPP_OP_DELETE_BOND:
+  case VPP_OP_CREATE_SUBIF:
+  case VPP_OP_DELETE_SUBIF:
+    return VPP_STATS_OP_CREATE;
+  case VPP_OP_SET_STATE:
+    return VPP_STATS_OP_STATE;
+  case VPP_OP_SET_MTU:
+    return VPP_STATS_OP_MTU;
+  case VPP_OP_ADD_ADDR:
+  case VPP_OP_DEL_ADDR:
+    return VPP_STATS_OP_ADDRESS;
+  case VPP_OP_BOND_ADD_MEMBER:
+  case VPP_OP_BOND_DEL_MEMBER:
+    return VPP_STATS_OP_BOND;
+  case VPP_OP_CREATE_LCP:
+  case VPP_OP_DELETE_LCP:
+    return VPP_STATS_OP_LCP;
+  case VPP_OP_SET_DESCRIPTION:
+  default:
+    return VPP_STATS_OP_DESCRIPTION;
+  }
+}
+
+void vpp_stats_begin(uint64_t id) {
+  memset(&open_rec, 0, sizeof(open_rec));
+  open_rec.id = id;
+}
+
+void vpp_stats_phase(vpp_stats_phase_t phase, uint64_t usec) {
+  vpp_stats_hist_t *h = &hist[phase];
+
+  if (h->count == 0 || usec < h->min_usec)
+    h->min_usec = usec;
+  if (usec > h->max_usec)
+    h->max_usec = usec;
+  h->count++;
+  h->total_usec += usec;
+  h->bucket[stats_bucket(usec)]++;
+
+  open_rec.usec[phase] += usec;
+  open_rec.count[phase]++;
+}
+
+void vpp_stats_ops(const vpp_op_t *ops, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (ops[i].rv == VPP_OP_NOT_SENT)
+      continue;
+    vpp_stats_phase(stats_op_class(ops[i].type), ops[i].usec);
+    open_rec.nops++;
+  }
+}
+
+void vpp_stats_commit_done(bool ok) {
+  open_rec.ok = ok;
+  open_rec.when = time(NULL);
+  recent[recent_count++ % VPP_STATS_RECENT] = open_rec;
+  memset(&open_rec, 0, sizeof(open_rec));
+}
+
+const char *vpp_stats_phase_str(vpp_stats_phase_t phase) {
+  return (unsigned)phase < VPP_STATS_PHASES ? phase_names[phase] : "unknown";
+}
+
+const vpp_stats_hist_t *vpp_stats_hist(vpp_stats_phase_t phase) {
+  return (unsigned)phase < VPP_STATS_PHASES ? &hist[phase] : NULL;
+}
+
+const vpp_stats_commit_t *vpp_stats_recent(size_t i) {
+  if (i >= recent_count || i >= VPP_STATS_RECENT)
+    return NULL;
+  return &recent[(recent_count - 1 - i) % VPP_STATS_RECENT];
+}
@@ -0,0 +1,85 @@
+/*
+ * vpp_stats.h - Commit latency instrumentation
+ *
+ * The backend plugin times the transaction phases (begin, validate,
+ * commit) and every VPP request by operation class with a monotonic
+ * clock. Each phase keeps a log2 histogram of its samples, and the
+ * breakdown of the last VPP_STATS_RECENT commits is kept in a ring.
+ * Both are exposed as /commit-statistics operational state.
+ *
+ * Transactions run one at a time on the backend's main thread, so the
+ * open record needs no locking.
+ */
+
+#ifndef _VPP_STATS_H_
+#define _VPP_STATS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "vpp_op.h"
+
+typedef enum {
+  VPP_STATS_BEGIN,
+  VPP_STATS_VALIDATE,
+  VPP_STATS_COMMIT,
+  /* VPP requests by operation class */
+  VPP_STATS_OP_CREATE,      /* Bond/sub-interface create and delete */
+  VPP_STATS_OP_STATE,
+  VPP_STATS_OP_MTU,
+  VPP_STATS_OP_ADDRESS,
+  VPP_STATS_OP_BOND,        /* Member add/remove */
+  VPP_STATS_OP_LCP,
+  VPP_STATS_OP_DESCRIPTION,
+  VPP_STATS_PHASES
+} vpp_stats_phase_t;
+
+/* Bucket b counts samples up to 2^(b + 4) usec (16 us .. 16.8 s); the
+ * last bucket takes everything slower */
+#define VPP_STATS_BUCKETS 22
+#define VPP_STATS_RECENT 16
+
+typedef struct {
+  uint64_t count;
+  uint64_t total_usec;
+  uint64_t min_usec;
+  uint64_t max_usec;
+  uint64_t bucket[VPP_STATS_BUCKETS];
+} vpp_stats_hist_t;
+
+/* Breakdown of one commit */
+typedef struct {
+  uint64_t id;       /* Clixon transaction id */
+  time_t when;       /* Wall clock time the commit finished */
+  bool ok;
+  uint32_t nops;     /* VPP requests sent */
+  uint64_t usec[VPP_STATS_PHASES];
+  uint32_t count[VPP_STATS_PHASES];
+} vpp_stats_commit_t;
+
+uint64_t vpp_stats_now_usec(void);
+
+/* Open the record of a new transaction */
+void vpp_stats_begin(uint64_t id);
+
+/* Add a sample to the phase histogram and the open record */
+void vpp_stats_phase(vpp_stats_phase_t phase, uint64_t usec);
+
+/* Add one sample per sent op to its class */
+void vpp_stats_ops(const vpp_op_t *ops, size_t n);
+
+/* Close the open record into the recent ring */
+void vpp_stats_commit_done(bool ok);
+
+const char *vpp_stats_phase_str(vpp_stats_phase_t phase);
+const vpp_stats_hist_t *vpp_stats_hist(vpp_stats_phase_t phase);
+
+/* Upper bound of a histogram bucket in usec, UINT64_MAX for the last */
+uint64_t vpp_stats_bucket_le(unsigned bucket);
+
+/* i-th most recent commit (0 = newest), NULL past the end */
+const vpp_stats_commit_t *vpp_stats_recent(size_t i);
+
+#endif /* _VPP_STATS_H_ */
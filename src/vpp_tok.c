@@ -0,0 +1,316 @@
+/*
+ * vpp_tok.c - Zero-copy line/column tokenizer for VPP "show" output
+ *
+ * Line breaks and column boundaries are found by a scanner picked once
+ * per process: AVX2 (32 bytes per step) or SSE2 (16) where the CPU has
+ * them, else a byte loop. Vector loads never pass the end of the
+ * buffer; the last partial block is scanned byte by byte.
+ */
+
+#define _GNU_SOURCE /* memmem */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TOK_X86 1
+#endif
+
+#include "vpp_tok.h"
+
+static inline bool is_blank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* Each returns the first matching byte in [p, end), or end */
+typedef struct {
+  const char *name;
+  const char *(*find_nl)(const char *p, const char *end);
+  const char *(*skip_blank)(const char *p, const char *end);
+  const char *(*find_blank)(const char *p, const char *end);
+} tok_scan_t;
+
+static const char *find_nl_scalar(const char *p, const char *end) {
+  const char *nl = memchr(p, '\n', (size_t)(end - p));
+  return nl ? nl : end;
+}
+
+static const char *skip_blank_scalar(const char *p, const char *end) {
+  while (p < end && is_blank(*p))
+    p++;
+  return p;
+}
+
+static const char *find_blank_scalar(const char *p, const char *end) {
+  while (p < end && !is_blank(*p))
+    p++;
+  return p;
+}
+
+#ifdef TOK_X86
+
+__attribute__((target("sse2"))) static inline uint32_t
+blank_mask_sse2(const char *p) {
+  __m128i v = _mm_loadu_si128((const __m128i *)p);
+  __m128i m = _mm_or_si128(
+      _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')),
+                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+  return (uint32_t)_mm_movemask_epi8(m);
+}
+
+__attribute__((target("sse2"))) static const char *
+find_nl_sse2(const char *p, const char *end) {
+  const __m128i nl = _mm_set1_epi8('\n');
+
+  for (; end - p >= 16; p += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)p);
+    uint32_t m = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+    if (m)
+      return p + __builtin_ctz(m);
+  }
+  while (p < end && *p != '\n')
+    p++;
+  return p;
+}
+
+__attribute__((target("sse2"))) static const char *
+skip_blank_sse2(const char *p, const char *end) {
+  for (; end - p >= 16; p += 16) {
+    uint32_t m = blank_mask_sse2(p) ^ 0xffffu;
+    if (m)
+      return p + __builtin_ctz(m);
+  }
+  return skip_blank_scalar(p, end);
+}
+
+__attribute__((target("sse2"))) static const char *
+find_blank_sse2(const char *p, const char *end) {
+  for (; end - p >= 16; p += 16) {
+    uint32_t m = blank_mask_sse2(p);
+    if (m)
+      return p + __builtin_ctz(m);
+  }
+  return find_blank_scalar(p, end);
+}
+
+__attribute__((target("avx2"))) static inline uint32_t
+blank_mask_avx2(const char *p) {
+  __m256i v = _mm256_loadu_si256((const __m256i *)p);
+  __m256i m = _mm256_or_si256(
+      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+  return (uint32_t)_mm256_movemask_epi8(m);
+}
+
+__attribute__((target("avx2"))) static const char *
+find_nl_avx2(const char *p, const char *end) {
+  const __m256i nl = _mm256_set1_epi8('\n');
+
+  for (; end - p >= 32; p += 32) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)p);
+    uint32_t m = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl));
+    if (m)
+      return p + __builtin_ctz(m);
+  }
+  return find_nl_sse2(p, end);
+}
+
+__attribute__((target("avx2"))) static const char *
+skip_blank_avx2(const char *p, const char *end) {
+  for (; end - p >= 32; p += 32) {
+    uint32_t m = ~blank_mask_avx2(p);
+    if (m)
+      return p + __builtin_ctz(m);
+  }
+  return skip_blank_sse2(p, end);
+}
+
+__attribute__((target("avx2"))) static const char *
+find_blank_avx2(const char *p, const char *end) {
+  for (; end - p >= 32; p += 32) {
+    uint32_t m = blank_mask_avx2(p);
+    if (m)
+      return p + __builtin_ctz(m);
+  }
+  return find_blank_sse2(p, end);
+}
+
+#endif /* TOK_X86 */
+
+/* Best first */
+static const tok_scan_t scanners[] = {
+#ifdef TOK_X86
+    {"avx2", find_nl_avx2, skip_blank_avx2, find_blank_avx2},
+    {"sse2", find_nl_sse2, skip_blank_sse2, find_blank_sse2},
+#endif
+    {"scalar", find_nl_scalar, skip_blank_scalar, find_blank_scalar},
+};
+
+#define NSCANNERS (sizeof(scanners) / sizeof(scanners[0]))
+
+static const tok_scan_t *scan = NULL;
+
+static bool scanner_supported(const tok_scan_t *s) {
+#ifdef TOK_X86
+  __builtin_cpu_init();
+  if (strcmp(s->name, "avx2") == 0)
+    return __builtin_cpu_supports("avx2");
+  if (strcmp(s->name, "sse2") == 0)
+    return __builtin_cpu_supports("sse2");
+#endif
+  return strcmp(s->name, "scalar") == 0;
+}
+
+int vpp_tok_select(const char *isa) {
+  const char *env = getenv("VPP_TOK_ISA");
+
+  if (!isa && env && *env && vpp_tok_select(env) == 0)
+    return 0;
+  for (size_t i = 0; i < NSCANNERS; i++) {
+    if ((!isa || strcmp(isa, scanners[i].name) == 0) &&
+        scanner_supported(&scanners[i])) {
+      scan = &scanners[i];
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static inline const tok_scan_t *scanner(void) {
+  if (!scan)
+    vpp_tok_select(NULL);
+  return scan;
+}
+
+const char *vpp_tok_isa(void) { return scanner()->name; }
+
+void vpp_tok_init(vpp_tok_t *tok, const char *buf, size_t len) {
+  tok->pos = buf;
+  tok->end = buf ? buf + len : NULL;
+}
+
+void vpp_tok_init_str(vpp_tok_t *tok, const char *str) {
+  vpp_tok_init(tok, str, str ? strlen(str) : 0);
+}
+
+bool vpp_tok_line(vpp_tok_t *tok, vpp_slice_t *line) {
+  const char *nl;
+  size_t len;
+
+  if (!tok->pos || tok->pos >= tok->end)
+    return false;
+  nl = scanner()->find_nl(tok->pos, tok->end);
+  len = (size_t)(nl - tok->pos);
+
+  line->ptr = tok->pos;
+  line->len = len > 0 && tok->pos[len - 1] == '\r' ? len - 1 : len;
+  tok->pos = nl < tok->end ? nl + 1 : tok->end;
+  return true;
+}
+
+bool vpp_tok_field(vpp_slice_t *rest, vpp_slice_t *field) {
+  const tok_scan_t *sc = scanner();
+  const char *end = rest->ptr + rest->len;
+  const char *start = sc->skip_blank(rest->ptr, end);
+  const char *p = sc->find_blank(start, end);
+
+  rest->ptr = p;
+  rest->len = (size_t)(end - p);
+  field->ptr = start;
+  field->len = (size_t)(p - start);
+  return field->len > 0;
+}
+
+size_t vpp_tok_indent(vpp_slice_t s) {
+  size_t n = 0;
+
+  while (n < s.len && (s.ptr[n] == ' ' || s.ptr[n] == '\t'))
+    n++;
+  return n;
+}
+
+vpp_slice_t vpp_tok_trim(vpp_slice_t s) {
+  const char *p = scanner()->skip_blank(s.ptr, s.ptr + s.len);
+
+  s.len -= (size_t)(p - s.ptr);
+  s.ptr = p;
+  while (s.len > 0 && is_blank(s.ptr[s.len - 1]))
+    s.len--;
+  return s;
+}
+
+bool vpp_tok_u64(vpp_slice_t *s, uint64_t *val) {
+  uint64_t v = 0;
+  size_t n = 0;
+
+  while (n < s->len && s->ptr[n] >= '0' && s->ptr[n] <= '9')
+    v = v * 10 + (uint64_t)(s->ptr[n++] - '0');
+  if (n == 0)
+    return false;
+  s->ptr += n;
+  s->len -= n;
+  *val = v;
+  return true;
+}
+
+bool vpp_tok_u32(vpp_slice_t s, uint32_t *val) {
+  uint64_t v;
+
+  if (s.len == 0 || s.len > 10 || !vpp_tok_u64(&s, &v) || s.len != 0 ||
+      v > UINT32_MAX)
+    return false;
+  *val = (uint32_t)v;
+  return true;
+}
+
+bool vpp_tok_split(vpp_slice_t s, char sep, vpp_slice_t *head,
+                   vpp_slice_t *tail) {
+  const char *p = memchr(s.ptr, sep, s.len);
+
+  if (!p)
+    return false;
+  head->ptr = s.ptr;
+  head->len = (size_t)(p - s.ptr);
+  tail->ptr = p + 1;
+  tail->len = s.len - head->len - 1;
+  return true;
+}
+
+const char *vpp_tok_find(vpp_slice_t s, const char *lit) {
+  return memmem(s.ptr, s.len, lit, strlen(lit));
+}
+
+size_t vpp_tok_copy(vpp_slice_t s, char *buf, size_t size) {
+  size_t n = s.len;
+
+  if (size == 0)
+    return 0;
+  if (n >= size)
+    n = size - 1;
+  memcpy(buf, s.ptr, n);
+  buf[n] = '\0';
+  return n;
+}
+
+bool vpp_tok_show_interface_row(vpp_slice_t line, vpp_tok_ifrow_t *row) {
+  vpp_slice_t idx;
+  vpp_slice_t mtu;
+  uint64_t v;
+
+  if (line.len == 0 || is_blank(line.ptr[0]) ||
+      !vpp_tok_field(&line, &row->name) || !vpp_tok_field(&line, &idx) ||
+      !vpp_tok_u32(idx, &row->sw_if_index))
+    return false;
+
+  /* State, then "9000/0/0/0" with the L3 MTU first */
+  row->mtu = 0;
+  if (vpp_tok_field(&line, &row->state) && vpp_tok_field(&line, &mtu) &&
+      vpp_tok_u64(&mtu, &v) && v <= UINT32_MAX)
+    row->mtu = (uint32_t)v;
+  return true;
+}
@@ -0,0 +1,112 @@
+/*
+ * vpp_tok.h - Zero-copy line/column tokenizer for VPP "show" output
+ *
+ * Every parser of CLI output walks the same shapes: lines ended by "\n"
+ * or "\r\n", indentation, blank-separated columns. The tokenizer hands
+ * out slices into the response buffer instead of copying or modifying
+ * it, and keeps its position in a caller-owned cursor, so it is
+ * reentrant and one output can be walked by several cursors at once.
+ * Lines and columns are found with SSE2/AVX2 where the CPU has them.
+ */
+
+#ifndef _VPP_TOK_H_
+#define _VPP_TOK_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Bytes [ptr, ptr + len) of a buffer, not NUL-terminated */
+typedef struct {
+  const char *ptr;
+  size_t len;
+} vpp_slice_t;
+
+/* Line cursor over a buffer */
+typedef struct {
+  const char *pos;
+  const char *end;
+} vpp_tok_t;
+
+/* Scanner in use: "avx2", "sse2" or "scalar", the best the CPU runs
+ * unless VPP_TOK_ISA names another */
+const char *vpp_tok_isa(void);
+
+/* Use the named scanner, NULL for the default; -1 if the CPU lacks it */
+int vpp_tok_select(const char *isa);
+
+/* Walk buf[0, len) line by line; vpp_tok_init_str() up to the NUL */
+void vpp_tok_init(vpp_tok_t *tok, const char *buf, size_t len);
+void vpp_tok_init_str(vpp_tok_t *tok, const char *str);
+
+/* Next line without its "\n" or "\r\n"; false at the end of the buffer */
+bool vpp_tok_line(vpp_tok_t *tok, vpp_slice_t *line);
+
+/* Next blank-separated column of *rest, consumed from it */
+bool vpp_tok_field(vpp_slice_t *rest, vpp_slice_t *field);
+
+/* Leading spaces and tabs of a line */
+size_t vpp_tok_indent(vpp_slice_t s);
+
+/* s without leading and trailing blanks */
+vpp_slice_t vpp_tok_trim(vpp_slice_t s);
+
+/* Leading decimal digits of *s, consumed; false if there are none */
+bool vpp_tok_u64(vpp_slice_t *s, uint64_t *val);
+
+/* s is exactly a decimal number that fits val */
+bool vpp_tok_u32(vpp_slice_t s, uint32_t *val);
+
+/* Split s at its first sep into head and tail; false if there is none */
+bool vpp_tok_split(vpp_slice_t s, char sep, vpp_slice_t *head,
+                   vpp_slice_t *tail);
+
+/* First occurrence of lit in s, NULL if none */
+const char *vpp_tok_find(vpp_slice_t s, const char *lit);
+
+/* Copy s into buf as a C string, truncated to size - 1; returns len */
+size_t vpp_tok_copy(vpp_slice_t s, char *buf, size_t size);
+
+static inline bool vpp_tok_eq(vpp_slice_t s, const char *lit) {
+  size_t n = strlen(lit);
+  return s.len == n && memcmp(s.ptr, lit, n) == 0;
+}
+
+static inline bool vpp_tok_prefix(vpp_slice_t s, const char *lit) {
+  size_t n = strlen(lit);
+  return s.len >= n && memcmp(s.ptr, lit, n) == 0;
+}
+
+/* Consume lit from the start of *s if it is there */
+static inline bool vpp_tok_skip(vpp_slice_t *s, const char *lit) {
+  size_t n = strlen(lit);
+
+  if (s->len < n || memcmp(s->ptr, lit, n) != 0)
+    return false;
+  s->ptr += n;
+  s->len -= n;
+  return true;
+}
+
+static inline bool vpp_tok_has(vpp_slice_t s, char c) {
+  return memchr(s.ptr, c, s.len) != NULL;
+}
+
+/*
+ * One interface row of "show interface":
+ *   Name  Idx  State  MTU (L3/IP4/IP6/MPLS)  Counter  Count
+ *   BondEthernet0.100  12  up  9000/0/0/0  rx packets  1234
+ * Counter continuation lines are indented and the title has no numeric
+ * Idx, so both return false. mtu is 0 when the column is missing.
+ */
+typedef struct {
+  vpp_slice_t name;
+  uint32_t sw_if_index;
+  vpp_slice_t state;
+  uint32_t mtu;
+} vpp_tok_ifrow_t;
+
+bool vpp_tok_show_interface_row(vpp_slice_t line, vpp_tok_ifrow_t *row);
+
+#endif /* _VPP_TOK_H_ */
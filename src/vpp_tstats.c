@@ -0,0 +1,234 @@
+/*
+ * vpp_tstats.c - Transport counters and latency per VPP command verb
+ *
+ * Verbs live in a fixed open-addressing table. A slot is claimed once
+ * with a compare-and-swap and never freed, so lookups need no lock and
+ * the counters are plain relaxed atomics.
+ */
+
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#include "vpp_tstats.h"
+
+#define SLOT_EMPTY 0
+#define SLOT_CLAIMED 1 /* Verb being written */
+#define SLOT_READY 2
+#define TSTATS_OTHER (VPP_TSTATS_VERBS - 1) /* Overflow slot */
+
+typedef struct {
+  _Atomic int state;
+  char verb[VPP_TSTATS_VERB_LEN];
+  _Atomic uint64_t calls;
+  _Atomic uint64_t errors;
+  _Atomic uint64_t bytes;
+  _Atomic uint64_t total_usec;
+  _Atomic uint64_t max_usec;
+  _Atomic uint64_t bucket[VPP_TSTATS_BUCKETS];
+} tstats_slot_t;
+
+static tstats_slot_t slots[VPP_TSTATS_VERBS];
+
+/* Multi-word verbs; anything else is counted under its first two words */
+static const char *known_verbs[] = {
+    "set interface ip address del",
+    "set interface ip address",
+    "set interface state",
+    "set interface mtu",
+    "set interface description",
+    "set interface mac address",
+    "show hardware-interfaces",
+    "show interface",
+    "show bond details",
+    "show bond",
+    "show lcp",
+    "show version",
+    "create bond",
+    "delete bond",
+    "bond add",
+    "bond del",
+    "create sub-interfaces",
+    "delete sub-interface",
+    "create loopback interface",
+    "delete loopback interface",
+    "lcp create",
+    "lcp delete",
+    "lcp default",
+    "exec",
+};
+
+uint64_t vpp_tstats_now_usec(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static unsigned tstats_bucket(uint64_t usec) {
+  unsigned msb;
+  unsigned b;
+
+  if (usec < 16)
+    return (unsigned)usec;
+  msb = 63 - (unsigned)__builtin_clzll(usec);
+  b = 16 + (msb - 4) * 4 + (unsigned)((usec >> (msb - 2)) & 3);
+  return b < VPP_TSTATS_BUCKETS ? b : VPP_TSTATS_BUCKETS - 1;
+}
+
+uint64_t vpp_tstats_bucket_le(unsigned bucket) {
+  unsigned msb;
+  unsigned sub;
+
+  if (bucket >= VPP_TSTATS_BUCKETS - 1)
+    return UINT64_MAX;
+  if (bucket < 16)
+    return bucket;
+  msb = 4 + (bucket - 16) / 4;
+  sub = (bucket - 16) % 4;
+  return ((uint64_t)(5 + sub) << (msb - 2)) - 1;
+}
+
+/* Length of the verb at the start of cmd */
+static size_t tstats_verb_len(const char *cmd) {
+  size_t best = 0;
+  size_t len;
+  int words = 0;
+
+  for (size_t i = 0; i < sizeof(known_verbs) / sizeof(known_verbs[0]); i++) {
+    len = strlen(known_verbs[i]);
+    if (len > best && strncmp(cmd, known_verbs[i], len) == 0 &&
+        (cmd[len] == '\0' || cmd[len] == ' '))
+      best = len;
+  }
+  if (best > 0)
+    return best;
+
+  for (len = 0; cmd[len] != '\0'; len++) {
+    if (cmd[len] == ' ' && ++words == 2)
+      break;
+  }
+  return len;
+}
+
+static uint32_t tstats_hash(const char *verb, size_t len) {
+  uint32_t h = 2166136261u; /* FNV-1a */
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)verb[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+static bool tstats_claim(tstats_slot_t *s, const char *verb, size_t len) {
+  int expected = SLOT_EMPTY;
+
+  if (!atomic_compare_exchange_strong(&s->state, &expected, SLOT_CLAIMED))
+    return false;
+  memcpy(s->verb, verb, len);
+  s->verb[len] = '\0';
+  atomic_store_explicit(&s->state, SLOT_READY, memory_order_release);
+  return true;
+}
+
+/* Slot of a verb, claimed on first use */
+static tstats_slot_t *tstats_slot(const char *verb, size_t len) {
+  uint32_t start;
+  tstats_slot_t *s;
+
+  if (len >= VPP_TSTATS_VERB_LEN)
+    len = VPP_TSTATS_VERB_LEN - 1;
+  start = tstats_hash(verb, len) % TSTATS_OTHER;
+  for (uint32_t i = 0; i < TSTATS_OTHER; i++) {
+    s = &slots[(start + i) % TSTATS_OTHER];
+    for (;;) {
+      int state = atomic_load_explicit(&s->state, memory_order_acquire);
+      if (state == SLOT_READY)
+        break;
+      if (state == SLOT_EMPTY && tstats_claim(s, verb, len))
+        return s;
+      /* Another thread is writing this slot's verb */
+    }
+    if (strncmp(s->verb, verb, len) == 0 && s->verb[len] == '\0')
+      return s;
+  }
+
+  s = &slots[TSTATS_OTHER];
+  if (atomic_load_explicit(&s->state, memory_order_acquire) != SLOT_READY)
+    tstats_claim(s, "other", 5);
+  return s;
+}
+
+void vpp_tstats_record(const char *verb, uint64_t usec, size_t bytes,
+                       bool error) {
+  tstats_slot_t *s = tstats_slot(verb, strlen(verb));
+  uint64_t max;
+
+  atomic_fetch_add_explicit(&s->calls, 1, memory_order_relaxed);
+  if (error)
+    atomic_fetch_add_explicit(&s->errors, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&s->bytes, bytes, memory_order_relaxed);
+  atomic_fetch_add_explicit(&s->total_usec, usec, memory_order_relaxed);
+  atomic_fetch_add_explicit(&s->bucket[tstats_bucket(usec)], 1,
+                            memory_order_relaxed);
+  max = atomic_load_explicit(&s->max_usec, memory_order_relaxed);
+  while (usec > max && !atomic_compare_exchange_weak_explicit(
+                           &s->max_usec, &max, usec, memory_order_relaxed,
+                           memory_order_relaxed))
+    ;
+}
+
+void vpp_tstats_record_cli(const char *cmd, uint64_t usec, size_t bytes,
+                           bool error) {
+  char verb[VPP_TSTATS_VERB_LEN];
+  size_t len = tstats_verb_len(cmd);
+
+  if (len >= sizeof(verb))
+    len = sizeof(verb) - 1;
+  memcpy(verb, cmd, len);
+  verb[len] = '\0';
+  vpp_tstats_record(verb, usec, bytes, error);
+}
+
+size_t vpp_tstats_read(vpp_tstats_verb_t *out, size_t max) {
+  size_t n = 0;
+
+  for (size_t i = 0; i < VPP_TSTATS_VERBS && n < max; i++) {
+    tstats_slot_t *s = &slots[i];
+    vpp_tstats_verb_t *v = &out[n];
+
+    if (atomic_load_explicit(&s->state, memory_order_acquire) != SLOT_READY)
+      continue;
+    memcpy(v->verb, s->verb, sizeof(v->verb));
+    v->calls = atomic_load_explicit(&s->calls, memory_order_relaxed);
+    v->errors = atomic_load_explicit(&s->errors, memory_order_relaxed);
+    v->bytes = atomic_load_explicit(&s->bytes, memory_order_relaxed);
+    v->total_usec = atomic_load_explicit(&s->total_usec, memory_order_relaxed);
+    v->max_usec = atomic_load_explicit(&s->max_usec, memory_order_relaxed);
+    for (unsigned b = 0; b < VPP_TSTATS_BUCKETS; b++)
+      v->bucket[b] = atomic_load_explicit(&s->bucket[b], memory_order_relaxed);
+    n++;
+  }
+  return n;
+}
+
+uint64_t vpp_tstats_percentile(const vpp_tstats_verb_t *v, double q) {
+  uint64_t total = 0;
+  uint64_t seen = 0;
+  uint64_t rank;
+
+  for (unsigned b = 0; b < VPP_TSTATS_BUCKETS; b++)
+    total += v->bucket[b];
+  if (total == 0)
+    return 0;
+  rank = (uint64_t)(q * (double)total + 0.5);
+  if (rank == 0)
+    rank = 1;
+  for (unsigned b = 0; b < VPP_TSTATS_BUCKETS; b++) {
+    seen += v->bucket[b];
+    if (seen >= rank)
+      /* Bucket bound, but never above what was actually seen */
+      return vpp_tstats_bucket_le(b) < v->max_usec ? vpp_tstats_bucket_le(b)
+                                                   : v->max_usec;
+  }
+  return v->max_usec;
+}
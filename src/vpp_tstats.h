@@ -0,0 +1,55 @@
+/*
+ * vpp_tstats.h - Transport counters and latency per VPP command verb
+ *
+ * Every command sent over the CLI socket, and every request of the VAPI
+ * op transport, is counted under its verb ("set interface mtu",
+ * "lcp create", "api set-mtu", ...): calls, errors, bytes read and a
+ * log-linear latency histogram. Recording is lock-free, so pipelined
+ * sessions on several threads can record at the same time.
+ *
+ * The histogram is exact below 16 us; above, each power of two is split
+ * into four linear steps, which keeps percentiles within 25%.
+ */
+
+#ifndef _VPP_TSTATS_H_
+#define _VPP_TSTATS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define VPP_TSTATS_VERBS 128    /* Distinct verbs; more count as "other" */
+#define VPP_TSTATS_VERB_LEN 48
+#define VPP_TSTATS_BUCKETS 112  /* Up to ~134 s, the last one is open */
+
+/* Counters of one verb, as read by vpp_tstats_read() */
+typedef struct {
+  char verb[VPP_TSTATS_VERB_LEN];
+  uint64_t calls;
+  uint64_t errors;
+  uint64_t bytes;      /* Reply bytes read */
+  uint64_t total_usec;
+  uint64_t max_usec;
+  uint64_t bucket[VPP_TSTATS_BUCKETS];
+} vpp_tstats_verb_t;
+
+uint64_t vpp_tstats_now_usec(void);
+
+/* Record one command; the verb is derived from the CLI text */
+void vpp_tstats_record_cli(const char *cmd, uint64_t usec, size_t bytes,
+                           bool error);
+
+/* Record one request under an explicit verb */
+void vpp_tstats_record(const char *verb, uint64_t usec, size_t bytes,
+                       bool error);
+
+/* Copy out up to max verbs; returns the number copied */
+size_t vpp_tstats_read(vpp_tstats_verb_t *out, size_t max);
+
+/* Upper bound of a bucket in usec, UINT64_MAX for the last */
+uint64_t vpp_tstats_bucket_le(unsigned bucket);
+
+/* Latency below which a fraction q (0..1) of the calls fell */
+uint64_t vpp_tstats_percentile(const vpp_tstats_verb_t *v, double q);
+
+#endif /* _VPP_TSTATS_H_ */
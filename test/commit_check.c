@@ -0,0 +1,697 @@
+/*
+ * commit_check.c - Commit checks against test/vpp_mock
+ *
+ * Links the backend plugin objects and moves a mock VPP between two
+ * configurations through the transaction callbacks, the way the backend
+ * does, then checks what the mock holds. The diff handed to the plugin
+ * is built leaf by leaf below each interface: leaves only in the old
+ * configuration are deleted, only in the new one added, in both with a
+ * different value changed.
+ *
+ * Usage: commit_check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include <cligen/cligen.h>
+#include <clixon/clixon.h>
+#include <clixon/clixon_backend.h>
+
+#include "../src/vpp_api.h"
+#include "../src/vpp_connection.h"
+#include "../src/vpp_interface.h"
+#include "../bench/bench_util.h"
+
+#define CHECK_SCALE 16 /* Five ports, BondEthernet0 with four VLANs */
+#define CHECK_LEAVES 64
+
+clixon_plugin_api *clixon_plugin_init(clixon_handle h);
+
+typedef struct {
+  clixon_handle h;
+  clixon_plugin_api *api;
+  transaction_data_t *td;
+  const char *script;      /* Startup exec script the plugin writes */
+  const char *config;      /* vpp_config.xml the plugin restores */
+  const char *log;         /* Every command the mock runs */
+  const char *sock;
+  pid_t mock;
+  cxobj *xml;              /* Configuration the mock is at */
+  cxobj *dvec[CHECK_LEAVES];
+  cxobj *avec[CHECK_LEAVES];
+  cxobj *scvec[CHECK_LEAVES];
+  cxobj *tcvec[CHECK_LEAVES];
+  int dlen;
+  int alen;
+  int clen;
+} check_ctx_t;
+
+static int failures;
+static cxobj *running; /* What xmldb_get() returns, NULL for empty */
+
+/* The backend's running datastore: CLICON_STARTUP_MODE init leaves it
+ * empty after a restart, which is what the checks see unless one sets
+ * running */
+int xmldb_get(clixon_handle h, const char *db, cvec *nsc, const char *xpath,
+              cxobj **xret) {
+  (void)h, (void)db, (void)nsc, (void)xpath;
+  *xret = running ? xml_dup(running) : xml_new("config", NULL, CX_ELMNT);
+  return *xret ? 0 : -1;
+}
+
+static cxobj *check_interface(cxobj *xt, const char *name) {
+  cxobj *xif = NULL;
+
+  while ((xif = xml_child_each(xpath_first(xt, NULL, "interfaces"), xif,
+                               CX_ELMNT)) != NULL)
+    if (strcmp(xml_find_body(xif, "name"), name) == 0)
+      return xif;
+  return NULL;
+}
+
+/* Leaves of every interface of xa that xb lacks (or has with another value) */
+static void check_diff(check_ctx_t *c, cxobj *xa, cxobj *xb, bool added) {
+  cxobj *xif = NULL;
+
+  while ((xif = xml_child_each(xpath_first(xa, NULL, "interfaces"), xif,
+                               CX_ELMNT)) != NULL) {
+    cxobj *xother = check_interface(xb, xml_find_body(xif, "name"));
+    cxobj *xl = NULL;
+
+    while ((xl = xml_child_each(xif, xl, CX_ELMNT)) != NULL) {
+      cxobj *xo = xother ? xml_find_type(xother, NULL, xml_name(xl), CX_ELMNT)
+                         : NULL;
+
+      if (strcmp(xml_name(xl), "name") == 0)
+        continue;
+      if (xo == NULL && added && c->alen < CHECK_LEAVES)
+        c->avec[c->alen++] = xl;
+      else if (xo == NULL && !added && c->dlen < CHECK_LEAVES)
+        c->dvec[c->dlen++] = xl;
+      else if (xo != NULL && !added && c->clen < CHECK_LEAVES &&
+               strcmp(xml_body(xl), xml_body(xo)) != 0) {
+        c->scvec[c->clen] = xl;
+        c->tcvec[c->clen++] = xo;
+      }
+    }
+  }
+}
+
+/* One full transaction from the current configuration to xml, which
+ * becomes the current one if it commits; revert plays a plugin after
+ * this one failing its commit */
+static int check_apply(check_ctx_t *c, const char *xml, bool revert) {
+  transaction_data_t *td = c->td;
+  cxobj *xt = NULL;
+  int rv;
+
+  if (clixon_xml_parse_string(xml, YB_NONE, NULL, &xt, NULL) < 0)
+    return -1;
+  c->dlen = c->alen = c->clen = 0;
+  check_diff(c, c->xml, xt, false);
+  check_diff(c, xt, c->xml, true);
+
+  td->td_id++;
+  td->td_src = c->xml;
+  td->td_target = xt;
+  td->td_dvec = c->dvec;
+  td->td_dlen = c->dlen;
+  td->td_avec = c->avec;
+  td->td_alen = c->alen;
+  td->td_scvec = c->scvec;
+  td->td_tcvec = c->tcvec;
+  td->td_clen = c->clen;
+  td->td_arg = NULL;
+
+  rv = c->api->ca_trans_begin(c->h, td);
+  if (rv >= 0)
+    rv = c->api->ca_trans_validate(c->h, td);
+  if (rv >= 0)
+    rv = c->api->ca_trans_commit(c->h, td);
+  if (rv >= 0 && revert) {
+    c->api->ca_trans_revert(c->h, td);
+    c->api->ca_trans_abort(c->h, td);
+    xml_free(xt);
+    return -1;
+  }
+  c->api->ca_trans_end(c->h, td);
+  if (rv < 0) {
+    xml_free(xt);
+    return -1;
+  }
+  xml_free(c->xml);
+  c->xml = xt;
+  return 0;
+}
+
+static int check_commit(check_ctx_t *c, const char *test, const char *xml) {
+  if (check_apply(c, xml, false) < 0) {
+    fprintf(stderr, "[commit] %s: commit failed: %s\n", test,
+            clixon_err_reason());
+    failures++;
+    return -1;
+  }
+  return 0;
+}
+
+static void check_refused(check_ctx_t *c, const char *test, const char *xml) {
+  if (check_apply(c, xml, false) == 0) {
+    fprintf(stderr, "[commit] %s: commit accepted\n", test);
+    failures++;
+  }
+}
+
+static void expect_interface(const char *test, const char *name,
+                             uint32_t mtu, bool up) {
+  vpp_if_table_t t = {0};
+  uint32_t idx;
+
+  if (vpp_interface_dump_brief(&t) != 0 ||
+      (idx = vpp_if_table_find(&t, name)) == VPP_IF_NONE) {
+    fprintf(stderr, "[commit] %s: %s not in VPP\n", test, name);
+    failures++;
+  } else if (t.hot[idx].mtu != mtu ||
+             !!(t.hot[idx].flags & VPP_IF_F_ADMIN_UP) != up) {
+    fprintf(stderr, "[commit] %s: %s is MTU %u %s, expected MTU %u %s\n",
+            test, name, t.hot[idx].mtu,
+            t.hot[idx].flags & VPP_IF_F_ADMIN_UP ? "up" : "down", mtu,
+            up ? "up" : "down");
+    failures++;
+  }
+  vpp_if_table_free(&t);
+}
+
+/* Deleting mtu or enabled puts the YANG default back */
+static void check_leaf_delete(check_ctx_t *c) {
+  static const char *port = "TenGigabitEthernet0/0/0";
+
+  if (check_commit(c, "leaf add",
+                   "<interfaces><interface>"
+                   "<name>TenGigabitEthernet0/0/0</name>"
+                   "<mtu>2000</mtu><enabled>true</enabled>"
+                   "</interface></interfaces>") == 0)
+    expect_interface("leaf add", port, 2000, true);
+  if (check_commit(c, "leaf delete",
+                   "<interfaces><interface>"
+                   "<name>TenGigabitEthernet0/0/0</name>"
+                   "</interface></interfaces>") == 0)
+    expect_interface("leaf delete", port, 1500, false);
+}
+
+/* An interface VPP lacks fails the commit rather than being left out */
+static void check_missing(check_ctx_t *c) {
+  check_refused(c, "missing interface",
+                "<interfaces><interface>"
+                "<name>TenGigabitEthernet9/9/9</name><mtu>2000</mtu>"
+                "</interface></interfaces>");
+}
+
+/* A description is the rest of its CLI line: a newline in it would
+ * smuggle in a second command. Deleting one sends the command without
+ * text, which clears it. */
+static void check_description(check_ctx_t *c) {
+  static const char *port = "TenGigabitEthernet0/0/1";
+
+  check_commit(c, "description",
+               "<interfaces><interface>"
+               "<name>TenGigabitEthernet0/0/1</name>"
+               "<description>uplink</description>"
+               "</interface></interfaces>");
+  check_refused(c, "description newline",
+                "<interfaces><interface>"
+                "<name>TenGigabitEthernet0/0/1</name>"
+                "<description>uplink\nset interface state "
+                "TenGigabitEthernet0/0/1 down</description>"
+                "</interface></interfaces>");
+  expect_interface("description newline", port, 9000, true);
+  check_commit(c, "description delete",
+               "<interfaces><interface>"
+               "<name>TenGigabitEthernet0/0/1</name>"
+               "</interface></interfaces>");
+}
+
+/* Line of the startup script holding cmd, 0 if there is none */
+static int script_line(const char *path, const char *cmd) {
+  char line[512];
+  int n = 0;
+  FILE *fp = fopen(path, "r");
+
+  while (fp && fgets(line, sizeof(line), fp) != NULL) {
+    n++;
+    line[strcspn(line, "\n")] = '\0';
+    if (strcmp(line, cmd) == 0) {
+      fclose(fp);
+      return n;
+    }
+  }
+  if (fp)
+    fclose(fp);
+  return 0;
+}
+
+static void expect_script_before(check_ctx_t *c, const char *test,
+                                 const char *first, const char *then) {
+  int a = script_line(c->script, first);
+  int b = script_line(c->script, then);
+
+  if (a == 0 || b == 0 || a >= b) {
+    fprintf(stderr, "[commit] %s: script has '%s' at line %d, '%s' at %d\n",
+            test, first, a, then, b);
+    failures++;
+  }
+}
+
+/* The mock refuses a VLAN MTU above its parent's, and a parent below one;
+ * it starts with everything up at MTU 9000 */
+static void check_parent_mtu(check_ctx_t *c) {
+  static const char *names[] = {"BondEthernet0", "BondEthernet0.100",
+                                "BondEthernet0.101", "BondEthernet0.102",
+                                "BondEthernet0.103"};
+  static const char *mtu[] = {"", "<mtu>1500</mtu>", "<mtu>9000</mtu>"};
+  const size_t n = sizeof(names) / sizeof(names[0]);
+  cbuf *cb[3];
+
+  for (int i = 0; i < 3; i++) {
+    cb[i] = cbuf_new();
+    cprintf(cb[i], "<interfaces>");
+    for (size_t j = 0; j < n; j++)
+      cprintf(cb[i], "<interface><name>%s</name>%s</interface>", names[j],
+              mtu[i]);
+    cprintf(cb[i], "</interfaces>");
+  }
+  /* New leaves below what VPP has: the parent goes down */
+  if (check_commit(c, "parent MTU add", cbuf_get(cb[1])) == 0) {
+    for (size_t j = 0; j < n; j++)
+      expect_interface("parent MTU add", names[j], 1500, true);
+    expect_script_before(c, "parent MTU script",
+                         "set interface mtu 1500 BondEthernet0.100",
+                         "set interface mtu 1500 BondEthernet0");
+  }
+  if (check_commit(c, "parent MTU raise", cbuf_get(cb[2])) == 0)
+    for (size_t j = 0; j < n; j++)
+      expect_interface("parent MTU raise", names[j], 9000, true);
+  if (check_commit(c, "parent MTU delete", cbuf_get(cb[0])) == 0)
+    for (size_t j = 0; j < n; j++)
+      expect_interface("parent MTU delete", names[j], 1500, true);
+  for (int i = 0; i < 3; i++)
+    cbuf_free(cb[i]);
+}
+
+/* Where the mock's command log ends now */
+static long log_mark(check_ctx_t *c) {
+  FILE *fp = fopen(c->log, "r");
+  long end = -1;
+
+  if (fp && fseek(fp, 0, SEEK_END) == 0)
+    end = ftell(fp);
+  if (fp)
+    fclose(fp);
+  return end;
+}
+
+/* Commands that configure VPP the mock ran after mark, the last into cmd:
+ * neither "show" nor session setup, nor "exec", whose lines are logged */
+static int log_sent(check_ctx_t *c, long mark, char *cmd, size_t len) {
+  static const char *skip[] = {"show ", "set terminal ", "echo ", "exec "};
+  FILE *fp = fopen(c->log, "r");
+  char line[512];
+  int n = 0;
+
+  if (!fp || fseek(fp, mark, SEEK_SET) != 0) {
+    if (fp)
+      fclose(fp);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    size_t i = 0;
+
+    while (i < sizeof(skip) / sizeof(skip[0]) &&
+           strncmp(line, skip[i], strlen(skip[i])) != 0)
+      i++;
+    if (i < sizeof(skip) / sizeof(skip[0]))
+      continue;
+    line[strcspn(line, "\n")] = '\0';
+    snprintf(cmd, len, "%s", line);
+    n++;
+  }
+  fclose(fp);
+  return n;
+}
+
+/* Last command starting with prefix the mock ran after mark, into cmd
+ * Returns 0 if there is one */
+static int log_last(check_ctx_t *c, long mark, const char *prefix, char *cmd,
+                    size_t len) {
+  FILE *fp = fopen(c->log, "r");
+  char line[512];
+  int rv = -1;
+
+  if (!fp || fseek(fp, mark, SEEK_SET) != 0) {
+    if (fp)
+      fclose(fp);
+    return -1;
+  }
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    if (strncmp(line, prefix, strlen(prefix)) != 0)
+      continue;
+    line[strcspn(line, "\n")] = '\0';
+    snprintf(cmd, len, "%s", line);
+    rv = 0;
+  }
+  fclose(fp);
+  return rv;
+}
+
+/* TenGigabitEthernet1/0/0 back as it was: MTU 9000, up, described uplink */
+static void expect_undone(check_ctx_t *c, const char *test, long mark) {
+  static const char *descr =
+      "set interface description TenGigabitEthernet1/0/0 ";
+  char cmd[512] = "";
+
+  expect_interface(test, "TenGigabitEthernet1/0/0", 9000, true);
+  if (log_last(c, mark, descr, cmd, sizeof(cmd)) < 0 ||
+      strcmp(cmd + strlen(descr), "uplink") != 0) {
+    fprintf(stderr, "[commit] %s: description left at '%s'\n", test,
+            cmd[0] ? cmd + strlen(descr) : "");
+    failures++;
+  }
+}
+
+/* A commit VPP rejects part of, or that a later plugin fails, leaves VPP
+ * as it was: the journal undoes what went through, newest first */
+static void check_rollback(check_ctx_t *c) {
+  static const char *change =
+      "<interfaces><interface>"
+      "<name>TenGigabitEthernet1/0/0</name>"
+      "<description>downlink</description>"
+      "<mtu>2000</mtu><enabled>false</enabled>"
+      "</interface>%s</interfaces>";
+  /* Populated, the mock has it already and refuses it again */
+  static const char *taken =
+      "<interface><name>BondEthernet0.101</name>"
+      "<ipv4><address><ip>10.0.1.1</ip>"
+      "<prefix-length>24</prefix-length></address></ipv4>"
+      "</interface>";
+  char xml[512];
+  long mark;
+
+  if (check_commit(c, "rollback",
+                   "<interfaces><interface>"
+                   "<name>TenGigabitEthernet1/0/0</name>"
+                   "<description>uplink</description>"
+                   "</interface></interfaces>") < 0)
+    return;
+
+  snprintf(xml, sizeof(xml), change, taken);
+  mark = log_mark(c);
+  check_refused(c, "rollback rejected", xml);
+  expect_undone(c, "rollback rejected", mark);
+
+  snprintf(xml, sizeof(xml), change, "");
+  mark = log_mark(c);
+  if (check_apply(c, xml, true) == 0) {
+    fprintf(stderr, "[commit] rollback revert: commit kept\n");
+    failures++;
+  }
+  expect_undone(c, "rollback revert", mark);
+}
+
+static int write_file(const char *path, const char *text) {
+  FILE *fp = fopen(path, "w");
+
+  if (!fp)
+    return -1;
+  fputs(text, fp);
+  return fclose(fp);
+}
+
+/* The backend restarting while VPP stays up */
+static void check_restart(check_ctx_t *c) {
+  c->api->ca_exit(c->h);
+  c->api->ca_start(c->h);
+}
+
+/* A backend restart sends what drifted from vpp_config.xml, nothing else */
+static void check_restart_drift(check_ctx_t *c) {
+  static const char *config =
+      "<config>\n"
+      "  <interfaces xmlns=\"http://example.com/vpp/interfaces\">\n"
+      "    <interface>\n"
+      "      <name>BondEthernet0.101</name>\n"
+      "      <enabled>true</enabled>\n"
+      "      <ipv4-address>\n"
+      "        <address>10.0.1.1</address>\n"
+      "        <prefix-length>24</prefix-length>\n"
+      "      </ipv4-address>\n"
+      "    </interface>\n"
+      "  </interfaces>\n"
+      "  <lcps xmlns=\"http://example.com/vpp/lcp\">\n"
+      "    <lcp>\n"
+      "      <vpp-interface>BondEthernet0.101</vpp-interface>\n"
+      "      <host-interface>be0.101</host-interface>\n"
+      "      <netns>dataplane</netns>\n"
+      "    </lcp>\n"
+      "  </lcps>\n"
+      "</config>\n";
+  static const char *addr = "set interface ip address BondEthernet0.101 "
+                            "10.0.1.1/24";
+  char cmd[512] = "";
+  long mark;
+  int n;
+
+  if (write_file(c->config, config) < 0) {
+    fprintf(stderr, "[commit] restart: cannot write %s\n", c->config);
+    failures++;
+    return;
+  }
+  mark = log_mark(c);
+  check_restart(c);
+  if ((n = log_sent(c, mark, cmd, sizeof(cmd))) != 0) {
+    fprintf(stderr, "[commit] restart: %d commands sent, VPP had it all\n",
+            n);
+    failures++;
+  }
+
+  free(vpp_cli_exec("set interface ip address del BondEthernet0.101 "
+                    "10.0.1.1/24"));
+  mark = log_mark(c);
+  check_restart(c);
+  if ((n = log_sent(c, mark, cmd, sizeof(cmd))) != 1 ||
+      strcmp(cmd, addr) != 0) {
+    fprintf(stderr,
+            "[commit] restart drift: %d commands sent, the last '%s', "
+            "expected '%s' only\n",
+            n, cmd, addr);
+    failures++;
+  }
+  unlink(c->config);
+}
+
+/* VPP restarting empty while the backend stays up: the next request
+ * reconnects to it and gets it back to vpp_config.xml and running */
+static void check_vpp_restart(check_ctx_t *c) {
+  cxobj *xstate = xml_new("data", NULL, CX_ELMNT);
+
+  bench_mock_stop(c->mock);
+  if ((c->mock = bench_mock_start(c->sock, CHECK_SCALE, false, c->log)) < 0) {
+    fprintf(stderr, "[commit] VPP restart: mock did not start\n");
+    failures++;
+  }
+  vpp_disconnect();
+  c->api->ca_statedata(c->h, NULL, "/", xstate);
+  xml_free(xstate);
+}
+
+static void expect_lcp(const char *test, const char *vpp_if,
+                       const char *host_if) {
+  vpp_api_set_t *lcps = vpp_api_get_lcps();
+  vpp_api_iter_t it = vpp_api_iter(lcps);
+  const vpp_lcp_info_t *l;
+
+  while ((l = vpp_api_iter_next(&it)) != NULL)
+    if (strcmp(l->vpp_if, vpp_if) == 0 && strcmp(l->host_if, host_if) == 0)
+      break;
+  if (l == NULL) {
+    fprintf(stderr, "[commit] %s: no LCP pair %s %s\n", test, vpp_if,
+            host_if);
+    failures++;
+  }
+  vpp_api_set_free(lcps);
+}
+
+/* Membership is in the snapshot, which reads "show bond details" */
+static void expect_bond(const char *test, const char *bond,
+                        const char *const *members, size_t n) {
+  const vpp_if_table_t *t;
+  uint32_t idx = VPP_IF_NONE;
+  uint32_t m;
+
+  vpp_interface_snapshot_invalidate();
+  if ((t = vpp_interface_snapshot()) == NULL ||
+      (idx = vpp_if_table_find(t, bond)) == VPP_IF_NONE) {
+    fprintf(stderr, "[commit] %s: %s not in VPP\n", test, bond);
+    failures++;
+  }
+  for (size_t i = 0; idx != VPP_IF_NONE && i < n; i++)
+    if ((m = vpp_if_table_find(t, members[i])) == VPP_IF_NONE ||
+        t->hot[m].bond_sw_if_index != idx) {
+      fprintf(stderr, "[commit] %s: %s not a member of %s\n", test,
+              members[i], bond);
+      failures++;
+    }
+}
+
+static void expect_addr(const char *test, const char *addr, bool present) {
+  char *addrs = vpp_cli_exec("show interface addr");
+  char l3[64];
+
+  snprintf(l3, sizeof(l3), "L3 %s", addr);
+  if (!addrs || (strstr(addrs, l3) != NULL) != present) {
+    fprintf(stderr, "[commit] %s: %s %s\n", test, addr,
+            present ? "missing" : "still there");
+    failures++;
+  }
+  free(addrs);
+}
+
+/* Bonds and LCP pairs only vpp_config.xml holds come back with a
+ * restarted VPP, and a VLAN on the bond gets running's settings */
+static void check_reconcile(check_ctx_t *c) {
+  static const char *config =
+      "<config>\n"
+      "  <interfaces xmlns=\"http://example.com/vpp/interfaces\">\n"
+      "    <interface>\n"
+      "      <name>BondEthernet0</name>\n"
+      "      <enabled>true</enabled>\n"
+      "      <ipv4-address>\n"
+      "        <address>172.16.0.1</address>\n"
+      "        <prefix-length>24</prefix-length>\n"
+      "      </ipv4-address>\n"
+      "    </interface>\n"
+      "    <interface>\n"
+      "      <name>BondEthernet0.100</name>\n"
+      "      <enabled>true</enabled>\n"
+      "      <ipv4-address>\n"
+      "        <address>10.0.0.1</address>\n"
+      "        <prefix-length>24</prefix-length>\n"
+      "      </ipv4-address>\n"
+      "    </interface>\n"
+      "  </interfaces>\n"
+      "  <bonds xmlns=\"http://example.com/vpp/bonds\">\n"
+      "    <bond>\n"
+      "      <name>BondEthernet0</name>\n"
+      "      <id>0</id>\n"
+      "      <mode>lacp</mode>\n"
+      "      <load-balance>l34</load-balance>\n"
+      "      <members>TenGigabitEthernet0/0/0,TenGigabitEthernet0/0/1"
+      "</members>\n"
+      "    </bond>\n"
+      "  </bonds>\n"
+      "  <lcps xmlns=\"http://example.com/vpp/lcp\">\n"
+      "    <lcp>\n"
+      "      <vpp-interface>BondEthernet0</vpp-interface>\n"
+      "      <host-interface>be0</host-interface>\n"
+      "      <netns>dataplane</netns>\n"
+      "    </lcp>\n"
+      "    <lcp>\n"
+      "      <vpp-interface>BondEthernet0.100</vpp-interface>\n"
+      "      <host-interface>be0.100</host-interface>\n"
+      "      <netns>dataplane</netns>\n"
+      "    </lcp>\n"
+      "  </lcps>\n"
+      "</config>\n";
+  static const char *const members[] = {"TenGigabitEthernet0/0/0",
+                                        "TenGigabitEthernet0/0/1"};
+
+  if (write_file(c->config, config) < 0) {
+    fprintf(stderr, "[commit] reconcile: cannot write %s\n", c->config);
+    failures++;
+    return;
+  }
+  /* As cli_vpp_commit writes it: interfaces only */
+  if (check_commit(c, "reconcile",
+                   "<interfaces><interface>"
+                   "<name>BondEthernet0.100</name>"
+                   "<enabled>true</enabled><mtu>1500</mtu>"
+                   "<ipv4><address><ip>10.0.100.1</ip>"
+                   "<prefix-length>24</prefix-length></address></ipv4>"
+                   "</interface></interfaces>") < 0) {
+    unlink(c->config);
+    return;
+  }
+  /* Running has no bonds or LCP pairs, the script still does. VPP's
+   * exec stops at the first failing command: the VLAN needs the bond,
+   * and its LCP pair the VLAN */
+  expect_script_before(c, "reconcile script",
+                       "create bond mode lacp load-balance l34",
+                       "bond add BondEthernet0 TenGigabitEthernet0/0/0");
+  expect_script_before(c, "reconcile script",
+                       "bond add BondEthernet0 TenGigabitEthernet0/0/1",
+                       "create sub-interfaces BondEthernet0 100 dot1q 100 "
+                       "exact-match");
+  expect_script_before(c, "reconcile script",
+                       "create sub-interfaces BondEthernet0 100 dot1q 100 "
+                       "exact-match",
+                       "lcp create BondEthernet0.100 host-if be0.100 netns "
+                       "dataplane");
+  running = c->xml;
+  check_vpp_restart(c);
+  running = NULL;
+
+  expect_bond("reconcile", "BondEthernet0", members, 2);
+  expect_interface("reconcile", "BondEthernet0", 9000, true);
+  expect_interface("reconcile", "BondEthernet0.100", 1500, true);
+  expect_addr("reconcile", "172.16.0.1/24", true);
+  expect_addr("reconcile", "10.0.100.1/24", true);
+  expect_addr("reconcile", "10.0.0.1/24", false);
+  expect_lcp("reconcile", "BondEthernet0", "be0");
+  expect_lcp("reconcile", "BondEthernet0.100", "be0.100");
+  unlink(c->config);
+}
+
+int main(void) {
+  check_ctx_t c = {0};
+  char sock[64], config[64], script[64], log[64];
+
+  snprintf(sock, sizeof(sock), "/tmp/commit-check.%d.sock", getpid());
+  snprintf(config, sizeof(config), "/tmp/commit-check.%d.xml", getpid());
+  snprintf(script, sizeof(script), "/tmp/commit-check.%d.exec", getpid());
+  snprintf(log, sizeof(log), "/tmp/commit-check.%d.log", getpid());
+  setenv("VPP_CLI_SOCK", sock, 1);
+  setenv("VPP_CONFIG_FILE", config, 1); /* Only while a check restarts */
+  setenv("VPP_STARTUP_SCRIPT", script, 1);
+
+  c.script = script;
+  c.config = config;
+  c.log = log;
+  c.sock = sock;
+  c.h = clixon_handle_init();
+  clixon_log_init(c.h, "commit_check", LOG_ERR, CLIXON_LOG_STDERR);
+  clixon_plugin_module_init(c.h); /* RPCs are registered on start */
+  c.api = clixon_plugin_init(c.h);
+  c.td = transaction_new();
+  c.xml = xml_new("config", NULL, CX_ELMNT);
+  if (!c.api || !c.td || !c.xml ||
+      (c.mock = bench_mock_start(sock, CHECK_SCALE, true, log)) < 0)
+    return 1;
+
+  check_leaf_delete(&c);
+  check_description(&c);
+  check_missing(&c);
+  check_parent_mtu(&c);
+  check_rollback(&c);
+  check_restart_drift(&c);
+  check_reconcile(&c);
+
+  c.api->ca_exit(c.h);
+  bench_mock_stop(c.mock);
+  unlink(script);
+  unlink(log);
+  xml_free(c.xml);
+  fprintf(stderr, "[check] commit: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
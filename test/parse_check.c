@@ -0,0 +1,506 @@
+/*
+ * parse_check.c - Regression and cost harness for the "show" parsers
+ *
+ * Each directory of test/corpus holds the show outputs of one VPP, one
+ * file per command as test/vpp_mock -R writes them, plus "expected":
+ * what the parsers made of them when the corpus was last reviewed. The
+ * harness replays a directory through the parsers of vpp_interface.c,
+ * vpp_api.c and vpp_cli_plugin.c, prints their results in one text form
+ * and compares it with expected. Any difference is written next to it
+ * as "actual" and fails the run.
+ *
+ * Every parser also reports what one parse costs, as a JSON line on
+ * stdout like the benchmarks':
+ *   {"corpus":"1000","parser":"interface_dump","lines":4669,
+ *    "ns_per_line":38.1,"allocs":0.0,"alloc_bytes":0,"ok":true}
+ * lines are the lines of output the parser reads; allocs and alloc_bytes
+ * are heap allocations per parse once its tables have grown, counted by
+ * the malloc family below. The CLI plugin reads vppctl through popen(),
+ * which is answered from the corpus too, so no process is spawned.
+ *
+ * Usage: parse_check [-u] [-t min-ms] corpus-dir...
+ *   -u  write expected from the current parsers instead of comparing
+ * VPP_TOK_ISA picks the scanner as in the plugins; one the CPU lacks
+ * skips the run rather than checking the default scanner again.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <cligen/cligen.h>
+#include <clixon/clixon.h>
+
+#include "../bench/bench_replay.h"
+#include "../bench/bench_util.h"
+#include "../src/vpp_api.h"
+#include "../src/vpp_interface.h"
+#include "../src/vpp_tok.h"
+
+/* vpp_cli_plugin.c, which has no header of its own */
+int cli_show_interfaces(clixon_handle h, cvec *cvv, cvec *argv);
+int cli_show_interfaces_brief(clixon_handle h, cvec *cvv, cvec *argv);
+int cli_show_bond(clixon_handle h, cvec *cvv, cvec *argv);
+int cli_show_lcp(clixon_handle h, cvec *cvv, cvec *argv);
+int cli_show_ip_interface(clixon_handle h, cvec *cvv, cvec *argv);
+int cli_expand_interfaces(void *h, char *name, cvec *cvv, cvec *argv,
+                          cvec *commands, cvec *helptexts);
+int cli_expand_ethernet(void *h, char *name, cvec *cvv, cvec *argv,
+                        cvec *commands, cvec *helptexts);
+int cli_expand_bonds(void *h, char *name, cvec *cvv, cvec *argv,
+                     cvec *commands, cvec *helptexts);
+int cli_expand_loopback(void *h, char *name, cvec *cvv, cvec *argv,
+                        cvec *commands, cvec *helptexts);
+int cli_expand_subifs(void *h, char *name, cvec *cvv, cvec *argv,
+                      cvec *commands, cvec *helptexts);
+
+/*=============================================================
+ * ALLOCATION COUNTING - glibc's documented malloc replacement
+ *=============================================================*/
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+static int counting;
+static uint64_t nallocs;
+static uint64_t alloc_bytes;
+
+void *malloc(size_t size) {
+  if (counting) {
+    nallocs++;
+    alloc_bytes += size;
+  }
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+  if (counting) {
+    nallocs++;
+    alloc_bytes += n * size;
+  }
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (counting) {
+    nallocs++;
+    alloc_bytes += size;
+  }
+  return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) { __libc_free(ptr); }
+
+/*=============================================================
+ * VPPCTL - the CLI plugin's popen("sudo vppctl -s SOCK CMD 2>&1")
+ *=============================================================*/
+
+FILE *popen(const char *command, const char *type) {
+  char cmd[256];
+  const char *p = command;
+  const char *text;
+  size_t len;
+
+  (void)type;
+  /* Skip "sudo vppctl -s SOCK " and drop " 2>&1" */
+  for (int i = 0; i < 4 && p; i++)
+    if ((p = strchr(p, ' ')))
+      p++;
+  if (!p)
+    return NULL;
+  len = strlen(p);
+  if (len >= 5 && strcmp(p + len - 5, " 2>&1") == 0)
+    len -= 5;
+  if (len >= sizeof(cmd))
+    return NULL;
+  memcpy(cmd, p, len);
+  cmd[len] = '\0';
+
+  text = bench_replay_text(cmd);
+  if (!text || bench_replay_size(cmd) == 0)
+    return fopen("/dev/null", "r");
+  return fmemopen((void *)text, bench_replay_size(cmd), "r");
+}
+
+int pclose(FILE *fp) { return fclose(fp) == 0 ? 0 : -1; }
+
+/*=============================================================
+ * PARSERS
+ *=============================================================*/
+
+typedef struct {
+  vpp_if_table_t table;
+  vpp_api_set_t *set; /* vpp_api_get_*() of the last run */
+  FILE *out; /* CLI output of the last run */
+  cvec *commands;
+  cvec *helptexts;
+} check_ctx_t;
+
+typedef struct {
+  const char *name;
+  const char *cmds[3]; /* Outputs it reads */
+  int (*run)(check_ctx_t *c, void *fn);
+  void (*dump)(check_ctx_t *c, FILE *fp);
+  void *fn;
+} check_t;
+
+static void dump_table(check_ctx_t *c, FILE *fp, bool hw) {
+  const vpp_if_table_t *t = &c->table;
+  char mac[18];
+
+  for (uint32_t i = 0; i < t->max; i++) {
+    const vpp_if_hot_t *hot = &t->hot[i];
+    const vpp_if_cold_t *cold = &t->cold[i];
+
+    if (!vpp_if_present(t, i))
+      continue;
+    fprintf(fp, "%u %s sup=%u mtu=%u admin=%d link=%d", i, cold->name,
+            hot->sup_sw_if_index, hot->mtu,
+            !!(hot->flags & VPP_IF_F_ADMIN_UP),
+            !!(hot->flags & VPP_IF_F_LINK_UP));
+    if (hw) {
+      vpp_mac_bytes_to_string(cold->mac, mac, sizeof(mac));
+      fprintf(fp, " speed=%u duplex=%u mac=%s type=%s driver=%s",
+              hot->link_speed, hot->link_duplex, mac, cold->type,
+              cold->driver);
+    }
+    fprintf(fp, "\n");
+  }
+}
+
+static int run_dump_brief(check_ctx_t *c, void *fn) {
+  (void)fn;
+  return vpp_interface_dump_brief(&c->table);
+}
+
+static void dump_brief(check_ctx_t *c, FILE *fp) { dump_table(c, fp, false); }
+
+static int run_dump(check_ctx_t *c, void *fn) {
+  (void)fn;
+  return vpp_interface_dump(&c->table);
+}
+
+static void dump_full(check_ctx_t *c, FILE *fp) { dump_table(c, fp, true); }
+
+static int run_snapshot(check_ctx_t *c, void *fn) {
+  (void)c;
+  (void)fn;
+  vpp_interface_snapshot_invalidate();
+  return vpp_interface_snapshot() ? 0 : -1;
+}
+
+static void dump_snapshot(check_ctx_t *c, FILE *fp) {
+  const vpp_if_table_t *t = vpp_interface_snapshot();
+
+  (void)c;
+  for (uint32_t i = 0; t && i < t->max; i++)
+    if (vpp_if_present(t, i) && t->hot[i].bond_sw_if_index != VPP_IF_NONE)
+      fprintf(fp, "%s bond=%u\n", t->cold[i].name, t->hot[i].bond_sw_if_index);
+}
+
+static int run_api_interfaces(check_ctx_t *c, void *fn) {
+  (void)fn;
+  vpp_api_set_free(c->set);
+  c->set = vpp_api_get_interfaces();
+  return c->set ? 0 : -1;
+}
+
+static void dump_api_interfaces(check_ctx_t *c, FILE *fp) {
+  vpp_api_iter_t it = vpp_api_iter(c->set);
+  const vpp_interface_info_t *ifi;
+
+  while ((ifi = vpp_api_iter_next(&it)))
+    fprintf(fp, "%s %u admin=%d link=%d mtu=%u\n", ifi->name,
+            ifi->sw_if_index, ifi->admin_up, ifi->link_up, ifi->mtu);
+}
+
+static int run_api_bonds(check_ctx_t *c, void *fn) {
+  (void)fn;
+  vpp_api_set_free(c->set);
+  c->set = vpp_api_get_bonds();
+  return c->set ? 0 : -1;
+}
+
+static void dump_api_bonds(check_ctx_t *c, FILE *fp) {
+  vpp_api_iter_t it = vpp_api_iter(c->set);
+  const vpp_bond_info_t *b;
+
+  while ((b = vpp_api_iter_next(&it)))
+    fprintf(fp, "%s %u id=%u mode=%u lb=%u members=%u active=%u\n", b->name,
+            b->sw_if_index, b->id, b->mode, b->lb, b->members,
+            b->active_members);
+}
+
+static int run_api_lcps(check_ctx_t *c, void *fn) {
+  (void)fn;
+  vpp_api_set_free(c->set);
+  c->set = vpp_api_get_lcps();
+  return c->set ? 0 : -1;
+}
+
+static void dump_api_lcps(check_ctx_t *c, FILE *fp) {
+  vpp_api_iter_t it = vpp_api_iter(c->set);
+  const vpp_lcp_info_t *l;
+
+  while ((l = vpp_api_iter_next(&it)))
+    fprintf(fp, "%s %u %s %u netns=%s\n", l->vpp_if, l->phy_sw_if_index,
+            l->host_if, l->host_sw_if_index, l->netns);
+}
+
+/* The show commands print to stdout; catch it in c->out */
+static int run_cli_show(check_ctx_t *c, void *fn) {
+  int (*show)(clixon_handle, cvec *, cvec *) = fn;
+  FILE *saved = stdout;
+  int rv;
+
+  rewind(c->out);
+  if (ftruncate(fileno(c->out), 0) < 0)
+    return -1;
+  stdout = c->out;
+  rv = show(NULL, NULL, NULL);
+  fflush(c->out);
+  stdout = saved;
+  return rv;
+}
+
+static void dump_cli_show(check_ctx_t *c, FILE *fp) {
+  char buf[4096];
+  size_t n;
+
+  rewind(c->out);
+  while ((n = fread(buf, 1, sizeof(buf), c->out)) > 0)
+    fwrite(buf, 1, n, fp);
+}
+
+static int run_cli_expand(check_ctx_t *c, void *fn) {
+  int (*expand)(void *, char *, cvec *, cvec *, cvec *, cvec *) = fn;
+
+  cvec_reset(c->commands);
+  cvec_reset(c->helptexts);
+  return expand(NULL, NULL, NULL, NULL, c->commands, c->helptexts);
+}
+
+static void dump_cli_expand(check_ctx_t *c, FILE *fp) {
+  for (int i = 0; i < cvec_len(c->commands); i++)
+    fprintf(fp, "%s | %s\n", cv_string_get(cvec_i(c->commands, i)),
+            i < cvec_len(c->helptexts)
+                ? cv_string_get(cvec_i(c->helptexts, i))
+                : "");
+}
+
+#define SHOW(fn, cmd) {#fn, {cmd}, run_cli_show, dump_cli_show, (void *)fn}
+#define EXPAND(fn)                                                             \
+  {#fn, {"show interface"}, run_cli_expand, dump_cli_expand, (void *)fn}
+
+static const check_t checks[] = {
+    {"interface_dump_brief", {"show interface"}, run_dump_brief, dump_brief,
+     NULL},
+    {"interface_dump",
+     {"show interface", "show hardware-interfaces"},
+     run_dump,
+     dump_full,
+     NULL},
+    {"interface_snapshot",
+     {"show interface", "show bond details"},
+     run_snapshot,
+     dump_snapshot,
+     NULL},
+    {"api_get_interfaces",
+     {"show interface"},
+     run_api_interfaces,
+     dump_api_interfaces,
+     NULL},
+    {"api_get_bonds", {"show bond details"}, run_api_bonds, dump_api_bonds,
+     NULL},
+    {"api_get_lcps", {"show lcp"}, run_api_lcps, dump_api_lcps, NULL},
+    SHOW(cli_show_interfaces, "show interface addr"),
+    SHOW(cli_show_interfaces_brief, "show interface"),
+    SHOW(cli_show_bond, "show bond details"),
+    SHOW(cli_show_lcp, "show lcp"),
+    SHOW(cli_show_ip_interface, "show interface addr"),
+    EXPAND(cli_expand_interfaces),
+    EXPAND(cli_expand_ethernet),
+    EXPAND(cli_expand_bonds),
+    EXPAND(cli_expand_loopback),
+    EXPAND(cli_expand_subifs),
+};
+
+/*=============================================================
+ * HARNESS
+ *=============================================================*/
+
+static size_t count_lines(const char *const *cmds) {
+  size_t n = 0;
+
+  for (size_t i = 0; i < 3 && cmds[i]; i++) {
+    vpp_slice_t line;
+    vpp_tok_t tok;
+
+    vpp_tok_init(&tok, bench_replay_text(cmds[i]), bench_replay_size(cmds[i]));
+    while (vpp_tok_line(&tok, &line))
+      n++;
+  }
+  return n;
+}
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *fp = fopen(path, "r");
+  char *buf = NULL;
+  long size;
+
+  if (!fp)
+    return NULL;
+  if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) >= 0 &&
+      fseek(fp, 0, SEEK_SET) == 0 && (buf = malloc((size_t)size + 1)) != NULL)
+    *len = fread(buf, 1, (size_t)size, fp);
+  fclose(fp);
+  return buf;
+}
+
+static int write_file(const char *path, const char *buf, size_t len) {
+  FILE *fp = fopen(path, "w");
+
+  if (!fp) {
+    fprintf(stderr, "[check] %s: %s\n", path, strerror(errno));
+    return -1;
+  }
+  fwrite(buf, 1, len, fp);
+  return fclose(fp) == 0 ? 0 : -1;
+}
+
+/* Run c once untimed, then for min_ms; print its cost and results */
+static int check_one(check_ctx_t *ctx, const check_t *c, const char *corpus,
+                     uint64_t min_ms, FILE *dump) {
+  size_t lines = count_lines(c->cmds);
+  uint64_t iters = 0;
+  uint64_t start;
+  uint64_t ns = 0;
+  int rv = c->run(ctx, c->fn);
+
+  nallocs = alloc_bytes = 0;
+  start = bench_now_ns();
+  while (rv == 0 && (iters == 0 || ns < min_ms * 1000000)) {
+    counting = 1;
+    rv = c->run(ctx, c->fn);
+    counting = 0;
+    iters++;
+    ns = bench_now_ns() - start;
+  }
+
+  printf("{\"corpus\":\"%s\",\"parser\":\"%s\",\"lines\":%zu,"
+         "\"ns_per_line\":%.1f,\"allocs\":%.1f,\"alloc_bytes\":%llu,"
+         "\"ok\":%s}\n",
+         corpus, c->name, lines,
+         lines && iters ? (double)ns / (double)iters / (double)lines : 0.0,
+         iters ? (double)nallocs / (double)iters : 0.0,
+         iters ? (unsigned long long)(alloc_bytes / iters) : 0ULL,
+         rv == 0 ? "true" : "false");
+  fflush(stdout);
+
+  fprintf(dump, "== %s\n", c->name);
+  if (rv == 0)
+    c->dump(ctx, dump);
+  else
+    fprintf(dump, "error %d\n", rv);
+  return rv;
+}
+
+static int check_corpus(const char *dir, uint64_t min_ms, bool update) {
+  check_ctx_t ctx = {0};
+  const char *corpus = strrchr(dir, '/') ? strrchr(dir, '/') + 1 : dir;
+  char path[512];
+  char *got = NULL;
+  size_t got_len = 0;
+  char *want;
+  size_t want_len;
+  FILE *dump;
+  int ret = 0;
+
+  if (bench_replay_load(dir) < 0)
+    return -1;
+  ctx.out = tmpfile();
+  ctx.commands = cvec_new(0);
+  ctx.helptexts = cvec_new(0);
+  dump = open_memstream(&got, &got_len);
+  if (!ctx.out || !ctx.commands || !ctx.helptexts || !dump) {
+    fprintf(stderr, "[check] %s: out of memory\n", dir);
+    return -1;
+  }
+
+  for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++)
+    if (check_one(&ctx, &checks[i], corpus, min_ms, dump) != 0)
+      ret = -1;
+  fclose(dump);
+
+  snprintf(path, sizeof(path), "%s/expected", dir);
+  if (update) {
+    if (write_file(path, got, got_len) < 0)
+      ret = -1;
+  } else if (!(want = read_file(path, &want_len))) {
+    fprintf(stderr, "[check] %s: %s, run with -u to create it\n", path,
+            strerror(errno));
+    ret = -1;
+  } else {
+    if (want_len != got_len || memcmp(want, got, got_len) != 0) {
+      snprintf(path, sizeof(path), "%s/actual", dir);
+      write_file(path, got, got_len);
+      fprintf(stderr, "[check] %s: parsers differ, diff -u %s/expected %s\n",
+              corpus, dir, path);
+      ret = -1;
+    }
+    free(want);
+  }
+
+  free(got);
+  cvec_free(ctx.commands);
+  cvec_free(ctx.helptexts);
+  fclose(ctx.out);
+  vpp_api_set_free(ctx.set);
+  vpp_if_table_free(&ctx.table);
+  bench_replay_free();
+  return ret;
+}
+
+int main(int argc, char **argv) {
+  uint64_t min_ms = 20;
+  const char *isa = getenv("VPP_TOK_ISA");
+  bool update = false;
+  int ret = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "ut:")) != -1) {
+    switch (opt) {
+    case 'u':
+      update = true;
+      break;
+    case 't':
+      min_ms = strtoull(optarg, NULL, 10);
+      break;
+    default:
+      fprintf(stderr, "Usage: %s [-u] [-t min-ms] corpus-dir...\n", argv[0]);
+      return 2;
+    }
+  }
+  if (optind >= argc) {
+    fprintf(stderr, "Usage: %s [-u] [-t min-ms] corpus-dir...\n", argv[0]);
+    return 2;
+  }
+  if (isa && *isa && vpp_tok_select(isa) < 0) {
+    fprintf(stderr, "[check] %s scanner: not supported here, skipped\n", isa);
+    return 0;
+  }
+
+  for (int i = optind; i < argc; i++) {
+    if (check_corpus(argv[i], min_ms, update) < 0)
+      ret = 1;
+    else
+      fprintf(stderr, "[check] %s (%s): %s\n", argv[i], vpp_tok_isa(),
+              update ? "written" : "ok");
+  }
+  return ret;
+}
@@ -0,0 +1,93 @@
+/*
+ * plan_check.c - Ordering checks for the op planner
+ *
+ * Builds op queues the way a commit or the startup replay does and
+ * checks the levels vpp_plan_build() puts them in. Ops of one level may
+ * run on different CLI sessions at once, so anything VPP needs in order
+ * must end up in different levels. Needs no VPP: nothing is executed.
+ *
+ * Usage: plan_check
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/vpp_op.h"
+#include "../src/vpp_plan.h"
+
+static int failures;
+
+static vpp_op_t *mtu(vpp_op_queue_t *q, const char *ifname, uint32_t value,
+                     uint32_t prev) {
+  vpp_op_t *op = vpp_op_submit(q, VPP_OP_SET_MTU, ifname);
+
+  if (op) {
+    op->value = value;
+    op->value2 = prev;
+  }
+  return op;
+}
+
+/* Level of the op on ifname, UINT32_MAX if there is none */
+static uint32_t level_of(const vpp_plan_t *plan, const vpp_op_queue_t *q,
+                         const char *ifname) {
+  for (size_t i = 0; i < q->len; i++)
+    if (strcmp(q->ops[i].ifname, ifname) == 0)
+      return plan->level[i];
+  return UINT32_MAX;
+}
+
+static void expect_before(const char *test, const vpp_plan_t *plan,
+                          const vpp_op_queue_t *q, const char *first,
+                          const char *then) {
+  uint32_t a = level_of(plan, q, first);
+  uint32_t b = level_of(plan, q, then);
+
+  if (a >= b) {
+    fprintf(stderr, "[plan] %s: %s (level %u) not before %s (level %u)\n",
+            test, first, a, then, b);
+    failures++;
+  }
+}
+
+/* A parent MTU and its VLANs' in both queue orders */
+static void check_parent_mtu(const char *test, uint32_t from, uint32_t to,
+                             bool vlans_first, bool parent_first) {
+  static const char *vlans[] = {"BondEthernet0.100", "BondEthernet0.200"};
+  vpp_op_queue_t q;
+  vpp_plan_t plan;
+
+  vpp_op_queue_init(&q);
+  if (!vlans_first)
+    mtu(&q, "BondEthernet0", to, from);
+  for (size_t i = 0; i < 2; i++)
+    mtu(&q, vlans[i], to, from);
+  if (vlans_first)
+    mtu(&q, "BondEthernet0", to, from);
+
+  if (vpp_plan_build(&plan, &q) < 0) {
+    fprintf(stderr, "[plan] %s: no plan\n", test);
+    failures++;
+  } else {
+    for (size_t i = 0; i < 2; i++) {
+      if (parent_first)
+        expect_before(test, &plan, &q, "BondEthernet0", vlans[i]);
+      else
+        expect_before(test, &plan, &q, vlans[i], "BondEthernet0");
+    }
+  }
+  vpp_plan_free(&plan);
+  vpp_op_queue_free(&q);
+}
+
+int main(void) {
+  check_parent_mtu("raise", 1500, 9000, false, true);
+  check_parent_mtu("raise, VLANs queued first", 1500, 9000, true, true);
+  check_parent_mtu("lower", 9000, 1500, false, false);
+  check_parent_mtu("lower, VLANs queued first", 9000, 1500, true, false);
+  check_parent_mtu("previous unknown", 0, 9000, true, true);
+
+  fprintf(stderr, "[check] plan: %s\n", failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
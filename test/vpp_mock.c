@@ -0,0 +1,1618 @@
+/*
+ * vpp_mock.c - Mock VPP CLI socket server for benchmarks and tests
+ *
+ * Listens on a Unix socket in place of /run/vpp/cli.sock and answers the
+ * part of the VPP CLI the control plane uses: the show commands it
+ * scrapes (interface, interface addr, hardware-interfaces, bond, lcp)
+ * and the create/set/delete commands it sends, against in-memory state.
+ * Replies follow the VPP 25.06 layout the parsers expect: the command
+ * line is echoed, lines end in CRLF and every reply ends with "vpp# ".
+ *
+ * Like VPP's own CLI, commands of all sessions run one at a time on one
+ * thread, so a per-command latency (-d, -D) delays every session.
+ * Failures read "<verb>: unknown input `...'" or "<verb>: error: ...",
+ * which is what vpp_cli_output_is_error() looks for.
+ *
+ * Example, ~10k interfaces with 64 bonds and 4k VLANs:
+ *   test/vpp_mock -s /tmp/vpp-mock.sock -p 5800 -b 64 -v 4096 -a -c
+ *   VPP_CLI_SOCK=/tmp/vpp-mock.sock clixon_backend -f ...
+ *
+ * With -R the show outputs of the generated configuration are written to
+ * a directory instead, as input for replay benchmarks.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MOCK_SOCKET "/run/vpp/cli.sock"
+#define MOCK_PROMPT "vpp# "
+#define MOCK_NONE UINT32_MAX
+#define MOCK_HASH_SIZE 65536 /* Name hash buckets, power of two */
+#define MOCK_MAX_CLIENTS 64
+#define MOCK_MAX_ARGS 32
+#define MOCK_LINE_MAX 1024
+#define MOCK_MAX_RULES 16 /* -D and -F entries */
+#define MOCK_EXEC_DEPTH 4
+#define MOCK_TAP_BASE 4096 /* First tap instance of an LCP pair */
+
+typedef enum {
+  IF_LOCAL,
+  IF_ETHERNET,
+  IF_BOND,
+  IF_SUB,
+  IF_LOOPBACK,
+  IF_TAP,
+} if_kind_t;
+
+typedef struct {
+  bool present;
+  if_kind_t kind;
+  char name[64];
+  uint32_t hw_if_index;  /* MOCK_NONE for sub-interfaces */
+  bool admin_up;
+  uint32_t mtu;
+  uint32_t sup;          /* Parent of a sub-interface, else self */
+  uint32_t sub_id;
+  uint32_t vlan;
+  uint32_t instance;     /* BondEthernetN, loopN, tapN */
+  uint32_t bond;         /* Bond this interface is a member of */
+  char mode[16];         /* Bond mode and load balance */
+  char lb[8];
+  uint8_t mac[6];
+  char description[256];
+  char (*addr)[48];
+  uint32_t naddr;
+  uint32_t lcp_tap;      /* Host tap of the LCP pair, MOCK_NONE if none */
+  uint32_t lcp_pair;
+  char host_if[16];
+  char netns[32];
+  uint32_t next;         /* Name hash chain */
+} mock_if_t;
+
+typedef struct {
+  char *p;
+  size_t len;
+  size_t cap;
+} mock_out_t;
+
+typedef struct {
+  int argc;
+  char *argv[MOCK_MAX_ARGS];
+  const char *rest[MOCK_MAX_ARGS]; /* Original text from argv[i] on */
+  char buf[MOCK_LINE_MAX];
+} mock_cmd_t;
+
+/* Result of a command */
+#define MOCK_OK 0
+#define MOCK_ERR -1
+#define MOCK_QUIT 1
+
+typedef int (*mock_handler_t)(const char *verb, mock_cmd_t *c, int argi,
+                              mock_out_t *o, int depth);
+
+typedef struct {
+  int fd;
+  char *in;
+  size_t len;
+  size_t cap;
+} mock_client_t;
+
+typedef struct {
+  char text[128];
+  uint32_t usec;
+} mock_rule_t;
+
+static mock_if_t *g_ifs;
+static uint32_t g_nifs; /* High water mark */
+static uint32_t g_cap;
+static uint32_t *g_free; /* Freed sw_if_index, reused last in first out */
+static uint32_t g_nfree;
+static uint32_t g_hash[MOCK_HASH_SIZE];
+static uint32_t *g_hw; /* hw_if_index -> sw_if_index */
+static uint32_t g_next_hw;
+static uint32_t g_hw_cap;
+static uint32_t g_next_lcp;
+static char g_lcp_netns[32];
+
+static uint32_t *g_sorted; /* Present interfaces by name */
+static uint32_t g_nsorted;
+static bool g_sorted_ok;
+
+static uint32_t g_delay_usec;
+static mock_rule_t g_delays[MOCK_MAX_RULES];
+static int g_ndelays;
+static mock_rule_t g_fails[MOCK_MAX_RULES];
+static int g_nfails;
+static uint64_t g_commands;
+static FILE *g_log; /* -L: every command run, one per line */
+
+static volatile sig_atomic_t g_stop;
+
+static void die(const char *what) {
+  fprintf(stderr, "[vpp-mock] %s: %s\n", what, strerror(errno));
+  exit(1);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Output */
+
+static void out_vprintf(mock_out_t *o, const char *fmt, va_list ap) {
+  va_list aq;
+  int n;
+
+  va_copy(aq, ap);
+  n = vsnprintf(o->p ? o->p + o->len : NULL, o->p ? o->cap - o->len : 0, fmt,
+                aq);
+  va_end(aq);
+  if (n < 0)
+    return;
+  if (!o->p || o->len + (size_t)n + 1 > o->cap) {
+    size_t cap = o->cap ? o->cap : 4096;
+    while (cap < o->len + (size_t)n + 1)
+      cap *= 2;
+    if (!(o->p = realloc(o->p, cap)))
+      die("realloc");
+    o->cap = cap;
+    vsnprintf(o->p + o->len, o->cap - o->len, fmt, ap);
+  }
+  o->len += (size_t)n;
+}
+
+static void out_printf(mock_out_t *o, const char *fmt, ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  out_vprintf(o, fmt, ap);
+  va_end(ap);
+}
+
+/* Formatted line, CRLF terminated */
+static void out_line(mock_out_t *o, const char *fmt, ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  out_vprintf(o, fmt, ap);
+  va_end(ap);
+  out_printf(o, "\r\n");
+}
+
+static int out_error(mock_out_t *o, const char *verb, const char *fmt, ...) {
+  va_list ap;
+
+  out_printf(o, "%s: error: ", verb);
+  va_start(ap, fmt);
+  out_vprintf(o, fmt, ap);
+  va_end(ap);
+  out_printf(o, "\r\n");
+  return MOCK_ERR;
+}
+
+static int out_unknown(mock_out_t *o, const char *verb, const char *input) {
+  out_line(o, "%s: unknown input `%s'", verb, input);
+  return MOCK_ERR;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Interface table */
+
+static uint32_t name_hash(const char *name) {
+  uint32_t h = 2166136261u; /* FNV-1a */
+
+  for (; *name; name++) {
+    h ^= (uint8_t)*name;
+    h *= 16777619u;
+  }
+  return h & (MOCK_HASH_SIZE - 1);
+}
+
+static uint32_t if_find(const char *name) {
+  for (uint32_t i = g_hash[name_hash(name)]; i != MOCK_NONE; i = g_ifs[i].next)
+    if (strcmp(g_ifs[i].name, name) == 0)
+      return i;
+  return MOCK_NONE;
+}
+
+static void if_mac(mock_if_t *ifp) {
+  uint32_t hw = ifp->hw_if_index;
+
+  ifp->mac[0] = 0x02;
+  ifp->mac[1] = 0xfe;
+  ifp->mac[2] = (uint8_t)(hw >> 24);
+  ifp->mac[3] = (uint8_t)(hw >> 16);
+  ifp->mac[4] = (uint8_t)(hw >> 8);
+  ifp->mac[5] = (uint8_t)hw;
+}
+
+static uint32_t if_add(if_kind_t kind, const char *name) {
+  uint32_t idx;
+  uint32_t h;
+  mock_if_t *ifp;
+
+  if (g_nfree > 0) {
+    idx = g_free[--g_nfree];
+  } else {
+    if (g_nifs == g_cap) {
+      g_cap = g_cap ? g_cap * 2 : 1024;
+      if (!(g_ifs = realloc(g_ifs, g_cap * sizeof(*g_ifs))) ||
+          !(g_free = realloc(g_free, g_cap * sizeof(*g_free))))
+        die("realloc");
+    }
+    idx = g_nifs++;
+  }
+
+  ifp = &g_ifs[idx];
+  memset(ifp, 0, sizeof(*ifp));
+  ifp->present = true;
+  ifp->kind = kind;
+  snprintf(ifp->name, sizeof(ifp->name), "%s", name);
+  ifp->sup = idx;
+  ifp->bond = MOCK_NONE;
+  ifp->lcp_tap = MOCK_NONE;
+  ifp->mtu = 9000;
+  ifp->hw_if_index = MOCK_NONE;
+  if (kind != IF_SUB) {
+    if (g_next_hw == g_hw_cap) {
+      g_hw_cap = g_hw_cap ? g_hw_cap * 2 : 1024;
+      if (!(g_hw = realloc(g_hw, g_hw_cap * sizeof(*g_hw))))
+        die("realloc");
+    }
+    ifp->hw_if_index = g_next_hw++;
+    g_hw[ifp->hw_if_index] = idx;
+    if_mac(ifp);
+  }
+
+  h = name_hash(ifp->name);
+  ifp->next = g_hash[h];
+  g_hash[h] = idx;
+  g_sorted_ok = false;
+  return idx;
+}
+
+static void if_del(uint32_t idx) {
+  mock_if_t *ifp = &g_ifs[idx];
+  uint32_t *pp = &g_hash[name_hash(ifp->name)];
+
+  while (*pp != idx)
+    pp = &g_ifs[*pp].next;
+  *pp = ifp->next;
+
+  if (ifp->hw_if_index != MOCK_NONE)
+    g_hw[ifp->hw_if_index] = MOCK_NONE;
+  free(ifp->addr);
+  ifp->addr = NULL;
+  ifp->present = false;
+  g_free[g_nfree++] = idx;
+  g_sorted_ok = false;
+}
+
+static int sorted_cmp(const void *a, const void *b) {
+  return strcmp(g_ifs[*(const uint32_t *)a].name,
+                g_ifs[*(const uint32_t *)b].name);
+}
+
+/* Present interfaces sorted by name, as "show interface" lists them */
+static const uint32_t *if_sorted(uint32_t *n) {
+  if (!g_sorted_ok) {
+    if (!(g_sorted = realloc(g_sorted, (g_cap ? g_cap : 1) * sizeof(*g_sorted))))
+      die("realloc");
+    g_nsorted = 0;
+    for (uint32_t i = 0; i < g_nifs; i++)
+      if (g_ifs[i].present)
+        g_sorted[g_nsorted++] = i;
+    qsort(g_sorted, g_nsorted, sizeof(*g_sorted), sorted_cmp);
+    g_sorted_ok = true;
+  }
+  *n = g_nsorted;
+  return g_sorted;
+}
+
+static int if_addr_find(const mock_if_t *ifp, const char *addr) {
+  for (uint32_t i = 0; i < ifp->naddr; i++)
+    if (strcmp(ifp->addr[i], addr) == 0)
+      return (int)i;
+  return -1;
+}
+
+static void if_addr_add(mock_if_t *ifp, const char *addr) {
+  if (!(ifp->addr = realloc(ifp->addr, (ifp->naddr + 1) * sizeof(*ifp->addr))))
+    die("realloc");
+  snprintf(ifp->addr[ifp->naddr++], sizeof(ifp->addr[0]), "%s", addr);
+}
+
+/* Members of a bond; active ones only if active */
+static uint32_t bond_members(uint32_t bond, bool active) {
+  uint32_t n = 0;
+
+  for (uint32_t i = 0; i < g_nifs; i++)
+    if (g_ifs[i].present && g_ifs[i].bond == bond &&
+        (!active || g_ifs[i].admin_up))
+      n++;
+  return n;
+}
+
+static bool if_has_subs(uint32_t idx) {
+  for (uint32_t i = 0; i < g_nifs; i++)
+    if (g_ifs[i].present && g_ifs[i].kind == IF_SUB && g_ifs[i].sup == idx)
+      return true;
+  return false;
+}
+
+/* Largest MTU among the sub-interfaces of idx, 0 without any */
+static uint32_t if_subs_mtu(uint32_t idx, uint32_t *sub) {
+  uint32_t mtu = 0;
+
+  for (uint32_t i = 0; i < g_nifs; i++)
+    if (g_ifs[i].present && g_ifs[i].kind == IF_SUB && g_ifs[i].sup == idx &&
+        g_ifs[i].mtu > mtu) {
+      mtu = g_ifs[i].mtu;
+      *sub = i;
+    }
+  return mtu;
+}
+
+static void lcp_remove(mock_if_t *ifp) {
+  if (ifp->lcp_tap == MOCK_NONE)
+    return;
+  if_del(ifp->lcp_tap);
+  ifp->lcp_tap = MOCK_NONE;
+  ifp->host_if[0] = '\0';
+  ifp->netns[0] = '\0';
+}
+
+/* Remove an interface with its LCP pair and bond memberships */
+static void if_remove(uint32_t idx) {
+  lcp_remove(&g_ifs[idx]);
+  if (g_ifs[idx].kind == IF_BOND)
+    for (uint32_t i = 0; i < g_nifs; i++)
+      if (g_ifs[i].present && g_ifs[i].bond == idx)
+        g_ifs[i].bond = MOCK_NONE;
+  if_del(idx);
+}
+
+static uint32_t free_instance(if_kind_t kind) {
+  uint32_t inst = 0;
+  bool used;
+
+  do {
+    used = false;
+    for (uint32_t i = 0; i < g_nifs && !used; i++)
+      used = g_ifs[i].present && g_ifs[i].kind == kind &&
+             g_ifs[i].instance == inst;
+    if (used)
+      inst++;
+  } while (used);
+  return inst;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Show commands */
+
+static const char *mac_str(const uint8_t *mac, char *buf, size_t len) {
+  snprintf(buf, len, "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2],
+           mac[3], mac[4], mac[5]);
+  return buf;
+}
+
+/* Skip "brief", "verbose" and friends */
+static bool arg_is_flag(const char *arg) {
+  return strcmp(arg, "brief") == 0 || strcmp(arg, "verbose") == 0 ||
+         strcmp(arg, "detail") == 0;
+}
+
+/* Optional interface name argument: *idx is MOCK_NONE for all */
+static int arg_ifname(const char *verb, mock_cmd_t *c, int argi, uint32_t *idx,
+                      mock_out_t *o) {
+  *idx = MOCK_NONE;
+  for (int i = argi; i < c->argc; i++) {
+    if (arg_is_flag(c->argv[i]))
+      continue;
+    if (*idx != MOCK_NONE || (*idx = if_find(c->argv[i])) == MOCK_NONE)
+      return out_unknown(o, verb, c->rest[i]);
+  }
+  return MOCK_OK;
+}
+
+static void show_interface_line(mock_out_t *o, const mock_if_t *ifp,
+                                uint32_t idx) {
+  out_line(o, "%-32s %6u %8s %12u/0/0/0", ifp->name, idx,
+           ifp->admin_up ? "up" : "down", ifp->mtu);
+}
+
+static int cmd_show_interface_addr(const char *verb, mock_cmd_t *c, int argi,
+                                   mock_out_t *o, int depth);
+
+static int cmd_show_interface(const char *verb, mock_cmd_t *c, int argi,
+                              mock_out_t *o, int depth) {
+  const uint32_t *sorted;
+  uint32_t n;
+  uint32_t idx;
+
+  /* "show interface NAME addr" */
+  if (c->argc > argi + 1 && strcmp(c->argv[c->argc - 1], "addr") == 0) {
+    c->argc--;
+    return cmd_show_interface_addr(verb, c, argi, o, depth);
+  }
+  if (arg_ifname(verb, c, argi, &idx, o) < 0)
+    return MOCK_ERR;
+  out_line(o, "              Name               Idx    State  MTU "
+              "(L3/IP4/IP6/MPLS)     Counter          Count     ");
+  if (idx != MOCK_NONE) {
+    show_interface_line(o, &g_ifs[idx], idx);
+    return MOCK_OK;
+  }
+  sorted = if_sorted(&n);
+  for (uint32_t i = 0; i < n; i++)
+    show_interface_line(o, &g_ifs[sorted[i]], sorted[i]);
+  return MOCK_OK;
+}
+
+static void show_addr_block(mock_out_t *o, const mock_if_t *ifp) {
+  out_line(o, "%s (%s):", ifp->name, ifp->admin_up ? "up" : "dn");
+  for (uint32_t a = 0; a < ifp->naddr; a++)
+    out_line(o, "  L3 %s", ifp->addr[a]);
+}
+
+static int cmd_show_interface_addr(const char *verb, mock_cmd_t *c, int argi,
+                                   mock_out_t *o, int depth) {
+  const uint32_t *sorted;
+  uint32_t n;
+  uint32_t idx;
+
+  (void)depth;
+  if (arg_ifname(verb, c, argi, &idx, o) < 0)
+    return MOCK_ERR;
+  if (idx != MOCK_NONE) {
+    show_addr_block(o, &g_ifs[idx]);
+    return MOCK_OK;
+  }
+  sorted = if_sorted(&n);
+  for (uint32_t i = 0; i < n; i++)
+    show_addr_block(o, &g_ifs[sorted[i]]);
+  return MOCK_OK;
+}
+
+static void show_hw_block(mock_out_t *o, const mock_if_t *ifp) {
+  char mac[32];
+  bool link = ifp->admin_up && ifp->kind != IF_LOCAL;
+
+  out_line(o, "%-32s %5u %6s  %s", ifp->name, ifp->hw_if_index,
+           link ? "up" : "down", ifp->name);
+  switch (ifp->kind) {
+  case IF_LOCAL:
+    out_line(o, "  Link speed: unknown");
+    out_line(o, "  local");
+    return;
+  case IF_ETHERNET:
+    out_line(o, "  Link speed: 10 Gbps");
+    out_line(o, "  RX Queues:");
+    out_line(o, "    queue thread         mode");
+    out_line(o, "    0     main (0)       polling");
+    out_line(o, "  Ethernet address %s", mac_str(ifp->mac, mac, sizeof(mac)));
+    out_line(o, "  Intel 82599");
+    out_line(o, "    carrier %s full duplex max-frame-size 9022",
+             link ? "up" : "down");
+    return;
+  case IF_BOND:
+    out_line(o, "  Link speed: unknown");
+    out_line(o, "  Ethernet address %s", mac_str(ifp->mac, mac, sizeof(mac)));
+    out_line(o, "  bond");
+    return;
+  case IF_LOOPBACK:
+    out_line(o, "  Link speed: unknown");
+    out_line(o, "  Ethernet address %s", mac_str(ifp->mac, mac, sizeof(mac)));
+    out_line(o, "  Loopback");
+    return;
+  case IF_TAP:
+    out_line(o, "  Link speed: unknown");
+    out_line(o, "  Ethernet address %s", mac_str(ifp->mac, mac, sizeof(mac)));
+    out_line(o, "  VIRTIO tap");
+    return;
+  case IF_SUB:
+    return;
+  }
+}
+
+static int cmd_show_hardware(const char *verb, mock_cmd_t *c, int argi,
+                             mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (arg_ifname(verb, c, argi, &idx, o) < 0)
+    return MOCK_ERR;
+  if (idx != MOCK_NONE && g_ifs[idx].kind == IF_SUB)
+    return out_unknown(o, verb, c->rest[argi]);
+  out_line(o, "              Name                Idx   Link  Hardware");
+  if (idx != MOCK_NONE) {
+    show_hw_block(o, &g_ifs[idx]);
+    return MOCK_OK;
+  }
+  /* Hardware interfaces come in hw_if_index order */
+  for (uint32_t hw = 0; hw < g_next_hw; hw++)
+    if (g_hw[hw] != MOCK_NONE)
+      show_hw_block(o, &g_ifs[g_hw[hw]]);
+  return MOCK_OK;
+}
+
+static int cmd_show_bond(const char *verb, mock_cmd_t *c, int argi,
+                         mock_out_t *o, int depth) {
+  (void)depth;
+  if (argi < c->argc)
+    return out_unknown(o, verb, c->rest[argi]);
+  out_line(o, "%-16s %-12s %-12s %-13s %-15s %s", "interface name",
+           "sw_if_index", "mode", "load balance", "active members",
+           "members");
+  for (uint32_t i = 0; i < g_nifs; i++) {
+    const mock_if_t *b = &g_ifs[i];
+    if (b->present && b->kind == IF_BOND)
+      out_line(o, "%-16s %-12u %-12s %-13s %-15u %u", b->name, i, b->mode,
+               b->lb, bond_members(i, true), bond_members(i, false));
+  }
+  return MOCK_OK;
+}
+
+static void show_bond_block(mock_out_t *o, uint32_t bond) {
+  const mock_if_t *b = &g_ifs[bond];
+
+  out_line(o, "%s", b->name);
+  out_line(o, "  mode: %s", b->mode);
+  out_line(o, "  load balance: %s", b->lb);
+  out_line(o, "  number of active members: %u", bond_members(bond, true));
+  for (uint32_t i = 0; i < g_nifs; i++)
+    if (g_ifs[i].present && g_ifs[i].bond == bond && g_ifs[i].admin_up)
+      out_line(o, "    %s", g_ifs[i].name);
+  out_line(o, "  number of members: %u", bond_members(bond, false));
+  for (uint32_t i = 0; i < g_nifs; i++)
+    if (g_ifs[i].present && g_ifs[i].bond == bond)
+      out_line(o, "    %s", g_ifs[i].name);
+  out_line(o, "  device instance: %u", b->instance);
+  out_line(o, "  interface id: %u", b->instance);
+  out_line(o, "  sw_if_index: %u", bond);
+  out_line(o, "  hw_if_index: %u", b->hw_if_index);
+}
+
+static int cmd_show_bond_details(const char *verb, mock_cmd_t *c, int argi,
+                                 mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (arg_ifname(verb, c, argi, &idx, o) < 0)
+    return MOCK_ERR;
+  if (idx != MOCK_NONE) {
+    if (g_ifs[idx].kind != IF_BOND)
+      return out_unknown(o, verb, c->rest[argi]);
+    show_bond_block(o, idx);
+    return MOCK_OK;
+  }
+  for (uint32_t i = 0; i < g_nifs; i++)
+    if (g_ifs[i].present && g_ifs[i].kind == IF_BOND)
+      show_bond_block(o, i);
+  return MOCK_OK;
+}
+
+static int cmd_show_lcp(const char *verb, mock_cmd_t *c, int argi,
+                        mock_out_t *o, int depth) {
+  (void)depth;
+  if (argi < c->argc)
+    return out_unknown(o, verb, c->rest[argi]);
+  out_line(o, "lcp default netns '%s'", g_lcp_netns[0] ? g_lcp_netns : "<unset>");
+  out_line(o, "lcp lcp-auto-subint off");
+  out_line(o, "lcp lcp-sync off");
+  for (uint32_t i = 0; i < g_nifs; i++) {
+    const mock_if_t *ifp = &g_ifs[i];
+    if (!ifp->present || ifp->lcp_tap == MOCK_NONE)
+      continue;
+    if (ifp->netns[0])
+      out_line(o, "itf-pair: [%u] %s %s %s %u type tap netns %s", ifp->lcp_pair,
+               ifp->name, g_ifs[ifp->lcp_tap].name, ifp->host_if, ifp->lcp_tap,
+               ifp->netns);
+    else
+      out_line(o, "itf-pair: [%u] %s %s %s %u type tap", ifp->lcp_pair,
+               ifp->name, g_ifs[ifp->lcp_tap].name, ifp->host_if,
+               ifp->lcp_tap);
+  }
+  return MOCK_OK;
+}
+
+static int cmd_show_version(const char *verb, mock_cmd_t *c, int argi,
+                            mock_out_t *o, int depth) {
+  (void)depth;
+  if (argi < c->argc && strcmp(c->argv[argi], "verbose") == 0) {
+    out_line(o, "%-25s%s", "Version:", "v25.06-mock");
+    out_line(o, "%-25s%s", "Compiled by:", "clixon-vpp");
+    out_line(o, "%-25s%s", "Compile host:", "localhost");
+    out_line(o, "%-25s%d", "Current PID:", (int)getpid());
+    return MOCK_OK;
+  }
+  if (argi < c->argc)
+    return out_unknown(o, verb, c->rest[argi]);
+  out_line(o, "vpp v25.06-mock built by clixon-vpp on localhost");
+  return MOCK_OK;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Create and delete */
+
+static bool parse_u32(const char *s, uint32_t *v) {
+  char *end;
+  unsigned long n;
+
+  if (!s || !*s)
+    return false;
+  errno = 0;
+  n = strtoul(s, &end, 10);
+  if (*end != '\0' || errno != 0 || n > UINT32_MAX)
+    return false;
+  *v = (uint32_t)n;
+  return true;
+}
+
+static bool parse_mac(const char *s, uint8_t *mac) {
+  return sscanf(s, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &mac[0], &mac[1], &mac[2],
+                &mac[3], &mac[4], &mac[5]) == 6;
+}
+
+static uint32_t bond_create(const char *mode, const char *lb, uint32_t id) {
+  char name[64];
+  uint32_t idx;
+
+  snprintf(name, sizeof(name), "BondEthernet%u", id);
+  idx = if_add(IF_BOND, name);
+  g_ifs[idx].instance = id;
+  snprintf(g_ifs[idx].mode, sizeof(g_ifs[idx].mode), "%s", mode);
+  snprintf(g_ifs[idx].lb, sizeof(g_ifs[idx].lb), "%s", lb);
+  return idx;
+}
+
+static int cmd_create_bond(const char *verb, mock_cmd_t *c, int argi,
+                           mock_out_t *o, int depth) {
+  static const char *modes[] = {"round-robin", "active-backup", "xor",
+                                "broadcast", "lacp"};
+  static const char *lbs[] = {"l2", "l34", "l23", "rr", "bc", "ab"};
+  const char *mode = NULL;
+  const char *lb = "l2";
+  uint32_t id = MOCK_NONE;
+  uint8_t mac[6];
+  bool have_mac = false;
+  uint32_t idx;
+  char name[64];
+
+  (void)depth;
+  for (int i = argi; i < c->argc; i++) {
+    const char *kw = c->argv[i];
+    const char *val = i + 1 < c->argc ? c->argv[i + 1] : NULL;
+    bool ok = false;
+
+    if (strcmp(kw, "numa-only") == 0 || strcmp(kw, "gso") == 0)
+      continue;
+    if (val && strcmp(kw, "mode") == 0) {
+      for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]) && !ok; m++)
+        if (strcmp(val, modes[m]) == 0)
+          mode = modes[m], ok = true;
+    } else if (val && strcmp(kw, "load-balance") == 0) {
+      for (size_t m = 0; m < sizeof(lbs) / sizeof(lbs[0]) && !ok; m++)
+        if (strcmp(val, lbs[m]) == 0)
+          lb = lbs[m], ok = true;
+    } else if (val && strcmp(kw, "hw-addr") == 0) {
+      ok = have_mac = parse_mac(val, mac);
+    } else if (val && strcmp(kw, "id") == 0) {
+      ok = parse_u32(val, &id);
+    }
+    if (!ok)
+      return out_unknown(o, verb, c->rest[i]);
+    i++;
+  }
+  if (!mode)
+    return out_error(o, verb, "Missing bond mode");
+  if (id == MOCK_NONE)
+    id = free_instance(IF_BOND);
+  snprintf(name, sizeof(name), "BondEthernet%u", id);
+  if (if_find(name) != MOCK_NONE)
+    return out_error(o, verb, "interface %s already exists", name);
+
+  idx = bond_create(mode, lb, id);
+  if (have_mac)
+    memcpy(g_ifs[idx].mac, mac, sizeof(mac));
+  out_line(o, "%s", g_ifs[idx].name);
+  return MOCK_OK;
+}
+
+static int cmd_delete_bond(const char *verb, mock_cmd_t *c, int argi,
+                           mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (argi < c->argc && strcmp(c->argv[argi], "interface") == 0)
+    argi++;
+  if (argi + 1 != c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE ||
+      g_ifs[idx].kind != IF_BOND)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  if (if_has_subs(idx))
+    return out_error(o, verb, "%s has sub-interfaces", g_ifs[idx].name);
+  if_remove(idx);
+  return MOCK_OK;
+}
+
+static int cmd_bond_add(const char *verb, mock_cmd_t *c, int argi,
+                        mock_out_t *o, int depth) {
+  uint32_t bond;
+  uint32_t member;
+
+  (void)depth;
+  if (argi + 2 > c->argc ||
+      (bond = if_find(c->argv[argi])) == MOCK_NONE ||
+      g_ifs[bond].kind != IF_BOND ||
+      (member = if_find(c->argv[argi + 1])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  for (int i = argi + 2; i < c->argc; i++)
+    if (strcmp(c->argv[i], "passive") != 0 &&
+        strcmp(c->argv[i], "long-timeout") != 0)
+      return out_unknown(o, verb, c->rest[i]);
+  if (g_ifs[member].kind != IF_ETHERNET)
+    return out_error(o, verb, "%s cannot be a bond member",
+                     g_ifs[member].name);
+  if (g_ifs[member].bond != MOCK_NONE)
+    return out_error(o, verb, "%s is already a member of %s",
+                     g_ifs[member].name, g_ifs[g_ifs[member].bond].name);
+  g_ifs[member].bond = bond;
+  return MOCK_OK;
+}
+
+static int cmd_bond_del(const char *verb, mock_cmd_t *c, int argi,
+                        mock_out_t *o, int depth) {
+  uint32_t member;
+
+  (void)depth;
+  if (argi + 1 != c->argc ||
+      (member = if_find(c->argv[argi])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  if (g_ifs[member].bond == MOCK_NONE)
+    return out_error(o, verb, "%s is not a bond member", g_ifs[member].name);
+  g_ifs[member].bond = MOCK_NONE;
+  return MOCK_OK;
+}
+
+static uint32_t subif_create(uint32_t parent, uint32_t id, uint32_t vlan) {
+  char name[80];
+  uint32_t idx;
+
+  snprintf(name, sizeof(name), "%s.%u", g_ifs[parent].name, id);
+  idx = if_add(IF_SUB, name);
+  g_ifs[idx].sup = parent;
+  g_ifs[idx].sub_id = id;
+  g_ifs[idx].vlan = vlan;
+  g_ifs[idx].mtu = g_ifs[parent].mtu;
+  return idx;
+}
+
+static int cmd_create_subif(const char *verb, mock_cmd_t *c, int argi,
+                            mock_out_t *o, int depth) {
+  uint32_t parent;
+  uint32_t id;
+  uint32_t vlan;
+  uint32_t idx;
+  char name[80];
+
+  (void)depth;
+  if (argi + 2 > c->argc || (parent = if_find(c->argv[argi])) == MOCK_NONE ||
+      !parse_u32(c->argv[argi + 1], &id))
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  vlan = id;
+  if (argi + 2 < c->argc) {
+    if (strcmp(c->argv[argi + 2], "dot1q") != 0 || argi + 3 >= c->argc ||
+        !parse_u32(c->argv[argi + 3], &vlan) ||
+        (argi + 4 < c->argc && (strcmp(c->argv[argi + 4], "exact-match") != 0 ||
+                                argi + 5 < c->argc)))
+      return out_unknown(o, verb, c->rest[argi + 2]);
+  }
+  if (g_ifs[parent].kind == IF_SUB)
+    return out_error(o, verb, "%s is a sub-interface", g_ifs[parent].name);
+  if (vlan == 0 || vlan > 4094)
+    return out_error(o, verb, "vlan %u out of range", vlan);
+  snprintf(name, sizeof(name), "%s.%u", g_ifs[parent].name, id);
+  if (if_find(name) != MOCK_NONE)
+    return out_error(o, verb, "vlan is already in use");
+  idx = subif_create(parent, id, vlan);
+  out_line(o, "%s", g_ifs[idx].name);
+  return MOCK_OK;
+}
+
+static int cmd_delete_subif(const char *verb, mock_cmd_t *c, int argi,
+                            mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (argi + 1 != c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE ||
+      g_ifs[idx].kind != IF_SUB)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  if_remove(idx);
+  return MOCK_OK;
+}
+
+static int cmd_create_loopback(const char *verb, mock_cmd_t *c, int argi,
+                               mock_out_t *o, int depth) {
+  uint32_t inst = MOCK_NONE;
+  uint8_t mac[6];
+  bool have_mac = false;
+  char name[32];
+  uint32_t idx;
+
+  (void)depth;
+  for (int i = argi; i < c->argc; i += 2) {
+    if (i + 1 < c->argc && strcmp(c->argv[i], "mac") == 0 &&
+        parse_mac(c->argv[i + 1], mac))
+      have_mac = true;
+    else if (!(i + 1 < c->argc && strcmp(c->argv[i], "instance") == 0 &&
+               parse_u32(c->argv[i + 1], &inst)))
+      return out_unknown(o, verb, c->rest[i]);
+  }
+  if (inst == MOCK_NONE)
+    inst = free_instance(IF_LOOPBACK);
+  snprintf(name, sizeof(name), "loop%u", inst);
+  if (if_find(name) != MOCK_NONE)
+    return out_error(o, verb, "instance %u is in use", inst);
+  idx = if_add(IF_LOOPBACK, name);
+  g_ifs[idx].instance = inst;
+  if (have_mac)
+    memcpy(g_ifs[idx].mac, mac, sizeof(mac));
+  out_line(o, "%s", name);
+  return MOCK_OK;
+}
+
+static int cmd_delete_loopback(const char *verb, mock_cmd_t *c, int argi,
+                               mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (argi + 2 != c->argc || strcmp(c->argv[argi], "intfc") != 0 ||
+      (idx = if_find(c->argv[argi + 1])) == MOCK_NONE ||
+      g_ifs[idx].kind != IF_LOOPBACK)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  if (if_has_subs(idx))
+    return out_error(o, verb, "%s has sub-interfaces", g_ifs[idx].name);
+  if_remove(idx);
+  return MOCK_OK;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Set commands */
+
+static int cmd_set_state(const char *verb, mock_cmd_t *c, int argi,
+                         mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (argi + 2 != c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE ||
+      (strcmp(c->argv[argi + 1], "up") != 0 &&
+       strcmp(c->argv[argi + 1], "down") != 0))
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  g_ifs[idx].admin_up = strcmp(c->argv[argi + 1], "up") == 0;
+  return MOCK_OK;
+}
+
+static int cmd_set_mtu(const char *verb, mock_cmd_t *c, int argi,
+                       mock_out_t *o, int depth) {
+  uint32_t mtu;
+  uint32_t idx;
+  uint32_t sub = MOCK_NONE;
+  mock_if_t *ifp;
+
+  (void)depth;
+  if (argi < c->argc &&
+      (strcmp(c->argv[argi], "packet") == 0 || strcmp(c->argv[argi], "ip4") == 0 ||
+       strcmp(c->argv[argi], "ip6") == 0 || strcmp(c->argv[argi], "mpls") == 0))
+    argi++;
+  if (argi + 2 != c->argc || !parse_u32(c->argv[argi], &mtu) ||
+      (idx = if_find(c->argv[argi + 1])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  ifp = &g_ifs[idx];
+  if (mtu < 64 || mtu > 9216)
+    return out_error(o, verb, "MTU %u out of range (64-9216)", mtu);
+  if (ifp->kind == IF_SUB && mtu > g_ifs[ifp->sup].mtu)
+    return out_error(o, verb, "MTU %u exceeds %s MTU %u", mtu,
+                     g_ifs[ifp->sup].name, g_ifs[ifp->sup].mtu);
+  if (ifp->kind != IF_SUB && mtu < if_subs_mtu(idx, &sub))
+    return out_error(o, verb, "MTU %u below %s MTU %u", mtu, g_ifs[sub].name,
+                     g_ifs[sub].mtu);
+  ifp->mtu = mtu;
+  return MOCK_OK;
+}
+
+static int cmd_set_address(const char *verb, mock_cmd_t *c, int argi,
+                           mock_out_t *o, int depth) {
+  bool del = false;
+  const char *addr;
+  uint32_t idx;
+  mock_if_t *ifp;
+  int a;
+
+  (void)depth;
+  /* "del NAME ADDR|all" or "NAME ADDR [del]" */
+  if (argi < c->argc && strcmp(c->argv[argi], "del") == 0) {
+    del = true;
+    argi++;
+  } else if (c->argc == argi + 3 && strcmp(c->argv[argi + 2], "del") == 0) {
+    del = true;
+  } else if (c->argc != argi + 2) {
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  }
+  if (argi + 1 >= c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  ifp = &g_ifs[idx];
+  addr = c->argv[argi + 1];
+
+  if (del && strcmp(addr, "all") == 0) {
+    ifp->naddr = 0;
+    return MOCK_OK;
+  }
+  if (!strchr(addr, '/'))
+    return out_unknown(o, verb, c->rest[argi + 1]);
+  a = if_addr_find(ifp, addr);
+  if (del) {
+    if (a < 0)
+      return out_error(o, verb, "address %s not found on %s", addr, ifp->name);
+    memmove(&ifp->addr[a], &ifp->addr[a + 1],
+            (ifp->naddr - (uint32_t)a - 1) * sizeof(ifp->addr[0]));
+    ifp->naddr--;
+    return MOCK_OK;
+  }
+  if (a >= 0)
+    return out_error(o, verb, "address %s already present on %s", addr,
+                     ifp->name);
+  if_addr_add(ifp, addr);
+  return MOCK_OK;
+}
+
+static int cmd_set_description(const char *verb, mock_cmd_t *c, int argi,
+                               mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (argi + 1 > c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  /* No text clears it */
+  snprintf(g_ifs[idx].description, sizeof(g_ifs[idx].description), "%s",
+           argi + 1 < c->argc ? c->rest[argi + 1] : "");
+  return MOCK_OK;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Linux control plane */
+
+static void lcp_create(uint32_t phy, const char *host_if, const char *netns) {
+  uint32_t pair = g_next_lcp++;
+  char name[32];
+  uint32_t tap;
+
+  snprintf(name, sizeof(name), "tap%u", MOCK_TAP_BASE + pair);
+  tap = if_add(IF_TAP, name);
+  g_ifs[tap].instance = MOCK_TAP_BASE + pair;
+  g_ifs[tap].admin_up = true;
+  g_ifs[tap].mtu = 1500;
+  g_ifs[phy].lcp_tap = tap;
+  g_ifs[phy].lcp_pair = pair;
+  snprintf(g_ifs[phy].host_if, sizeof(g_ifs[phy].host_if), "%s", host_if);
+  snprintf(g_ifs[phy].netns, sizeof(g_ifs[phy].netns), "%s", netns);
+}
+
+static int cmd_lcp_create(const char *verb, mock_cmd_t *c, int argi,
+                          mock_out_t *o, int depth) {
+  const char *host_if = NULL;
+  const char *netns = g_lcp_netns;
+  uint32_t idx;
+
+  (void)depth;
+  if (argi >= c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  for (int i = argi + 1; i < c->argc; i++) {
+    if (strcmp(c->argv[i], "tun") == 0 || strcmp(c->argv[i], "tap") == 0)
+      continue;
+    if (i + 1 < c->argc && strcmp(c->argv[i], "host-if") == 0)
+      host_if = c->argv[++i];
+    else if (i + 1 < c->argc && strcmp(c->argv[i], "netns") == 0)
+      netns = c->argv[++i];
+    else
+      return out_unknown(o, verb, c->rest[i]);
+  }
+  if (!host_if || strlen(host_if) >= sizeof(g_ifs[idx].host_if))
+    return out_error(o, verb, "missing or invalid host-if");
+  if (g_ifs[idx].kind == IF_TAP || g_ifs[idx].lcp_tap != MOCK_NONE)
+    return out_error(o, verb, "%s already has a pair", g_ifs[idx].name);
+  lcp_create(idx, host_if, netns);
+  out_line(o, "%s", g_ifs[g_ifs[idx].lcp_tap].name);
+  return MOCK_OK;
+}
+
+static int cmd_lcp_delete(const char *verb, mock_cmd_t *c, int argi,
+                          mock_out_t *o, int depth) {
+  uint32_t idx;
+
+  (void)depth;
+  if (argi + 1 != c->argc || (idx = if_find(c->argv[argi])) == MOCK_NONE)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  if (g_ifs[idx].lcp_tap == MOCK_NONE)
+    return out_error(o, verb, "%s has no pair", g_ifs[idx].name);
+  lcp_remove(&g_ifs[idx]);
+  return MOCK_OK;
+}
+
+static int cmd_lcp_default(const char *verb, mock_cmd_t *c, int argi,
+                           mock_out_t *o, int depth) {
+  (void)depth;
+  if (argi == c->argc) {
+    g_lcp_netns[0] = '\0';
+    return MOCK_OK;
+  }
+  if (argi + 2 != c->argc || strcmp(c->argv[argi], "netns") != 0)
+    return out_unknown(o, verb, c->rest[argi]);
+  snprintf(g_lcp_netns, sizeof(g_lcp_netns), "%s", c->argv[argi + 1]);
+  return MOCK_OK;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Session commands */
+
+static int cmd_set_terminal(const char *verb, mock_cmd_t *c, int argi,
+                            mock_out_t *o, int depth) {
+  (void)verb;
+  (void)c;
+  (void)argi;
+  (void)o;
+  (void)depth;
+  return MOCK_OK;
+}
+
+static int cmd_echo(const char *verb, mock_cmd_t *c, int argi, mock_out_t *o,
+                    int depth) {
+  (void)verb;
+  (void)depth;
+  out_line(o, "%s", argi < c->argc ? c->rest[argi] : "");
+  return MOCK_OK;
+}
+
+static int cmd_quit(const char *verb, mock_cmd_t *c, int argi, mock_out_t *o,
+                    int depth) {
+  (void)verb;
+  (void)c;
+  (void)argi;
+  (void)o;
+  (void)depth;
+  return MOCK_QUIT;
+}
+
+static int run_line(const char *line, mock_out_t *o, int depth);
+
+/* Run a script; like VPP, stop at the first failing command */
+static int cmd_exec(const char *verb, mock_cmd_t *c, int argi, mock_out_t *o,
+                    int depth) {
+  char line[MOCK_LINE_MAX];
+  FILE *fp;
+  int rv = MOCK_OK;
+
+  if (argi + 1 != c->argc)
+    return out_unknown(o, verb, argi < c->argc ? c->rest[argi] : "");
+  if (depth >= MOCK_EXEC_DEPTH)
+    return out_error(o, verb, "scripts nested too deep");
+  if (!(fp = fopen(c->argv[argi], "r")))
+    return out_error(o, verb, "failed to open `%s'", c->argv[argi]);
+  while (rv == MOCK_OK && fgets(line, sizeof(line), fp)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0' || line[0] == '#')
+      continue;
+    rv = run_line(line, o, depth + 1);
+  }
+  fclose(fp);
+  return rv == MOCK_QUIT ? MOCK_OK : rv;
+}
+
+/* Longer verbs first where one is a prefix of another */
+static const struct {
+  const char *verb;
+  mock_handler_t fn;
+} commands[] = {
+    {"show interface addr", cmd_show_interface_addr},
+    {"show interface", cmd_show_interface},
+    {"show hardware-interfaces", cmd_show_hardware},
+    {"show bond details", cmd_show_bond_details},
+    {"show bond", cmd_show_bond},
+    {"show lcp", cmd_show_lcp},
+    {"show version", cmd_show_version},
+    {"create bond", cmd_create_bond},
+    {"delete bond", cmd_delete_bond},
+    {"bond add", cmd_bond_add},
+    {"bond del", cmd_bond_del},
+    {"create sub-interfaces", cmd_create_subif},
+    {"delete sub-interfaces", cmd_delete_subif},
+    {"delete sub-interface", cmd_delete_subif},
+    {"create loopback interface", cmd_create_loopback},
+    {"delete loopback interface", cmd_delete_loopback},
+    {"set interface state", cmd_set_state},
+    {"set interface mtu", cmd_set_mtu},
+    {"set interface ip address", cmd_set_address},
+    {"set interface description", cmd_set_description},
+    {"lcp create", cmd_lcp_create},
+    {"lcp delete", cmd_lcp_delete},
+    {"lcp default", cmd_lcp_default},
+    {"set terminal", cmd_set_terminal},
+    {"echo", cmd_echo},
+    {"exec", cmd_exec},
+    {"quit", cmd_quit},
+};
+
+/* Split line into words, remembering where each starts in the original */
+static int cmd_parse(mock_cmd_t *c, const char *line) {
+  size_t len = strlen(line);
+  char *p;
+
+  if (len >= sizeof(c->buf))
+    return -1;
+  memcpy(c->buf, line, len + 1);
+  c->argc = 0;
+  p = c->buf;
+  for (;;) {
+    while (*p == ' ' || *p == '\t')
+      p++;
+    if (*p == '\0')
+      break;
+    if (c->argc == MOCK_MAX_ARGS)
+      return -1;
+    c->rest[c->argc] = line + (p - c->buf);
+    c->argv[c->argc++] = p;
+    p += strcspn(p, " \t");
+    if (*p)
+      *p++ = '\0';
+  }
+  return 0;
+}
+
+/* Number of leading words of c matching verb, 0 if not all match */
+static int cmd_match(const mock_cmd_t *c, const char *verb) {
+  int n = 0;
+
+  while (*verb) {
+    size_t wl = strcspn(verb, " ");
+    if (n >= c->argc || strlen(c->argv[n]) != wl ||
+        strncmp(c->argv[n], verb, wl) != 0)
+      return 0;
+    n++;
+    verb += wl;
+    verb += strspn(verb, " ");
+  }
+  return n;
+}
+
+static uint32_t cmd_delay(const char *line) {
+  size_t best = 0;
+  uint32_t usec = g_delay_usec;
+
+  for (int i = 0; i < g_ndelays; i++) {
+    size_t len = strlen(g_delays[i].text);
+    if (len > best && strncmp(line, g_delays[i].text, len) == 0) {
+      best = len;
+      usec = g_delays[i].usec;
+    }
+  }
+  return usec;
+}
+
+static void sleep_usec(uint32_t usec) {
+  struct timespec ts = {.tv_sec = usec / 1000000,
+                        .tv_nsec = (long)(usec % 1000000) * 1000};
+
+  while (nanosleep(&ts, &ts) < 0 && errno == EINTR && !g_stop)
+    ;
+}
+
+static int run_line(const char *line, mock_out_t *o, int depth) {
+  mock_cmd_t c;
+  uint32_t delay = cmd_delay(line);
+
+  g_commands++;
+  if (g_log)
+    fprintf(g_log, "%s\n", line);
+  if (delay > 0)
+    sleep_usec(delay);
+  if (cmd_parse(&c, line) < 0)
+    return out_error(o, "cli", "command line too long");
+  if (c.argc == 0)
+    return MOCK_OK;
+
+  for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+    int n = cmd_match(&c, commands[i].verb);
+    if (n == 0)
+      continue;
+    for (int f = 0; f < g_nfails; f++)
+      if (strstr(line, g_fails[f].text))
+        return out_error(o, commands[i].verb, "injected failure");
+    return commands[i].fn(commands[i].verb, &c, n, o, depth);
+  }
+  out_line(o, "unknown input `%s'", line);
+  return MOCK_ERR;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Synthetic configuration */
+
+typedef struct {
+  uint32_t ports;
+  uint32_t bonds;
+  uint32_t members;
+  uint32_t vlans;
+  bool addresses;
+  bool lcp;
+} mock_scale_t;
+
+static void populate(const mock_scale_t *s) {
+  uint32_t *parents;
+  uint32_t nparents;
+  uint32_t port0;
+  uint32_t next_member = 0;
+  char name[64];
+
+  for (uint32_t i = 0; i < MOCK_HASH_SIZE; i++)
+    g_hash[i] = MOCK_NONE;
+  if_add(IF_LOCAL, "local0");
+  g_ifs[0].mtu = 0;
+
+  port0 = g_nifs;
+  for (uint32_t p = 0; p < s->ports; p++) {
+    uint32_t port;
+
+    snprintf(name, sizeof(name), "TenGigabitEthernet%x/0/%u", p / 2, p % 2);
+    port = if_add(IF_ETHERNET, name); /* May move g_ifs */
+    g_ifs[port].admin_up = true;
+  }
+
+  nparents = s->bonds ? s->bonds : s->ports;
+  if (!(parents = calloc(nparents ? nparents : 1, sizeof(*parents))))
+    die("calloc");
+  for (uint32_t b = 0; b < s->bonds; b++) {
+    uint32_t bond = bond_create("lacp", "l34", b);
+
+    g_ifs[bond].admin_up = true;
+    for (uint32_t m = 0; m < s->members && next_member < s->ports; m++)
+      g_ifs[port0 + next_member++].bond = bond;
+    if (s->addresses && b < 256) {
+      snprintf(name, sizeof(name), "172.16.%u.1/24", b);
+      if_addr_add(&g_ifs[bond], name);
+    }
+    if (s->lcp) {
+      snprintf(name, sizeof(name), "be%u", b);
+      lcp_create(bond, name, "dataplane");
+    }
+    parents[b] = bond;
+  }
+  if (!s->bonds)
+    for (uint32_t p = 0; p < s->ports; p++)
+      parents[p] = port0 + p;
+
+  /* VLANs round-robin over the bonds, or the ports without bonds */
+  for (uint32_t v = 0; v < s->vlans && nparents > 0; v++) {
+    uint32_t parent = parents[v % nparents];
+    uint32_t vlan = 100 + v / nparents;
+    uint32_t sub;
+
+    if (vlan > 4094)
+      break;
+    sub = subif_create(parent, vlan, vlan);
+    g_ifs[sub].admin_up = true;
+    if (s->addresses) {
+      snprintf(name, sizeof(name), "10.%u.%u.1/24", (v >> 8) & 0xff, v & 0xff);
+      if_addr_add(&g_ifs[sub], name);
+    }
+    if (s->lcp) {
+      snprintf(name, sizeof(name), "%s%u.%u", s->bonds ? "be" : "eth",
+               v % nparents, vlan);
+      lcp_create(sub, name, "dataplane");
+    }
+  }
+  free(parents);
+}
+
+/* Show commands written by -R */
+static const char *record_cmds[] = {
+    "show interface",        "show interface addr", "show hardware-interfaces",
+    "show bond",             "show bond details",   "show lcp",
+};
+
+/*
+ * Write each show output to dir/<command, blanks as '_'> the way the
+ * client hands it to the parsers: LF line ends, no echo, no prompt.
+ */
+static int record(const char *dir) {
+  mock_out_t o = {0};
+
+  for (size_t i = 0; i < sizeof(record_cmds) / sizeof(record_cmds[0]); i++) {
+    char path[512];
+    size_t n = 0;
+    FILE *fp;
+    int pos;
+
+    pos = snprintf(path, sizeof(path), "%s/", dir);
+    for (const char *p = record_cmds[i]; *p && pos < (int)sizeof(path) - 1; p++)
+      path[pos++] = *p == ' ' ? '_' : *p;
+    path[pos] = '\0';
+
+    o.len = 0;
+    run_line(record_cmds[i], &o, 0);
+    for (size_t j = 0; j < o.len; j++)
+      if (o.p[j] != '\r')
+        o.p[n++] = o.p[j];
+    if (!(fp = fopen(path, "w")) || fwrite(o.p, 1, n, fp) != n ||
+        fclose(fp) != 0) {
+      fprintf(stderr, "[vpp-mock] Cannot write %s: %s\n", path, strerror(errno));
+      free(o.p);
+      return -1;
+    }
+  }
+  free(o.p);
+  return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Server */
+
+static int send_all(int fd, const char *p, size_t len) {
+  while (len > 0) {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+static void client_close(mock_client_t *cl) {
+  close(cl->fd);
+  free(cl->in);
+  memset(cl, 0, sizeof(*cl));
+  cl->fd = -1;
+}
+
+/* Run every complete line received; -1 once the client is gone */
+static int client_input(mock_client_t *cl, mock_out_t *o) {
+  char *line = cl->in;
+  char *end = cl->in + cl->len;
+  char *nl;
+  int rv = MOCK_OK;
+
+  while (rv != MOCK_QUIT && (nl = memchr(line, '\n', (size_t)(end - line)))) {
+    *nl = '\0';
+    if (nl > line && nl[-1] == '\r')
+      nl[-1] = '\0';
+
+    o->len = 0;
+    out_printf(o, "%s\r\n", line);
+    rv = run_line(line, o, 0);
+    if (rv != MOCK_QUIT)
+      out_printf(o, MOCK_PROMPT);
+    if (send_all(cl->fd, o->p, o->len) < 0)
+      return -1;
+    line = nl + 1;
+  }
+  cl->len = (size_t)(end - line);
+  memmove(cl->in, line, cl->len);
+  return rv == MOCK_QUIT ? -1 : 0;
+}
+
+static int client_read(mock_client_t *cl, mock_out_t *o) {
+  ssize_t n;
+
+  if (cl->cap - cl->len < 4096) {
+    cl->cap = cl->cap ? cl->cap * 2 : 8192;
+    if (!(cl->in = realloc(cl->in, cl->cap)))
+      die("realloc");
+  }
+  n = recv(cl->fd, cl->in + cl->len, cl->cap - cl->len, 0);
+  if (n < 0)
+    return errno == EINTR ? 0 : -1;
+  if (n == 0)
+    return -1;
+  cl->len += (size_t)n;
+  return client_input(cl, o);
+}
+
+static int listen_on(const char *path) {
+  struct sockaddr_un addr;
+  int fd;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "[vpp-mock] Socket path too long: %s\n", path);
+    exit(1);
+  }
+  strcpy(addr.sun_path, path);
+  unlink(path);
+
+  if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+    die("socket");
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    die(path);
+  if (listen(fd, MOCK_MAX_CLIENTS) < 0)
+    die("listen");
+  return fd;
+}
+
+static void on_signal(int sig) {
+  (void)sig;
+  g_stop = 1;
+}
+
+static int add_rule(mock_rule_t *rules, int *n, const char *arg, bool delay) {
+  const char *eq = delay ? strrchr(arg, '=') : NULL;
+  size_t len = eq ? (size_t)(eq - arg) : strlen(arg);
+
+  if (*n == MOCK_MAX_RULES || len == 0 || len >= sizeof(rules[0].text) ||
+      (delay && (!eq || !parse_u32(eq + 1, &rules[*n].usec))))
+    return -1;
+  memcpy(rules[*n].text, arg, len);
+  rules[*n].text[len] = '\0';
+  (*n)++;
+  return 0;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -s PATH        Listen on PATH (default " MOCK_SOCKET ")\n"
+          "  -p N           Ethernet ports (default 4)\n"
+          "  -b N           Bonds, each taking -m ports as members\n"
+          "  -m N           Members per bond (default 2)\n"
+          "  -v N           VLAN sub-interfaces, spread over the bonds\n"
+          "                 (or the ports if there are none)\n"
+          "  -a             Give every bond and VLAN an IPv4 address\n"
+          "  -c             Give every bond and VLAN an LCP pair\n"
+          "  -d USEC        Latency added to every command\n"
+          "  -D VERB=USEC   Latency of commands starting with VERB\n"
+          "  -F TEXT        Fail commands containing TEXT\n"
+          "  -L PATH        Append every command run, scripts' too, to PATH\n"
+          "  -R DIR         Record the show outputs to DIR and exit\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  const char *path = MOCK_SOCKET;
+  const char *record_dir = NULL;
+  mock_scale_t scale = {.ports = 4, .members = 2};
+  mock_client_t clients[MOCK_MAX_CLIENTS];
+  struct pollfd pfd[MOCK_MAX_CLIENTS + 1];
+  mock_out_t out = {0};
+  struct sigaction sa;
+  int lfd;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "s:p:b:m:v:acd:D:F:L:R:h")) != -1) {
+    bool ok = true;
+
+    switch (opt) {
+    case 's':
+      path = optarg;
+      break;
+    case 'p':
+      ok = parse_u32(optarg, &scale.ports);
+      break;
+    case 'b':
+      ok = parse_u32(optarg, &scale.bonds);
+      break;
+    case 'm':
+      ok = parse_u32(optarg, &scale.members);
+      break;
+    case 'v':
+      ok = parse_u32(optarg, &scale.vlans);
+      break;
+    case 'a':
+      scale.addresses = true;
+      break;
+    case 'c':
+      scale.lcp = true;
+      break;
+    case 'd':
+      ok = parse_u32(optarg, &g_delay_usec);
+      break;
+    case 'D':
+      ok = add_rule(g_delays, &g_ndelays, optarg, true) == 0;
+      break;
+    case 'F':
+      ok = add_rule(g_fails, &g_nfails, optarg, false) == 0;
+      break;
+    case 'L':
+      if (!(g_log = fopen(optarg, "a")))
+        die(optarg);
+      setvbuf(g_log, NULL, _IOLBF, 0);
+      break;
+    case 'R':
+      record_dir = optarg;
+      break;
+    default:
+      ok = false;
+      break;
+    }
+    if (!ok) {
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  populate(&scale);
+  if (record_dir)
+    return record(record_dir) < 0 ? 1 : 0;
+  lfd = listen_on(path);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = on_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  for (int i = 0; i < MOCK_MAX_CLIENTS; i++)
+    clients[i].fd = -1;
+  fprintf(stderr, "[vpp-mock] Listening on %s with %u interfaces\n", path,
+          g_nifs - g_nfree);
+
+  while (!g_stop) {
+    int n = 0;
+
+    pfd[n++] = (struct pollfd){.fd = lfd, .events = POLLIN};
+    for (int i = 0; i < MOCK_MAX_CLIENTS; i++)
+      pfd[n++] = (struct pollfd){.fd = clients[i].fd, .events = POLLIN};
+
+    if (poll(pfd, (nfds_t)n, -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      die("poll");
+    }
+
+    if (pfd[0].revents & POLLIN) {
+      int fd = accept4(lfd, NULL, NULL, SOCK_CLOEXEC);
+      int slot = -1;
+
+      for (int i = 0; i < MOCK_MAX_CLIENTS && slot < 0 && fd >= 0; i++)
+        if (clients[i].fd < 0)
+          slot = i;
+      if (slot < 0) {
+        if (fd >= 0)
+          close(fd);
+      } else {
+        memset(&clients[slot], 0, sizeof(clients[slot]));
+        clients[slot].fd = fd;
+        if (send_all(fd, "    vpp-mock\r\n\r\n" MOCK_PROMPT,
+                     strlen("    vpp-mock\r\n\r\n" MOCK_PROMPT)) < 0)
+          client_close(&clients[slot]);
+      }
+    }
+
+    for (int i = 0; i < MOCK_MAX_CLIENTS; i++) {
+      if (clients[i].fd < 0 || !pfd[i + 1].revents)
+        continue;
+      if (client_read(&clients[i], &out) < 0)
+        client_close(&clients[i]);
+    }
+  }
+
+  for (int i = 0; i < MOCK_MAX_CLIENTS; i++)
+    if (clients[i].fd >= 0)
+      client_close(&clients[i]);
+  close(lfd);
+  unlink(path);
+  fprintf(stderr, "[vpp-mock] %llu commands served\n",
+          (unsigned long long)g_commands);
+  return 0;
+}